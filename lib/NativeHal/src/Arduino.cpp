@@ -0,0 +1,431 @@
+#include "Arduino.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdarg>
+#include <random>
+#include <string>
+
+#include "esp_timer.h"
+#include "nativeHal.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+
+namespace
+{
+const std::chrono::steady_clock::time_point bootInstant = std::chrono::steady_clock::now();
+uint64_t virtualOffsetUs = 0;
+time_t epochAtStart = 0;
+bool epochInitialized = false;
+std::mt19937 randomEngine(12345);
+
+std::string formatNumber(const char *format, double value)
+{
+    char text[64];
+    snprintf(text, sizeof(text), format, value);
+    return text;
+}
+
+std::string formatInteger(unsigned long long magnitude, bool negative, unsigned char base)
+{
+    if (base < 2 || base > 36)
+    {
+        base = 10;
+    }
+    std::string digits;
+    do
+    {
+        const unsigned digit = static_cast<unsigned>(magnitude % base);
+        digits.insert(digits.begin(), static_cast<char>(digit < 10 ? '0' + digit : 'a' + digit - 10));
+        magnitude /= base;
+    } while (magnitude != 0);
+    if (negative)
+    {
+        digits.insert(digits.begin(), '-');
+    }
+    return digits;
+}
+} // namespace
+
+// -------- Environment and virtual clock --------
+const char *nativeEnv(const char *name, const char *fallback)
+{
+    const char *value = getenv(name);
+    return value != nullptr && value[0] != '\0' ? value : fallback;
+}
+
+double nativeEnvNumber(const char *name, double fallback)
+{
+    const char *value = getenv(name);
+    return value != nullptr && value[0] != '\0' ? atof(value) : fallback;
+}
+
+uint64_t nativeMicros()
+{
+    const auto elapsed = std::chrono::steady_clock::now() - bootInstant;
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()) +
+           virtualOffsetUs;
+}
+
+void nativeAdvance(uint64_t micros)
+{
+    virtualOffsetUs += micros;
+}
+
+time_t nativeEpoch()
+{
+    if (!epochInitialized)
+    {
+        epochAtStart = static_cast<time_t>(nativeEnvNumber("M5PW_EPOCH", static_cast<double>(time(nullptr))));
+        epochInitialized = true;
+    }
+    return epochAtStart + static_cast<time_t>(nativeMicros() / 1000000ULL);
+}
+
+void nativeSetEpoch(time_t epoch)
+{
+    nativeEpoch();
+    epochAtStart += epoch - nativeEpoch();
+}
+
+uint32_t millis()
+{
+    return static_cast<uint32_t>(nativeMicros() / 1000ULL);
+}
+
+uint32_t micros()
+{
+    return static_cast<uint32_t>(nativeMicros());
+}
+
+int64_t esp_timer_get_time()
+{
+    return static_cast<int64_t>(nativeMicros());
+}
+
+void delay(uint32_t ms)
+{
+    nativeAdvance(static_cast<uint64_t>(ms) * 1000ULL);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    nativeAdvance(us);
+}
+
+void yield() {}
+
+// -------- Misc core functions --------
+long random(long max)
+{
+    return max > 0 ? static_cast<long>(randomEngine() % static_cast<unsigned long>(max)) : 0;
+}
+
+long random(long min, long max)
+{
+    return max > min ? min + random(max - min) : min;
+}
+
+void randomSeed(unsigned long seed)
+{
+    randomEngine.seed(static_cast<uint32_t>(seed));
+}
+
+uint32_t esp_random()
+{
+    return randomEngine();
+}
+
+void pinMode(uint8_t, uint8_t) {}
+int digitalRead(uint8_t)
+{
+    return HIGH;
+}
+void digitalWrite(uint8_t, uint8_t) {}
+void attachInterrupt(uint8_t, void (*)(), int) {}
+void detachInterrupt(uint8_t) {}
+uint16_t analogRead(uint8_t)
+{
+    return 0;
+}
+
+void *ps_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void *ps_calloc(size_t count, size_t size)
+{
+    return calloc(count, size);
+}
+
+bool psramFound()
+{
+    return true;
+}
+
+void EspClass::restart()
+{
+    Serial.println("[Native] ESP.restart(); ending run.");
+    nativePrintSummary();
+    exit(0);
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    return fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush()
+{
+    fflush(stdout);
+}
+
+// -------- Print / Stream --------
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (n < size && write(buffer[n]) == 1)
+    {
+        ++n;
+    }
+    return n;
+}
+
+size_t Print::write(const char *text)
+{
+    return text != nullptr ? write(reinterpret_cast<const uint8_t *>(text), strlen(text)) : 0;
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    char small[256];
+    va_list args;
+    va_start(args, format);
+    const int length = vsnprintf(small, sizeof(small), format, args);
+    va_end(args);
+    if (length < 0)
+    {
+        return 0;
+    }
+    if (static_cast<size_t>(length) < sizeof(small))
+    {
+        return write(reinterpret_cast<const uint8_t *>(small), length);
+    }
+    std::string large(length + 1, '\0');
+    va_start(args, format);
+    vsnprintf(&large[0], large.size(), format, args);
+    va_end(args);
+    return write(reinterpret_cast<const uint8_t *>(large.data()), length);
+}
+
+size_t Stream::readBytes(char *buffer, size_t length)
+{
+    size_t n = 0;
+    while (n < length)
+    {
+        const int c = read();
+        if (c < 0)
+        {
+            break;
+        }
+        buffer[n++] = static_cast<char>(c);
+    }
+    return n;
+}
+
+String Stream::readString()
+{
+    std::string text;
+    for (int c = read(); c >= 0; c = read())
+    {
+        text += static_cast<char>(c);
+    }
+    return String(text);
+}
+
+String Stream::readStringUntil(char terminator)
+{
+    std::string text;
+    for (int c = read(); c >= 0 && c != terminator; c = read())
+    {
+        text += static_cast<char>(c);
+    }
+    return String(text);
+}
+
+// -------- String --------
+String::String(int value, unsigned char base)
+    : data(formatInteger(value < 0 ? 0ULL - static_cast<unsigned long long>(value) : value, value < 0, base))
+{
+}
+
+String::String(unsigned int value, unsigned char base) : data(formatInteger(value, false, base)) {}
+
+String::String(long value, unsigned char base)
+    : data(formatInteger(value < 0 ? 0ULL - static_cast<unsigned long long>(value) : value, value < 0, base))
+{
+}
+
+String::String(unsigned long value, unsigned char base) : data(formatInteger(value, false, base)) {}
+
+String::String(float value, unsigned int decimals) : String(static_cast<double>(value), decimals) {}
+
+String::String(double value, unsigned int decimals)
+{
+    char format[16];
+    snprintf(format, sizeof(format), "%%.%uf", decimals);
+    data = formatNumber(format, value);
+}
+
+int String::indexOf(char c, unsigned int from) const
+{
+    const size_t at = data.find(c, from);
+    return at == std::string::npos ? -1 : static_cast<int>(at);
+}
+
+int String::indexOf(const String &value, unsigned int from) const
+{
+    const size_t at = data.find(value.data, from);
+    return at == std::string::npos ? -1 : static_cast<int>(at);
+}
+
+int String::lastIndexOf(char c) const
+{
+    const size_t at = data.rfind(c);
+    return at == std::string::npos ? -1 : static_cast<int>(at);
+}
+
+String String::substring(unsigned int from) const
+{
+    return from < data.size() ? String(data.substr(from)) : String();
+}
+
+String String::substring(unsigned int from, unsigned int to) const
+{
+    if (from > to)
+    {
+        std::swap(from, to);
+    }
+    if (from >= data.size())
+    {
+        return String();
+    }
+    return String(data.substr(from, to - from));
+}
+
+bool String::startsWith(const String &prefix) const
+{
+    return data.compare(0, prefix.data.size(), prefix.data) == 0;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+    return data.size() >= suffix.data.size() &&
+           data.compare(data.size() - suffix.data.size(), suffix.data.size(), suffix.data) == 0;
+}
+
+bool String::equalsIgnoreCase(const String &other) const
+{
+    if (data.size() != other.data.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        if (tolower(static_cast<unsigned char>(data[i])) != tolower(static_cast<unsigned char>(other.data[i])))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void String::toLowerCase()
+{
+    for (char &c : data)
+    {
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+}
+
+void String::toUpperCase()
+{
+    for (char &c : data)
+    {
+        c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+}
+
+void String::trim()
+{
+    const size_t first = data.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos)
+    {
+        data.clear();
+        return;
+    }
+    const size_t last = data.find_last_not_of(" \t\r\n");
+    data = data.substr(first, last - first + 1);
+}
+
+void String::replace(const String &from, const String &to)
+{
+    if (from.data.empty())
+    {
+        return;
+    }
+    size_t at = 0;
+    while ((at = data.find(from.data, at)) != std::string::npos)
+    {
+        data.replace(at, from.data.size(), to.data);
+        at += to.data.size();
+    }
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+    if (index < data.size())
+    {
+        data.erase(index, count);
+    }
+}
+
+long String::toInt() const
+{
+    return atol(data.c_str());
+}
+
+float String::toFloat() const
+{
+    return static_cast<float>(atof(data.c_str()));
+}
+
+// -------- IPAddress --------
+bool IPAddress::fromString(const char *text)
+{
+    unsigned a = 0;
+    unsigned b = 0;
+    unsigned c = 0;
+    unsigned d = 0;
+    if (text == nullptr || sscanf(text, "%u.%u.%u.%u", &a, &b, &c, &d) != 4 || a > 255 || b > 255 || c > 255 ||
+        d > 255)
+    {
+        return false;
+    }
+    *this = IPAddress(a, b, c, d);
+    return true;
+}
+
+String IPAddress::toString() const
+{
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(text);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+// Host stand-in for the ESP32 Arduino core. Time is virtual: delay() and the
+// sleep calls advance it instead of blocking, so a simulated day of updates
+// runs in seconds. See nativeHal.h for the knobs.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "Print.h"
+#include "Stream.h"
+#include "WString.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define IRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define PI 3.1415926535897932384626433832795
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+uint32_t esp_random();
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+uint16_t analogRead(uint8_t pin);
+// Nothing raises interrupts on the host; handlers are accepted and never run.
+#define digitalPinToInterrupt(pin) (pin)
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode);
+void detachInterrupt(uint8_t pin);
+
+void *ps_malloc(size_t size);
+void *ps_calloc(size_t count, size_t size);
+bool psramFound();
+
+class HardwareSerial : public Stream
+{
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    void flush() override;
+    explicit operator bool() const { return true; }
+};
+extern HardwareSerial Serial;
+
+class EspClass
+{
+public:
+    uint32_t getFreeHeap() { return 300000; }
+    uint32_t getMinFreeHeap() { return 250000; }
+    uint32_t getMaxAllocHeap() { return 110000; }
+    uint32_t getFreePsram() { return 4000000; }
+    uint32_t getPsramSize() { return 4194304; }
+    uint32_t getCpuFreqMHz() { return 240; }
+    void restart();
+};
+extern EspClass ESP;
+
+class IPAddress
+{
+public:
+    IPAddress() = default;
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : address(static_cast<uint32_t>(a) | static_cast<uint32_t>(b) << 8 | static_cast<uint32_t>(c) << 16 |
+                  static_cast<uint32_t>(d) << 24)
+    {
+    }
+    IPAddress(uint32_t value) : address(value) {}
+    operator uint32_t() const { return address; }
+    uint8_t operator[](int index) const { return static_cast<uint8_t>(address >> (index * 8)); }
+    bool fromString(const char *text);
+    bool fromString(const String &text) { return fromString(text.c_str()); }
+    String toString() const;
+
+private:
+    uint32_t address{0};
+};
@@ -0,0 +1,187 @@
+#include "FS.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SD.h"
+#include "nativeHal.h"
+
+fs::SDFS SD;
+
+namespace fs
+{
+File::Handle::~Handle()
+{
+    if (stream != nullptr)
+    {
+        fclose(stream);
+    }
+}
+
+size_t File::write(const uint8_t *buffer, size_t size)
+{
+    return *this ? fwrite(buffer, 1, size, handle->stream) : 0;
+}
+
+int File::available()
+{
+    if (!*this)
+    {
+        return 0;
+    }
+    const size_t total = size();
+    const size_t at = position();
+    return at < total ? static_cast<int>(total - at) : 0;
+}
+
+int File::read()
+{
+    return *this ? fgetc(handle->stream) : -1;
+}
+
+int File::peek()
+{
+    if (!*this)
+    {
+        return -1;
+    }
+    const int c = fgetc(handle->stream);
+    if (c != EOF)
+    {
+        ungetc(c, handle->stream);
+    }
+    return c;
+}
+
+size_t File::read(uint8_t *buffer, size_t size)
+{
+    return *this ? fread(buffer, 1, size, handle->stream) : 0;
+}
+
+void File::flush()
+{
+    if (*this)
+    {
+        fflush(handle->stream);
+    }
+}
+
+bool File::seek(uint32_t position, SeekMode mode)
+{
+    static const int WHENCE[] = {SEEK_SET, SEEK_CUR, SEEK_END};
+    return *this && fseek(handle->stream, static_cast<long>(position), WHENCE[mode]) == 0;
+}
+
+size_t File::position() const
+{
+    if (!*this)
+    {
+        return 0;
+    }
+    const long at = ftell(handle->stream);
+    return at < 0 ? 0 : static_cast<size_t>(at);
+}
+
+size_t File::size() const
+{
+    if (!*this)
+    {
+        return 0;
+    }
+    fflush(handle->stream);
+    struct stat info;
+    return fstat(fileno(handle->stream), &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+}
+
+void File::close()
+{
+    handle.reset();
+}
+
+const char *File::name() const
+{
+    if (!handle)
+    {
+        return "";
+    }
+    const size_t slash = handle->path.rfind('/');
+    return handle->path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+}
+
+std::string FS::root() const
+{
+    return nativeEnv(envVariable, defaultRoot);
+}
+
+std::string FS::hostPath(const char *path) const
+{
+    std::string result = root();
+    if (path == nullptr || path[0] != '/')
+    {
+        result += '/';
+    }
+    result += path != nullptr ? path : "";
+    return result;
+}
+
+File FS::open(const char *path, const char *mode, bool)
+{
+    File file;
+    const std::string host = hostPath(path);
+    // The ESP32 VFS always opens binary and lets "r" files be seeked.
+    const char *hostMode = strcmp(mode, FILE_WRITE) == 0 ? "wb" : strcmp(mode, FILE_APPEND) == 0 ? "ab+" : "rb";
+    struct stat info;
+    if (strcmp(mode, FILE_READ) == 0 && (stat(host.c_str(), &info) != 0 || S_ISDIR(info.st_mode)))
+    {
+        return file;
+    }
+    FILE *stream = fopen(host.c_str(), hostMode);
+    if (stream == nullptr)
+    {
+        return file;
+    }
+    file.handle = std::make_shared<File::Handle>();
+    file.handle->stream = stream;
+    file.handle->path = path;
+    return file;
+}
+
+bool FS::exists(const char *path)
+{
+    struct stat info;
+    return stat(hostPath(path).c_str(), &info) == 0;
+}
+
+bool FS::remove(const char *path)
+{
+    return ::remove(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char *from, const char *to)
+{
+    return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool FS::mkdir(const char *path)
+{
+    return ::mkdir(hostPath(path).c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+bool FS::rmdir(const char *path)
+{
+    return ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+bool SDFS::begin(uint8_t)
+{
+    struct stat info;
+    if (stat(root().c_str(), &info) != 0 || !S_ISDIR(info.st_mode))
+    {
+        Serial.printf("[Native] SD root %s is not a directory.\n", root().c_str());
+        return false;
+    }
+    return true;
+}
+} // namespace fs
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "Arduino.h"
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs
+{
+enum SeekMode
+{
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+// A file on the host filesystem; copies share the same handle, like the ESP32 core.
+class File : public Stream
+{
+public:
+    File() = default;
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t read(uint8_t *buffer, size_t size);
+    size_t readBytes(char *buffer, size_t length) override { return read(reinterpret_cast<uint8_t *>(buffer), length); }
+    void flush() override;
+    bool seek(uint32_t position, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void close();
+    const char *path() const { return handle ? handle->path.c_str() : ""; }
+    const char *name() const;
+    explicit operator bool() const { return handle != nullptr && handle->stream != nullptr; }
+
+private:
+    friend class FS;
+    struct Handle
+    {
+        FILE *stream{nullptr};
+        std::string path;
+        ~Handle();
+    };
+    std::shared_ptr<Handle> handle;
+};
+
+// Maps absolute device paths ("/config/weather.json") below a host directory.
+class FS
+{
+public:
+    explicit FS(const char *envVariable, const char *defaultRoot) : envVariable(envVariable), defaultRoot(defaultRoot) {}
+
+    File open(const char *path, const char *mode = FILE_READ, bool create = false);
+    File open(const String &path, const char *mode = FILE_READ, bool create = false)
+    {
+        return open(path.c_str(), mode, create);
+    }
+    bool exists(const char *path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+    bool remove(const char *path);
+    bool remove(const String &path) { return remove(path.c_str()); }
+    bool rename(const char *from, const char *to);
+    bool rename(const String &from, const String &to) { return rename(from.c_str(), to.c_str()); }
+    bool mkdir(const char *path);
+    bool mkdir(const String &path) { return mkdir(path.c_str()); }
+    bool rmdir(const char *path);
+
+    std::string hostPath(const char *path) const;
+    std::string root() const;
+
+private:
+    const char *envVariable;
+    const char *defaultRoot;
+};
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekCur;
+using fs::SeekEnd;
+using fs::SeekSet;
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "WiFiClientSecure.h"
+
+#define HTTP_CODE_OK 200
+#define HTTP_CODE_NOT_FOUND 404
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+// Serves responses from files instead of the network. A URL maps to
+// <M5PW_HTTP_ROOT>/<last path segment>, tried as-is and with ".json"
+// appended: ".../data/2.5/forecast?..." reads forecast.json and
+// ".../img/wn/10d@2x.png" reads 10d@2x.png. Missing files answer 404.
+// With setReuse(true), end() leaves the client connected like keep-alive.
+//
+// Plain-HTTP URLs to localhost or 127.x go over a real socket instead, so a
+// host build can be pointed at tools/owmstub. The wall time a request takes
+// is added to the virtual clock; Date still reports the virtual time.
+class HTTPClient
+{
+public:
+    bool begin(const String &url);
+    bool begin(WiFiClient &client, const String &url);
+    void end();
+    int GET();
+    int getSize() const { return declaredSize >= 0 ? declaredSize : static_cast<int>(body.size()); }
+    String getString() { return String(body); }
+    WiFiClient &getStream() { return *client; }
+    WiFiClient *getStreamPtr() { return client; }
+    int writeToStream(Stream *stream);
+    void setTimeout(uint16_t) {}
+    void setConnectTimeout(int32_t) {}
+    void setReuse(bool value) { reuse = value; }
+    void useHTTP10(bool) {}
+    void collectHeaders(const char *headerKeys[], size_t headerKeysCount);
+    String header(const char *name) const;
+    bool hasHeader(const char *name) const { return headers.count(name) != 0; }
+    static String errorToString(int error);
+
+private:
+    std::string fixturePath() const;
+    bool isLoopback() const;
+    int getLoopback();
+    void stampDate();
+
+    WiFiClient ownClient;
+    WiFiClient *client{&ownClient};
+    String url;
+    std::string body;
+    int declaredSize{-1};
+    std::map<std::string, String> headers;
+    bool reuse{false};
+};
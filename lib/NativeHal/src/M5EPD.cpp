@@ -0,0 +1,288 @@
+#include "M5EPD.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "nativeHal.h"
+
+M5EPD M5;
+
+namespace
+{
+const char *modeName(m5epd_update_mode_t mode)
+{
+    static const char *NAMES[] = {"INIT", "DU", "GC16", "GL16", "GLR16", "GLD16", "DU4", "A2", "NONE"};
+    return mode <= UPDATE_MODE_NONE ? NAMES[mode] : "?";
+}
+
+size_t utf8Length(const char *text)
+{
+    size_t count = 0;
+    for (; *text != '\0'; ++text)
+    {
+        if ((static_cast<unsigned char>(*text) & 0xC0) != 0x80)
+        {
+            ++count;
+        }
+    }
+    return count;
+}
+} // namespace
+
+// -------- Panel --------
+void M5EPD_Driver::Clear(bool)
+{
+    memset(gram, 0, sizeof(gram));
+    UpdateFull(UPDATE_MODE_INIT);
+}
+
+int M5EPD_Driver::WritePartGram4bpp(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t *data)
+{
+    if (x + w > PANEL_WIDTH || y + h > PANEL_HEIGHT || (x | w) & 1)
+    {
+        return -1;
+    }
+    for (uint16_t row = 0; row < h; ++row)
+    {
+        memcpy(gram + ((y + row) * PANEL_WIDTH + x) / 2, data + row * w / 2, w / 2);
+    }
+    return 0;
+}
+
+int M5EPD_Driver::UpdateArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h, m5epd_update_mode_t mode)
+{
+    ++refreshes;
+    Serial.printf("[Native] EPD %s refresh #%u of %ux%u at (%u,%u)\n", modeName(mode), (unsigned)refreshes, w, h, x,
+                  y);
+    const char *dir = nativeEnv("M5PW_FRAME_DIR", nullptr);
+    if (dir == nullptr)
+    {
+        return 0;
+    }
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frame-%04u.pgm", dir, (unsigned)refreshes);
+    FILE *out = fopen(path, "wb");
+    if (out == nullptr)
+    {
+        return -1;
+    }
+    fprintf(out, "P5\n%u %u\n255\n", PANEL_WIDTH, PANEL_HEIGHT);
+    for (size_t i = 0; i < sizeof(gram); ++i)
+    {
+        const uint8_t pixels[2] = {static_cast<uint8_t>(255 - (gram[i] >> 4) * 17),
+                                   static_cast<uint8_t>(255 - (gram[i] & 0x0F) * 17)};
+        fwrite(pixels, 1, 2, out);
+    }
+    fclose(out);
+    return 0;
+}
+
+// -------- Sensors --------
+float SHT3x::GetTemperature()
+{
+    return static_cast<float>(nativeEnvNumber("M5PW_INDOOR_C", 21.5));
+}
+
+float SHT3x::GetRelHumidity()
+{
+    return static_cast<float>(nativeEnvNumber("M5PW_INDOOR_RH", 45.0));
+}
+
+uint32_t M5EPD::getBatteryVoltage()
+{
+    return static_cast<uint32_t>(nativeEnvNumber("M5PW_BATTERY_MV", 3950));
+}
+
+// -------- Canvas --------
+void *M5EPD_Canvas::createCanvas(uint16_t width, uint16_t height)
+{
+    deleteCanvas();
+    buffer = static_cast<uint8_t *>(calloc(static_cast<size_t>(width) * height / 2, 1));
+    if (buffer != nullptr)
+    {
+        canvasWidth = width;
+        canvasHeight = height;
+    }
+    return buffer;
+}
+
+void M5EPD_Canvas::deleteCanvas()
+{
+    free(buffer);
+    buffer = nullptr;
+    canvasWidth = 0;
+    canvasHeight = 0;
+}
+
+void M5EPD_Canvas::pushCanvas(int32_t x, int32_t y, m5epd_update_mode_t mode)
+{
+    if (buffer == nullptr || driver == nullptr)
+    {
+        return;
+    }
+    driver->WritePartGram4bpp(x, y, canvasWidth, canvasHeight, buffer);
+    driver->UpdateArea(x, y, canvasWidth, canvasHeight, mode);
+}
+
+void M5EPD_Canvas::fillCanvas(uint32_t color)
+{
+    if (buffer != nullptr)
+    {
+        const uint8_t c = color & 0x0F;
+        memset(buffer, c << 4 | c, static_cast<size_t>(canvasWidth) * canvasHeight / 2);
+    }
+}
+
+void M5EPD_Canvas::drawPixel(int32_t x, int32_t y, uint32_t color)
+{
+    if (buffer == nullptr || x < 0 || y < 0 || x >= canvasWidth || y >= canvasHeight)
+    {
+        return;
+    }
+    uint8_t &cell = buffer[(y * canvasWidth + x) / 2];
+    const uint8_t c = color & 0x0F;
+    cell = (x & 1) ? (cell & 0xF0) | c : (cell & 0x0F) | c << 4;
+}
+
+uint16_t M5EPD_Canvas::readPixel(int32_t x, int32_t y) const
+{
+    if (buffer == nullptr || x < 0 || y < 0 || x >= canvasWidth || y >= canvasHeight)
+    {
+        return 0;
+    }
+    const uint8_t cell = buffer[(y * canvasWidth + x) / 2];
+    return (x & 1) ? cell & 0x0F : cell >> 4;
+}
+
+void M5EPD_Canvas::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
+{
+    fillRect(x, y, w, 1, color);
+}
+
+void M5EPD_Canvas::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
+{
+    fillRect(x, y, 1, h, color);
+}
+
+void M5EPD_Canvas::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color)
+{
+    const int32_t dx = std::abs(x1 - x0);
+    const int32_t dy = -std::abs(y1 - y0);
+    const int32_t sx = x0 < x1 ? 1 : -1;
+    const int32_t sy = y0 < y1 ? 1 : -1;
+    int32_t error = dx + dy;
+    while (true)
+    {
+        drawPixel(x0, y0, color);
+        if (x0 == x1 && y0 == y1)
+        {
+            break;
+        }
+        const int32_t e2 = 2 * error;
+        if (e2 >= dy)
+        {
+            error += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx)
+        {
+            error += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void M5EPD_Canvas::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+{
+    fillRect(x, y, w, 1, color);
+    fillRect(x, y + h - 1, w, 1, color);
+    fillRect(x, y, 1, h, color);
+    fillRect(x + w - 1, y, 1, h, color);
+}
+
+void M5EPD_Canvas::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+{
+    const int32_t x0 = std::max<int32_t>(x, 0);
+    const int32_t y0 = std::max<int32_t>(y, 0);
+    const int32_t x1 = std::min<int32_t>(x + w, canvasWidth);
+    const int32_t y1 = std::min<int32_t>(y + h, canvasHeight);
+    for (int32_t py = y0; py < y1; ++py)
+    {
+        for (int32_t px = x0; px < x1; ++px)
+        {
+            drawPixel(px, py, color);
+        }
+    }
+}
+
+// Corners are drawn square; the layout, not the rounding, is what matters here.
+void M5EPD_Canvas::drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t, uint32_t color)
+{
+    drawRect(x, y, w, h, color);
+}
+
+void M5EPD_Canvas::fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t, uint32_t color)
+{
+    fillRect(x, y, w, h, color);
+}
+
+void M5EPD_Canvas::drawCircle(int32_t cx, int32_t cy, int32_t r, uint32_t color)
+{
+    for (int32_t dy = -r; dy <= r; ++dy)
+    {
+        for (int32_t dx = -r; dx <= r; ++dx)
+        {
+            const int32_t d = dx * dx + dy * dy;
+            if (d <= r * r && d > (r - 1) * (r - 1))
+            {
+                drawPixel(cx + dx, cy + dy, color);
+            }
+        }
+    }
+}
+
+void M5EPD_Canvas::fillCircle(int32_t cx, int32_t cy, int32_t r, uint32_t color)
+{
+    for (int32_t dy = -r; dy <= r; ++dy)
+    {
+        for (int32_t dx = -r; dx <= r; ++dx)
+        {
+            if (dx * dx + dy * dy <= r * r)
+            {
+                drawPixel(cx + dx, cy + dy, color);
+            }
+        }
+    }
+}
+
+int M5EPD_Canvas::loadFont(String path, fs::FS &fs)
+{
+    ttfLoaded = fs.exists(path);
+    return ttfLoaded ? 0 : -1;
+}
+
+// With a TTF loaded the text size is the pixel size; otherwise it scales the
+// 6x8 built-in font, as on the device.
+int16_t M5EPD_Canvas::fontHeight() const
+{
+    return ttfLoaded ? textSize : 8 * textSize;
+}
+
+int16_t M5EPD_Canvas::textWidth(const char *text)
+{
+    const double advance = ttfLoaded ? textSize * 0.55 : 6.0 * textSize;
+    return static_cast<int16_t>(utf8Length(text) * advance + 0.5);
+}
+
+int16_t M5EPD_Canvas::drawString(const char *text, int32_t x, int32_t y)
+{
+    const int16_t w = textWidth(text);
+    const int16_t h = fontHeight();
+    const int column = textDatum % 3;
+    const int row = textDatum / 3;
+    x -= column == 1 ? w / 2 : column == 2 ? w : 0;
+    y -= row == 1 ? h / 2 : row == 2 ? h : 0;
+    // A light tint of the text colour marks where the glyphs would go.
+    fillRect(x, y + h / 4, w, h / 2, std::max<int>(1, textColor / 4));
+    return w;
+}
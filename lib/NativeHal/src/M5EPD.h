@@ -0,0 +1,206 @@
+#pragma once
+
+// Host stand-in for the M5EPD library. The canvas keeps a real 4bpp
+// framebuffer (same nibble layout as the device) and implements the drawing
+// primitives the app uses, so render code runs unchanged. There is no font
+// rasterizer: text is measured with a fixed advance of 0.55 em and drawn as a
+// light-gray box covering its extent. The panel writes every refresh to
+// M5PW_FRAME_DIR as a PGM image when that variable is set.
+
+#include "Arduino.h"
+#include "FS.h"
+#include "SD.h"
+
+typedef enum
+{
+    UPDATE_MODE_INIT = 0,
+    UPDATE_MODE_DU = 1,
+    UPDATE_MODE_GC16 = 2,
+    UPDATE_MODE_GL16 = 3,
+    UPDATE_MODE_GLR16 = 4,
+    UPDATE_MODE_GLD16 = 5,
+    UPDATE_MODE_DU4 = 6,
+    UPDATE_MODE_A2 = 7,
+    UPDATE_MODE_NONE = 8
+} m5epd_update_mode_t;
+
+enum
+{
+    TL_DATUM = 0,
+    TC_DATUM = 1,
+    TR_DATUM = 2,
+    ML_DATUM = 3,
+    CL_DATUM = 3,
+    MC_DATUM = 4,
+    CC_DATUM = 4,
+    MR_DATUM = 5,
+    CR_DATUM = 5,
+    BL_DATUM = 6,
+    BC_DATUM = 7,
+    BR_DATUM = 8
+};
+
+struct tp_finger_t
+{
+    uint16_t x;
+    uint16_t y;
+    uint16_t size;
+    uint16_t id;
+};
+
+struct rtc_time_t
+{
+    int8_t hour;
+    int8_t min;
+    int8_t sec;
+};
+
+struct rtc_date_t
+{
+    int8_t week;
+    int16_t year;
+    int8_t mon;
+    int8_t day;
+};
+
+class M5EPD_Driver
+{
+public:
+    static constexpr uint16_t PANEL_WIDTH = 960;
+    static constexpr uint16_t PANEL_HEIGHT = 540;
+
+    void SetRotation(uint16_t rotation) { this->rotation = rotation; }
+    void Clear(bool init = false);
+    int WritePartGram4bpp(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t *data);
+    int UpdateArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h, m5epd_update_mode_t mode);
+    int UpdateFull(m5epd_update_mode_t mode) { return UpdateArea(0, 0, PANEL_WIDTH, PANEL_HEIGHT, mode); }
+
+    uint32_t refreshCount() const { return refreshes; }
+
+private:
+    uint8_t gram[PANEL_WIDTH * PANEL_HEIGHT / 2] = {};
+    uint16_t rotation{0};
+    uint32_t refreshes{0};
+};
+
+class GT911
+{
+public:
+    bool available() { return false; }
+    void update() {}
+    uint8_t getFingerNum() { return 0; }
+    tp_finger_t readFinger(uint8_t) { return tp_finger_t{0, 0, 0, 0}; }
+    void SetRotation(uint16_t) {}
+};
+
+// Starts unset (year 2000) like a BM8563 after power loss.
+class BM8563
+{
+public:
+    void begin() {}
+    void getTime(rtc_time_t *time) { *time = clock; }
+    void getDate(rtc_date_t *date) { *date = calendar; }
+    void setTime(rtc_time_t *time) { clock = *time; }
+    void setDate(rtc_date_t *date) { calendar = *date; }
+
+private:
+    rtc_time_t clock{0, 0, 0};
+    rtc_date_t calendar{6, 2000, 1, 1};
+};
+
+// Reports M5PW_INDOOR_C / M5PW_INDOOR_RH (default 21.5 C, 45 %).
+class SHT3x
+{
+public:
+    void Begin() {}
+    uint8_t UpdateData() { return 0; }
+    float GetTemperature();
+    float GetRelHumidity();
+};
+
+class M5EPD
+{
+public:
+    void begin(bool touchEnable = true, bool sdEnable = true, bool serialEnable = true, bool batteryADCEnable = true,
+               bool i2cEnable = false)
+    {
+    }
+    void update() {}
+    // Reports M5PW_BATTERY_MV (default 3950 mV).
+    uint32_t getBatteryVoltage();
+    void disableEPDPower() {}
+    void enableEPDPower() {}
+
+    M5EPD_Driver EPD;
+    GT911 TP;
+    BM8563 RTC;
+    SHT3x SHT30;
+};
+
+extern M5EPD M5;
+
+class M5EPD_Canvas : public Print
+{
+public:
+    explicit M5EPD_Canvas(M5EPD_Driver *driver) : driver(driver) {}
+    ~M5EPD_Canvas() { deleteCanvas(); }
+
+    void *createCanvas(uint16_t width, uint16_t height);
+    void deleteCanvas();
+    void *frameBuffer(int8_t = 1) { return buffer; }
+    int16_t width() const { return canvasWidth; }
+    int16_t height() const { return canvasHeight; }
+    void pushCanvas(int32_t x, int32_t y, m5epd_update_mode_t mode);
+    void pushCanvas(m5epd_update_mode_t mode) { pushCanvas(0, 0, mode); }
+
+    void fillCanvas(uint32_t color);
+    void drawPixel(int32_t x, int32_t y, uint32_t color);
+    uint16_t readPixel(int32_t x, int32_t y) const;
+    void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+    void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color);
+    void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+    void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+    void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+    void drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
+    void fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
+
+    void setTextColor(uint16_t color) { textColor = color; }
+    void setTextColor(uint16_t color, uint16_t) { textColor = color; }
+    void setTextDatum(uint8_t datum) { textDatum = datum; }
+    uint8_t getTextDatum() const { return textDatum; }
+    void setTextSize(uint8_t size) { textSize = size; }
+    int16_t textWidth(const String &text) { return textWidth(text.c_str()); }
+    int16_t textWidth(const char *text);
+    int16_t fontHeight() const;
+    int16_t drawString(const String &text, int32_t x, int32_t y) { return drawString(text.c_str(), x, y); }
+    int16_t drawString(const char *text, int32_t x, int32_t y);
+    size_t write(uint8_t) override { return 1; }
+
+    // No image decoders on the host.
+    bool drawPngFile(fs::FS &, const char *, uint16_t = 0, uint16_t = 0, uint16_t = 0, uint16_t = 0, uint16_t = 0,
+                     uint16_t = 0, double = 1.0, uint8_t = 127)
+    {
+        return false;
+    }
+    bool drawJpgFile(fs::FS &, const char *, uint16_t = 0, uint16_t = 0, uint16_t = 0, uint16_t = 0, uint16_t = 0,
+                     uint16_t = 0, uint8_t = 0)
+    {
+        return false;
+    }
+    bool drawBmpFile(fs::FS &, const char *, uint16_t, uint16_t) { return false; }
+
+    int loadFont(String path, fs::FS &fs);
+    int createRender(uint16_t size, uint16_t cacheSize = 1) { return 0; }
+
+private:
+    M5EPD_Driver *driver;
+    uint8_t *buffer{nullptr};
+    uint16_t canvasWidth{0};
+    uint16_t canvasHeight{0};
+    uint16_t textColor{15};
+    uint8_t textDatum{TL_DATUM};
+    uint8_t textSize{1};
+    bool ttfLoaded{false};
+};
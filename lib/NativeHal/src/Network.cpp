@@ -0,0 +1,315 @@
+#include "HTTPClient.h"
+
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+#include "nativeHal.h"
+
+WiFiClass WiFi;
+
+// -------- WiFi --------
+size_t WiFiClient::readBytes(char *buffer, size_t length)
+{
+    const size_t n = std::min(length, inbound.size() - cursor);
+    memcpy(buffer, inbound.data() + cursor, n);
+    cursor += n;
+    return n;
+}
+
+void WiFiClient::stop()
+{
+    inbound.clear();
+    cursor = 0;
+    open = false;
+}
+
+void WiFiClient::loadInbound(std::string bytes)
+{
+    inbound = std::move(bytes);
+    cursor = 0;
+}
+
+wl_status_t WiFiClass::begin(const char *ssid, const char *, int32_t, const uint8_t *bssid, bool)
+{
+    this->ssid = ssid != nullptr ? ssid : "";
+    currentMode = WIFI_MODE_STA;
+    const std::string outcome = nativeEnv("M5PW_WIFI", "ok");
+    if (outcome == "badpass" || outcome == "noap")
+    {
+        const bool badPassword = outcome == "badpass";
+        nativeAdvance(badPassword ? 800000 : 2000000);
+        currentStatus = badPassword ? WL_CONNECT_FAILED : WL_NO_SSID_AVAIL;
+        post(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, badPassword ? WIFI_REASON_AUTH_FAIL : WIFI_REASON_NO_AP_FOUND);
+        return currentStatus;
+    }
+    // Association, then the address: a remembered one is set straight away.
+    nativeAdvance(bssid != nullptr ? 250000 : 1500000);
+    post(ARDUINO_EVENT_WIFI_STA_CONNECTED);
+    nativeAdvance(bssid != nullptr ? 50000 : 1000000);
+    currentStatus = WL_CONNECTED;
+    post(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    return currentStatus;
+}
+
+wifi_event_id_t WiFiClass::onEvent(WiFiEventFuncCb callback, arduino_event_id_t event)
+{
+    handlers.push_back(EventHandler{std::move(callback), event});
+    return handlers.size();
+}
+
+void WiFiClass::post(arduino_event_id_t event, uint8_t reason)
+{
+    arduino_event_info_t info{};
+    info.wifi_sta_disconnected.reason = reason;
+    for (const EventHandler &handler : handlers)
+    {
+        if (handler.event == ARDUINO_EVENT_MAX || handler.event == event)
+        {
+            handler.callback(event, info);
+        }
+    }
+}
+
+bool WiFiClass::disconnect(bool wifiOff, bool)
+{
+    if (currentStatus == WL_CONNECTED)
+    {
+        post(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, WIFI_REASON_ASSOC_LEAVE);
+    }
+    currentStatus = WL_DISCONNECTED;
+    if (wifiOff)
+    {
+        currentMode = WIFI_MODE_NULL;
+    }
+    return true;
+}
+
+int16_t WiFiClass::scanNetworks()
+{
+    nativeAdvance(2000000);
+    return 0;
+}
+
+int WiFiClass::hostByName(const char *, IPAddress &result)
+{
+    nativeAdvance(20000);
+    result = IPAddress(192, 0, 2, 1);
+    return 1;
+}
+
+bool WiFiClass::mode(wifi_mode_t value)
+{
+    currentMode = value;
+    if (value == WIFI_MODE_NULL)
+    {
+        currentStatus = WL_DISCONNECTED;
+    }
+    return true;
+}
+
+// -------- HTTPClient --------
+bool HTTPClient::begin(const String &url)
+{
+    client = &ownClient;
+    this->url = url;
+    return url.startsWith("http://") || url.startsWith("https://");
+}
+
+bool HTTPClient::begin(WiFiClient &client, const String &url)
+{
+    const bool ok = begin(url);
+    this->client = &client;
+    return ok;
+}
+
+void HTTPClient::end()
+{
+    body.clear();
+    if (reuse && client != &ownClient)
+    {
+        while (client->read() >= 0)
+        {
+        }
+    }
+    else
+    {
+        client->stop();
+    }
+    client = &ownClient;
+}
+
+std::string HTTPClient::fixturePath() const
+{
+    std::string path = url.c_str();
+    path = path.substr(0, path.find('?'));
+    const std::string segment = path.substr(path.rfind('/') + 1);
+    return std::string(nativeEnv("M5PW_HTTP_ROOT", "http")) + "/" + segment;
+}
+
+bool HTTPClient::isLoopback() const
+{
+    return url.startsWith("http://localhost") || url.startsWith("http://127.");
+}
+
+void HTTPClient::stampDate()
+{
+    char date[40];
+    const time_t now = nativeEpoch();
+    struct tm utc;
+    gmtime_r(&now, &utc);
+    strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S GMT", &utc);
+    headers["Date"] = String(date);
+}
+
+// One HTTP/1.1 request with "Connection: close", read until the server hangs
+// up. A body cut short keeps the Content-Length the server announced.
+int HTTPClient::getLoopback()
+{
+    const auto start = std::chrono::steady_clock::now();
+    const std::string full = url.c_str() + strlen("http://");
+    const size_t slash = full.find('/');
+    const std::string authority = full.substr(0, slash);
+    const std::string target = slash == std::string::npos ? "/" : full.substr(slash);
+    const size_t colon = authority.find(':');
+    const std::string host = authority.substr(0, colon);
+    const std::string port = colon == std::string::npos ? "80" : authority.substr(colon + 1);
+
+    headers.clear();
+    body.clear();
+    declaredSize = -1;
+    int code = HTTPC_ERROR_CONNECTION_REFUSED;
+    addrinfo hints{};
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *address = nullptr;
+    const int fd = getaddrinfo(host.c_str(), port.c_str(), &hints, &address) == 0
+                       ? socket(address->ai_family, address->ai_socktype, address->ai_protocol)
+                       : -1;
+    if (fd >= 0 && connect(fd, address->ai_addr, address->ai_addrlen) == 0)
+    {
+        timeval timeout{15, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        const std::string request = "GET " + target + " HTTP/1.1\r\nHost: " + authority +
+                                    "\r\nUser-Agent: ESP32HTTPClient\r\nConnection: close\r\n\r\n";
+        send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+        std::string response;
+        char buffer[4096];
+        ssize_t received;
+        while ((received = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+        {
+            response.append(buffer, static_cast<size_t>(received));
+        }
+        const size_t headEnd = response.find("\r\n\r\n");
+        if (headEnd == std::string::npos)
+        {
+            code = received < 0 ? HTTPC_ERROR_READ_TIMEOUT : HTTPC_ERROR_CONNECTION_REFUSED;
+        }
+        else
+        {
+            std::istringstream head(response.substr(0, headEnd));
+            std::string line;
+            std::getline(head, line);
+            code = atoi(line.c_str() + line.find(' ') + 1);
+            while (std::getline(head, line))
+            {
+                const size_t separator = line.find(':');
+                if (separator == std::string::npos)
+                {
+                    continue;
+                }
+                std::string value = line.substr(separator + 1);
+                value.erase(0, value.find_first_not_of(' '));
+                value.erase(value.find_last_not_of("\r ") + 1);
+                headers[line.substr(0, separator)] = String(value);
+            }
+            body = response.substr(headEnd + 4);
+            if (headers.count("Content-Length") != 0)
+            {
+                declaredSize = headers["Content-Length"].toInt();
+            }
+        }
+    }
+    if (address != nullptr)
+    {
+        freeaddrinfo(address);
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    nativeAdvance(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
+    stampDate();
+    if (code > 0)
+    {
+        client->connect(IPAddress(127, 0, 0, 1), 80);
+    }
+    client->loadInbound(body);
+    return code;
+}
+
+int HTTPClient::GET()
+{
+    if (isLoopback())
+    {
+        return getLoopback();
+    }
+    declaredSize = -1;
+    const std::string base = fixturePath();
+    std::ifstream file(base, std::ios::binary);
+    if (!file)
+    {
+        file.open(base + ".json", std::ios::binary);
+    }
+    stampDate();
+
+    if (!file)
+    {
+        Serial.printf("[Native] No fixture for %s (looked for %s)\n", url.c_str(), base.c_str());
+        body.clear();
+        client->loadInbound(body);
+        return HTTP_CODE_NOT_FOUND;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    body = contents.str();
+    client->connect(IPAddress(192, 0, 2, 1), 443);
+    client->loadInbound(body);
+    return HTTP_CODE_OK;
+}
+
+int HTTPClient::writeToStream(Stream *stream)
+{
+    if (stream == nullptr)
+    {
+        return -1;
+    }
+    client->loadInbound(std::string());
+    return static_cast<int>(stream->write(reinterpret_cast<const uint8_t *>(body.data()), body.size()));
+}
+
+void HTTPClient::collectHeaders(const char *[], size_t) {}
+
+String HTTPClient::header(const char *name) const
+{
+    const auto it = headers.find(name);
+    return it != headers.end() ? it->second : String();
+}
+
+String HTTPClient::errorToString(int error)
+{
+    switch (error)
+    {
+    case HTTPC_ERROR_CONNECTION_REFUSED: return String("connection refused");
+    case HTTPC_ERROR_NOT_CONNECTED: return String("not connected");
+    case HTTPC_ERROR_READ_TIMEOUT: return String("read Timeout");
+    default: return String();
+    }
+}
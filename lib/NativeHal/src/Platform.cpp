@@ -0,0 +1,239 @@
+// Sleep, FreeRTOS queues, PNG decoding and the app's clock hooks on the host.
+
+#include <ctime>
+#include <vector>
+
+#include "Arduino.h"
+#include "M5EPD.h"
+#include "esp_sleep.h"
+#include "freertos/event_groups.h"
+#include "freertos/queue.h"
+#include "nativeHal.h"
+#include "utility/pngle.h"
+
+namespace
+{
+uint64_t armedTimerUs = 0;
+esp_sleep_wakeup_cause_t lastWakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+uint64_t lightSleeps = 0;
+uint64_t sleptUs = 0;
+
+struct FakePngle
+{
+    void *userData{nullptr};
+};
+} // namespace
+
+// -------- Sleep --------
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs)
+{
+    armedTimerUs = timeUs;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t, int)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_gpio_wakeup()
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_light_sleep_start()
+{
+    nativeAdvance(armedTimerUs);
+    sleptUs += armedTimerUs;
+    ++lightSleeps;
+    lastWakeCause = ESP_SLEEP_WAKEUP_TIMER;
+    return ESP_OK;
+}
+
+void esp_deep_sleep_start()
+{
+    // Nothing but RTC memory would survive, and main() cannot rerun the
+    // static initializers, so a deep sleep ends the run.
+    Serial.printf("[Native] Deep sleep for %llu s requested; ending run.\n", (unsigned long long)(armedTimerUs / 1000000ULL));
+    nativePrintSummary();
+    exit(0);
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause()
+{
+    return lastWakeCause;
+}
+
+void nativePrintSummary()
+{
+    const uint64_t elapsedUs = nativeMicros();
+    Serial.printf("[Native] Simulated %.1f h: %u panel refreshes, %llu light sleeps, awake %.2f%% of the time.\n",
+                  elapsedUs / 3.6e9, (unsigned)M5.EPD.refreshCount(), (unsigned long long)lightSleeps,
+                  elapsedUs > 0 ? 100.0 * (elapsedUs - sleptUs) / elapsedUs : 0.0);
+    Serial.flush();
+}
+
+// -------- FreeRTOS queues --------
+struct NativeQueue
+{
+    std::vector<uint8_t> storage;
+    size_t itemSize;
+    size_t length;
+    size_t head{0};
+    size_t count{0};
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+    NativeQueue *queue = new NativeQueue{std::vector<uint8_t>(static_cast<size_t>(length) * itemSize), itemSize, length};
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    delete queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t)
+{
+    if (queue->count == queue->length)
+    {
+        return pdFAIL;
+    }
+    const size_t slot = (queue->head + queue->count) % queue->length;
+    memcpy(queue->storage.data() + slot * queue->itemSize, item, queue->itemSize);
+    ++queue->count;
+    return pdPASS;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *woken)
+{
+    if (woken != nullptr)
+    {
+        *woken = pdFALSE;
+    }
+    return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t wait)
+{
+    if (queue->count == 0 && wait != 0)
+    {
+        delay(wait);
+    }
+    if (queue->count == 0)
+    {
+        return pdFALSE;
+    }
+    memcpy(item, queue->storage.data() + queue->head * queue->itemSize, queue->itemSize);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait)
+{
+    if (xQueuePeek(queue, item, wait) != pdTRUE)
+    {
+        return pdFALSE;
+    }
+    queue->head = (queue->head + 1) % queue->length;
+    --queue->count;
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    return static_cast<UBaseType_t>(queue->count);
+}
+
+// -------- FreeRTOS event groups --------
+struct NativeEventGroup
+{
+    EventBits_t bits{0};
+};
+
+EventGroupHandle_t xEventGroupCreate()
+{
+    return new NativeEventGroup();
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    group->bits |= bits;
+    return group->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    const EventBits_t before = group->bits;
+    group->bits &= ~bits;
+    return before;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group)
+{
+    return group->bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clearOnExit,
+                                BaseType_t waitForAll, TickType_t wait)
+{
+    const auto satisfied = [&]() {
+        return waitForAll ? (group->bits & bits) == bits : (group->bits & bits) != 0;
+    };
+    if (!satisfied() && wait != 0)
+    {
+        delay(wait);
+    }
+    const EventBits_t result = group->bits;
+    if (satisfied() && clearOnExit)
+    {
+        group->bits &= ~bits;
+    }
+    return result;
+}
+
+// -------- pngle --------
+pngle_t *pngle_new()
+{
+    return reinterpret_cast<pngle_t *>(new FakePngle());
+}
+
+void pngle_destroy(pngle_t *pngle)
+{
+    delete reinterpret_cast<FakePngle *>(pngle);
+}
+
+int pngle_feed(pngle_t *, const void *, size_t)
+{
+    return -1;
+}
+
+const char *pngle_error(pngle_t *)
+{
+    return "no PNG decoder in the native build";
+}
+
+void pngle_set_init_callback(pngle_t *, pngle_init_callback_t) {}
+
+void pngle_set_draw_callback(pngle_t *, pngle_draw_callback_t) {}
+
+void pngle_set_user_data(pngle_t *pngle, void *userData)
+{
+    reinterpret_cast<FakePngle *>(pngle)->userData = userData;
+}
+
+void *pngle_get_user_data(pngle_t *pngle)
+{
+    return reinterpret_cast<FakePngle *>(pngle)->userData;
+}
+
+// -------- App clock hooks (src/hal.h) --------
+time_t halEpochNow()
+{
+    return nativeEpoch();
+}
+
+void halSetEpoch(time_t epoch)
+{
+    nativeSetEpoch(epoch);
+}
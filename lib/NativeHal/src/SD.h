@@ -0,0 +1,17 @@
+#pragma once
+
+#include "FS.h"
+
+namespace fs
+{
+// The card is the directory named by M5PW_SD_ROOT (default ./sd).
+class SDFS : public FS
+{
+public:
+    SDFS() : FS("M5PW_SD_ROOT", "sd") {}
+    bool begin(uint8_t ssPin = 4);
+    void end() {}
+};
+} // namespace fs
+
+extern fs::SDFS SD;
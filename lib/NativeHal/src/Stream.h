@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Print.h"
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual size_t readBytes(char *buffer, size_t length);
+    size_t readBytes(uint8_t *buffer, size_t length) { return readBytes(reinterpret_cast<char *>(buffer), length); }
+    String readString();
+    String readStringUntil(char terminator);
+    void setTimeout(unsigned long ms) { timeoutMs = ms; }
+    unsigned long getTimeout() const { return timeoutMs; }
+
+protected:
+    unsigned long timeoutMs{1000};
+};
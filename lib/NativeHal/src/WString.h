@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Arduino String on top of std::string; only the members the app and
+// ArduinoJson use are provided.
+class String
+{
+public:
+    String(const char *value = "") : data(value != nullptr ? value : "") {}
+    String(const std::string &value) : data(value) {}
+    explicit String(char c) : data(1, c) {}
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(float value, unsigned int decimals = 2);
+    explicit String(double value, unsigned int decimals = 2);
+
+    unsigned int length() const { return static_cast<unsigned int>(data.size()); }
+    const char *c_str() const { return data.c_str(); }
+    bool isEmpty() const { return data.empty(); }
+    bool reserve(unsigned int size)
+    {
+        data.reserve(size);
+        return true;
+    }
+    void clear() { data.clear(); }
+
+    char charAt(unsigned int index) const { return index < data.size() ? data[index] : '\0'; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char &operator[](unsigned int index) { return data[index]; }
+
+    bool concat(const String &value)
+    {
+        data += value.data;
+        return true;
+    }
+    bool concat(const char *value)
+    {
+        data += value != nullptr ? value : "";
+        return true;
+    }
+    bool concat(const char *value, unsigned int length)
+    {
+        data.append(value, length);
+        return true;
+    }
+    bool concat(char c)
+    {
+        data += c;
+        return true;
+    }
+    String &operator+=(const String &value)
+    {
+        concat(value);
+        return *this;
+    }
+    String &operator+=(const char *value)
+    {
+        concat(value);
+        return *this;
+    }
+    String &operator+=(char c)
+    {
+        concat(c);
+        return *this;
+    }
+    String &operator+=(int value) { return *this += String(value); }
+    String &operator+=(unsigned int value) { return *this += String(value); }
+    String &operator+=(long value) { return *this += String(value); }
+    String &operator+=(unsigned long value) { return *this += String(value); }
+
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String &value, unsigned int from = 0) const;
+    int lastIndexOf(char c) const;
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+    bool startsWith(const String &prefix) const;
+    bool endsWith(const String &suffix) const;
+    bool equals(const String &other) const { return data == other.data; }
+    bool equalsIgnoreCase(const String &other) const;
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+    void replace(const String &from, const String &to);
+    void remove(unsigned int index, unsigned int count = static_cast<unsigned int>(-1));
+    long toInt() const;
+    float toFloat() const;
+
+    bool operator==(const String &other) const { return data == other.data; }
+    bool operator==(const char *other) const { return data == (other != nullptr ? other : ""); }
+    bool operator!=(const String &other) const { return !(*this == other); }
+    bool operator!=(const char *other) const { return !(*this == other); }
+    bool operator<(const String &other) const { return data < other.data; }
+
+private:
+    std::string data;
+};
+
+inline String operator+(const String &lhs, const String &rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+inline String operator+(const String &lhs, const char *rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+inline String operator+(const char *lhs, const String &rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+inline String operator+(const String &lhs, char rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+inline String operator+(const String &lhs, int rhs) { return lhs + String(rhs); }
+inline String operator+(const String &lhs, unsigned int rhs) { return lhs + String(rhs); }
+inline String operator+(const String &lhs, long rhs) { return lhs + String(rhs); }
+inline String operator+(const String &lhs, unsigned long rhs) { return lhs + String(rhs); }
+inline String operator+(const String &lhs, float rhs) { return lhs + String(rhs); }
+inline String operator+(const String &lhs, double rhs) { return lhs + String(rhs); }
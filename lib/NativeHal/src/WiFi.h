@@ -0,0 +1,147 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+
+typedef enum
+{
+    WL_NO_SHIELD = 255,
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum
+{
+    WIFI_MODE_NULL = 0,
+    WIFI_MODE_STA,
+    WIFI_MODE_AP,
+    WIFI_MODE_APSTA
+} wifi_mode_t;
+
+#define WIFI_OFF WIFI_MODE_NULL
+#define WIFI_STA WIFI_MODE_STA
+
+// The station events and disconnect reasons the app listens for.
+typedef enum
+{
+    ARDUINO_EVENT_WIFI_STA_CONNECTED,
+    ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+    ARDUINO_EVENT_WIFI_STA_GOT_IP,
+    ARDUINO_EVENT_MAX
+} arduino_event_id_t;
+
+enum
+{
+    WIFI_REASON_AUTH_EXPIRE = 2,
+    WIFI_REASON_ASSOC_LEAVE = 8,
+    WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT = 15,
+    WIFI_REASON_BEACON_TIMEOUT = 200,
+    WIFI_REASON_NO_AP_FOUND = 201,
+    WIFI_REASON_AUTH_FAIL = 202,
+    WIFI_REASON_ASSOC_FAIL = 203,
+    WIFI_REASON_HANDSHAKE_TIMEOUT = 204,
+};
+
+typedef union
+{
+    struct
+    {
+        uint8_t reason;
+    } wifi_sta_disconnected;
+} arduino_event_info_t;
+
+typedef std::function<void(arduino_event_id_t event, arduino_event_info_t info)> WiFiEventFuncCb;
+typedef size_t wifi_event_id_t;
+
+// A connection whose inbound bytes are a buffer filled by HTTPClient.
+// connect() always succeeds and the connection stays open until stop().
+class WiFiClient : public Stream
+{
+public:
+    virtual ~WiFiClient() = default;
+    int connect(IPAddress, uint16_t) { return open = true; }
+    int connect(const char *, uint16_t) { return open = true; }
+    size_t write(uint8_t) override { return 1; }
+    size_t write(const uint8_t *, size_t size) override { return size; }
+    int available() override { return static_cast<int>(inbound.size() - cursor); }
+    int read() override { return cursor < inbound.size() ? static_cast<uint8_t>(inbound[cursor++]) : -1; }
+    int peek() override { return cursor < inbound.size() ? static_cast<uint8_t>(inbound[cursor]) : -1; }
+    size_t readBytes(char *buffer, size_t length) override;
+    uint8_t connected() { return open || available() > 0; }
+    void stop();
+    explicit operator bool() { return connected(); }
+
+    void loadInbound(std::string bytes);
+
+private:
+    std::string inbound;
+    size_t cursor{0};
+    bool open{false};
+};
+
+// Always connects; SSID() reports what begin() was given. Joining a given
+// BSSID takes 300 ms of virtual time, a join by name 2.5 s (scan plus DHCP).
+// Scans find no networks, so the app falls back to joining by name.
+// Events are delivered from inside begin(), before it returns. With
+// M5PW_WIFI=badpass every join is refused after 800 ms as a wrong password,
+// with M5PW_WIFI=noap after 2 s as an access point that is not there.
+class WiFiClass
+{
+public:
+    wl_status_t begin(const char *ssid, const char *password = nullptr, int32_t channel = 0,
+                      const uint8_t *bssid = nullptr, bool connect = true);
+    wl_status_t status() const { return currentStatus; }
+    String SSID() const { return ssid; }
+    bool disconnect(bool wifiOff = false, bool eraseAp = false);
+    bool mode(wifi_mode_t value);
+    wifi_mode_t getMode() const { return currentMode; }
+    bool setSleep(bool) { return true; }
+    bool setAutoReconnect(bool) { return true; }
+    wifi_event_id_t onEvent(WiFiEventFuncCb callback, arduino_event_id_t event = ARDUINO_EVENT_MAX);
+    int8_t RSSI() const { return currentStatus == WL_CONNECTED ? -55 : 0; }
+    IPAddress localIP() const { return staticIp != 0 ? staticIp : IPAddress(192, 168, 1, 50); }
+    IPAddress gatewayIP() const { return IPAddress(192, 168, 1, 1); }
+    IPAddress subnetMask() const { return IPAddress(255, 255, 255, 0); }
+    IPAddress dnsIP(uint8_t = 0) const { return IPAddress(192, 168, 1, 1); }
+    bool config(IPAddress local, IPAddress, IPAddress, IPAddress = IPAddress(), IPAddress = IPAddress())
+    {
+        staticIp = local;
+        return true;
+    }
+    uint8_t *BSSID() { return bssid; }
+    int32_t channel() const { return currentStatus == WL_CONNECTED ? 6 : 0; }
+    int16_t scanNetworks();
+    void scanDelete() {}
+    String SSID(uint8_t) const { return String(); }
+    int32_t RSSI(uint8_t) const { return 0; }
+    uint8_t *BSSID(uint8_t) { return bssid; }
+    int32_t channel(uint8_t) const { return 0; }
+    // Every name resolves, to a documentation address.
+    int hostByName(const char *host, IPAddress &result);
+
+private:
+    struct EventHandler
+    {
+        WiFiEventFuncCb callback;
+        arduino_event_id_t event;
+    };
+
+    void post(arduino_event_id_t event, uint8_t reason = 0);
+
+    std::vector<EventHandler> handlers;
+    wl_status_t currentStatus{WL_IDLE_STATUS};
+    wifi_mode_t currentMode{WIFI_MODE_NULL};
+    String ssid;
+    IPAddress staticIp;
+    uint8_t bssid[6]{0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+};
+
+extern WiFiClass WiFi;
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "WiFi.h"
+
+class WiFiClientSecure : public WiFiClient
+{
+public:
+    void setInsecure() {}
+    int connect(IPAddress ip, uint16_t port, const char *, const char *, const char *, const char *)
+    {
+        return WiFiClient::connect(ip, port);
+    }
+};
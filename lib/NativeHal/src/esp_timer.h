@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstdint>
+
+// Microseconds on the virtual clock, like millis() and micros().
+int64_t esp_timer_get_time();
@@ -0,0 +1,19 @@
+#pragma once
+
+// Host stand-in for the FreeRTOS types and macros the app uses. Ticks are
+// milliseconds of virtual time. There is no scheduler: tasks do not start
+// (see task.h), and queues are plain rings used from the one host thread.
+
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL 0
+#define pdPASS 1
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define pdMS_TO_TICKS(ms) (static_cast<TickType_t>(ms))
+#define portYIELD_FROM_ISR(...)
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef struct NativeEventGroup *EventGroupHandle_t;
+typedef uint32_t EventBits_t;
+
+// Bit sets for handing events between tasks. Bits are only ever set from
+// the host thread itself (callbacks run inside the call that raised them), so
+// a wait that would block just advances the virtual clock by its timeout.
+EventGroupHandle_t xEventGroupCreate();
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group);
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clearOnExit,
+                                BaseType_t waitForAll, TickType_t wait);
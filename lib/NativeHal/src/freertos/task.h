@@ -0,0 +1,22 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void *);
+typedef struct NativeTask *TaskHandle_t;
+
+// Always fails: the host has no scheduler, so callers take their
+// single-threaded fallback.
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char *, uint32_t, void *, UBaseType_t,
+                                          TaskHandle_t *handle, BaseType_t)
+{
+    if (handle != nullptr)
+    {
+        *handle = nullptr;
+    }
+    return pdFAIL;
+}
+
+inline void vTaskNotifyGiveFromISR(TaskHandle_t, BaseType_t *) {}
+inline BaseType_t xTaskNotifyGive(TaskHandle_t) { return pdPASS; }
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
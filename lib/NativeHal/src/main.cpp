@@ -0,0 +1,20 @@
+// Entry point for env:native: runs the sketch against the virtual clock until
+// M5PW_RUN_HOURS of simulated time have passed.
+
+#include "Arduino.h"
+#include "nativeHal.h"
+
+void setup();
+void loop();
+
+int main()
+{
+    const uint64_t runUs = static_cast<uint64_t>(nativeEnvNumber("M5PW_RUN_HOURS", 24) * 3600.0 * 1e6);
+    setup();
+    while (nativeMicros() < runUs)
+    {
+        loop();
+    }
+    nativePrintSummary();
+    return 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+// Internals shared by the NativeHal sources and main(). Knobs (environment):
+//   M5PW_SD_ROOT     directory standing in for the SD card (default ./sd)
+//   M5PW_HTTP_ROOT   directory of canned HTTP responses (default ./http);
+//                    http://localhost and 127.x URLs go to a real server instead
+//   M5PW_FRAME_DIR   if set, every panel refresh is written there as PGM
+//   M5PW_RUN_HOURS   simulated time to run before exiting (default 24)
+//   M5PW_EPOCH       wall-clock start as a Unix time (default: host clock)
+//   M5PW_INDOOR_C, M5PW_INDOOR_RH, M5PW_BATTERY_MV   sensor readings
+//   M5PW_WIFI        ok (default), badpass or noap: how every Wi-Fi join ends
+
+const char *nativeEnv(const char *name, const char *fallback);
+double nativeEnvNumber(const char *name, double fallback);
+
+// Virtual monotonic clock in microseconds since start.
+uint64_t nativeMicros();
+void nativeAdvance(uint64_t micros);
+time_t nativeEpoch();
+void nativeSetEpoch(time_t epoch);
+
+void nativePrintSummary();
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// There is no PNG decoder on the host: pngle_feed() always fails, so icons
+// are simply not baked and renders go on without them.
+typedef struct _pngle_t pngle_t;
+typedef void (*pngle_init_callback_t)(pngle_t *pngle, uint32_t w, uint32_t h);
+typedef void (*pngle_draw_callback_t)(pngle_t *pngle, uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint8_t rgba[4]);
+
+pngle_t *pngle_new();
+void pngle_destroy(pngle_t *pngle);
+int pngle_feed(pngle_t *pngle, const void *buffer, size_t length);
+const char *pngle_error(pngle_t *pngle);
+void pngle_set_init_callback(pngle_t *pngle, pngle_init_callback_t callback);
+void pngle_set_draw_callback(pngle_t *pngle, pngle_draw_callback_t callback);
+void pngle_set_user_data(pngle_t *pngle, void *userData);
+void *pngle_get_user_data(pngle_t *pngle);
@@ -0,0 +1,171 @@
+#include "batteryModel.h"
+
+#include <algorithm>
+
+namespace
+{
+struct CurvePoint
+{
+    float millivolts;
+    float percent;
+};
+
+// Resting voltage of a single LiPo cell against state of charge. The flat
+// middle is why a linear 3.0-4.2 V mapping reads 50% with most of the charge gone.
+constexpr CurvePoint DISCHARGE_CURVE[] = {
+    {3300.0F, 0.0F},  {3500.0F, 4.0F},  {3600.0F, 8.0F},  {3650.0F, 14.0F}, {3700.0F, 24.0F},
+    {3750.0F, 35.0F}, {3800.0F, 45.0F}, {3850.0F, 55.0F}, {3900.0F, 64.0F}, {4000.0F, 78.0F},
+    {4100.0F, 90.0F}, {4200.0F, 100.0F},
+};
+
+// Weight of a new reading in the voltage filter.
+constexpr float FILTER_ALPHA = 0.3F;
+// A reading this far above the filter means the cell is charging.
+constexpr float CHARGE_JUMP_MV = 60.0F;
+// At or above this the cell is on the charger or on the flat top of the
+// curve; drops measured there say nothing about cost.
+constexpr float LEARNING_CEILING_MV = 4150.0F;
+// Sleep time over which drops are summed before they update the costs, and
+// the weight of each such sum in the running averages.
+constexpr uint32_t LEARNING_WINDOW_SECONDS = 6 * 60 * 60;
+constexpr float COST_ALPHA = 0.25F;
+constexpr float MAX_CYCLE_COST = 1.0F;
+constexpr float MAX_SLEEP_COST = 5.0F;
+constexpr float LOW_BATTERY_HYSTERESIS = 5.0F;
+
+float blend(float average, float sample, float alpha, float ceiling)
+{
+    return std::min(std::max(average + alpha * (sample - average), 0.0F), ceiling);
+}
+} // namespace
+
+float BatteryModel::percentForMillivolts(float millivolts)
+{
+    constexpr size_t count = sizeof(DISCHARGE_CURVE) / sizeof(DISCHARGE_CURVE[0]);
+    if (millivolts <= DISCHARGE_CURVE[0].millivolts)
+    {
+        return 0.0F;
+    }
+    for (size_t i = 1; i < count; ++i)
+    {
+        const CurvePoint &upper = DISCHARGE_CURVE[i];
+        if (millivolts <= upper.millivolts)
+        {
+            const CurvePoint &lower = DISCHARGE_CURVE[i - 1];
+            return lower.percent + (upper.percent - lower.percent) * (millivolts - lower.millivolts) /
+                                       (upper.millivolts - lower.millivolts);
+        }
+    }
+    return 100.0F;
+}
+
+void BatteryModel::configure(uint16_t targetDays, float lowPercent)
+{
+    this->targetDays = targetDays;
+    this->lowPercent = lowPercent;
+}
+
+void BatteryModel::filter(float millivolts, time_t now)
+{
+    if (!readingValid || millivolts > filteredMv + CHARGE_JUMP_MV)
+    {
+        // First reading, or back from the charger: the runtime target restarts here.
+        filteredMv = millivolts;
+        readingValid = true;
+        dischargeStart = now;
+        dischargeStartPercent = percentForMillivolts(millivolts);
+        restEpoch = 0;
+        std::fill(pendingCycleDrop, pendingCycleDrop + KIND_COUNT, 0.0F);
+        std::fill(pendingCycles, pendingCycles + KIND_COUNT, 0);
+        pendingSleepDrop = 0.0F;
+        pendingSleepSeconds = 0;
+    }
+    else
+    {
+        filteredMv += FILTER_ALPHA * (millivolts - filteredMv);
+    }
+
+    const float charge = percent();
+    if (!low && charge < lowPercent)
+    {
+        low = true;
+    }
+    else if (low && charge > lowPercent + LOW_BATTERY_HYSTERESIS)
+    {
+        low = false;
+    }
+}
+
+float BatteryModel::observe(uint32_t millivolts, time_t now)
+{
+    filter(static_cast<float>(millivolts), now);
+    return percent();
+}
+
+void BatteryModel::beginCycle(uint32_t millivolts, time_t now)
+{
+    filter(static_cast<float>(millivolts), now);
+    cycleStartPercent = percentForMillivolts(static_cast<float>(millivolts));
+    if (restEpoch != 0 && now > restEpoch && millivolts < LEARNING_CEILING_MV)
+    {
+        pendingSleepDrop += restPercent - cycleStartPercent;
+        pendingSleepSeconds += static_cast<uint32_t>(now - restEpoch);
+    }
+}
+
+void BatteryModel::endCycle(UpdateCycle kind, uint32_t millivolts, time_t now)
+{
+    filter(static_cast<float>(millivolts), now);
+    const float endPercent = percentForMillivolts(static_cast<float>(millivolts));
+    if (millivolts < LEARNING_CEILING_MV && cycleStartPercent > 0.0F)
+    {
+        const int index = static_cast<int>(kind);
+        pendingCycleDrop[index] += cycleStartPercent - endPercent;
+        ++pendingCycles[index];
+    }
+    restPercent = endPercent;
+    restEpoch = now;
+    if (pendingSleepSeconds >= LEARNING_WINDOW_SECONDS)
+    {
+        learn();
+    }
+}
+
+void BatteryModel::learn()
+{
+    sleepPerHour = blend(sleepPerHour, pendingSleepDrop * 3600.0F / pendingSleepSeconds, COST_ALPHA, MAX_SLEEP_COST);
+    for (int i = 0; i < KIND_COUNT; ++i)
+    {
+        if (pendingCycles[i] > 0)
+        {
+            costs[i] = blend(costs[i], pendingCycleDrop[i] / pendingCycles[i], COST_ALPHA, MAX_CYCLE_COST);
+        }
+        pendingCycleDrop[i] = 0.0F;
+        pendingCycles[i] = 0;
+    }
+    pendingSleepDrop = 0.0F;
+    pendingSleepSeconds = 0;
+}
+
+float BatteryModel::stretch(time_t weatherInterval, time_t indoorInterval, time_t now) const
+{
+    if (targetDays == 0 || !readingValid || weatherInterval <= 0 || indoorInterval <= 0)
+    {
+        return 1.0F;
+    }
+    // A cell that started part-charged gets the matching share of the target.
+    const float targetSeconds = targetDays * 86400.0F * dischargeStartPercent / 100.0F;
+    const float remainingHours = (dischargeStart + targetSeconds - now) / 3600.0F;
+    if (remainingHours <= 0.0F)
+    {
+        return 1.0F; // target already met
+    }
+    const float budgetPerHour = percent() / remainingHours - sleepPerHour;
+    const float cyclesPerHour = costs[static_cast<int>(UpdateCycle::Weather)] * 3600.0F / weatherInterval +
+                                costs[static_cast<int>(UpdateCycle::Indoor)] * 3600.0F / indoorInterval;
+    if (budgetPerHour <= 0.0F)
+    {
+        return MAX_STRETCH;
+    }
+    return std::min(std::max(cyclesPerHour / budgetPerHour, 1.0F), MAX_STRETCH);
+}
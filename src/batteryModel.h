@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+// Kinds of scheduled update, whose energy cost is learned separately.
+enum class UpdateCycle : uint8_t
+{
+    Weather,
+    Indoor,
+};
+
+// Remaining charge and energy budget of the LiPo cell.
+//
+// Readings (already oversampled by the caller) go through an exponential
+// filter and a piecewise-linear LiPo discharge curve. Each update cycle is
+// bracketed by a reading before and after it: the drop across the cycle is
+// that cycle kind's cost, and the drop between two cycles, per hour, is the
+// sleep cost. A single drop is about the size of one ADC step, so drops are
+// summed over a few hours before they update the costs; the readings chain
+// end to end, so the steps cancel out of those sums. Costs are running
+// averages in percent of capacity, seeded with conservative guesses so the
+// first cycles already give a usable budget.
+//
+// With a target runtime configured, stretch() returns the factor by which the
+// configured update intervals have to grow for the remaining charge to last
+// until the target. Below the low-battery threshold the owner stops weather
+// fetches altogether; the state has some hysteresis so a recovering cell
+// does not flip it back and forth.
+class BatteryModel
+{
+public:
+    static constexpr float MAX_STRETCH = 8.0F;
+
+    // State of charge in percent for a cell voltage.
+    static float percentForMillivolts(float millivolts);
+
+    // `targetDays` 0 disables stretching. Applied after every config load.
+    void configure(uint16_t targetDays, float lowPercent);
+
+    // A reading outside a cycle (boot, a tap). Returns the filtered charge.
+    float observe(uint32_t millivolts, time_t now);
+    void beginCycle(uint32_t millivolts, time_t now);
+    void endCycle(UpdateCycle kind, uint32_t millivolts, time_t now);
+
+    bool hasReading() const { return readingValid; }
+    float percent() const { return percentForMillivolts(filteredMv); }
+    bool lowBattery() const { return low; }
+    // Percent of capacity per cycle, and per hour asleep.
+    float cycleCost(UpdateCycle kind) const { return costs[static_cast<int>(kind)]; }
+    float sleepCostPerHour() const { return sleepPerHour; }
+
+    // Multiplier (1..MAX_STRETCH) for the configured intervals, in seconds,
+    // that spends the remaining charge no faster than the target allows.
+    float stretch(time_t weatherInterval, time_t indoorInterval, time_t now) const;
+
+private:
+    static constexpr int KIND_COUNT = 2;
+
+    void filter(float millivolts, time_t now);
+    void learn();
+
+    uint16_t targetDays{0};
+    float lowPercent{10.0F};
+
+    bool readingValid{false};
+    float filteredMv{0.0F};
+    // Start of the current discharge: first reading, or the last time the
+    // cell was seen charging. The target runtime counts from here.
+    time_t dischargeStart{0};
+    float dischargeStartPercent{100.0F};
+    bool low{false};
+
+    // Raw charge at the start of the open cycle and at the end of the last one.
+    float cycleStartPercent{0.0F};
+    float restPercent{0.0F};
+    time_t restEpoch{0};
+
+    // Drops since the costs were last updated.
+    float pendingCycleDrop[KIND_COUNT]{};
+    uint16_t pendingCycles[KIND_COUNT]{};
+    float pendingSleepDrop{0.0F};
+    uint32_t pendingSleepSeconds{0};
+
+    float costs[KIND_COUNT]{0.02F, 0.004F};
+    float sleepPerHour{0.1F};
+};
@@ -0,0 +1,354 @@
+#include "climateHistory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include "snapshotStore.h"
+
+namespace
+{
+constexpr uint32_t BLOCK_MAGIC = 0x424C4349;   // "ICLB"
+constexpr uint32_t PENDING_MAGIC = 0x50434C49; // "ILCP"
+
+struct BlockHeader
+{
+    uint32_t magic;
+    uint32_t firstSlot;
+    uint16_t count;
+    uint16_t slotSeconds;
+    uint32_t crc;
+};
+
+// Samples for consecutive slots from firstSlot that the log does not hold yet.
+struct PendingSamples
+{
+    uint32_t magic;
+    uint32_t slotSeconds;
+    uint32_t flushedThrough;
+    uint32_t firstSlot;
+    uint32_t count;
+    ClimateSample samples[ClimateHistory::FLUSH_BLOCK_SAMPLES];
+};
+
+static_assert(std::is_trivially_copyable<PendingSamples>::value, "PendingSamples is kept as raw bytes in RTC memory");
+
+// A cold boot zeroes it; begin() ignores it on the missing magic.
+RTC_DATA_ATTR PendingSamples pending;
+
+ClimateSample emptySample()
+{
+    return ClimateSample{0, CLIMATE_NO_SAMPLE};
+}
+} // namespace
+
+bool ClimateHistory::begin(uint32_t slotSeconds)
+{
+    slotLength = std::min<uint32_t>(std::max<uint32_t>(slotSeconds, 60), 60 * 60);
+    const size_t wanted = WINDOW_SECONDS / slotLength + 1;
+    if (ring == nullptr || capacity != wanted)
+    {
+        free(ring);
+        capacity = wanted;
+        ring = static_cast<ClimateSample *>(ps_malloc(capacity * sizeof(ClimateSample)));
+    }
+    if (ring == nullptr)
+    {
+        Serial.println("[Climate] No PSRAM for the history ring; history disabled.");
+        capacity = 0;
+        return false;
+    }
+    std::fill(ring, ring + capacity, emptySample());
+    newest = 0;
+    flushedThrough = 0;
+    replayed = false;
+    if (pending.magic == PENDING_MAGIC && pending.slotSeconds == slotLength)
+    {
+        flushedThrough = pending.flushedThrough;
+        for (uint32_t i = 0; i < pending.count; ++i)
+        {
+            if (pending.samples[i].deciPercent != CLIMATE_NO_SAMPLE)
+            {
+                store(pending.firstSlot + i, pending.samples[i]);
+            }
+        }
+    }
+    return true;
+}
+
+void ClimateHistory::retainPending() const
+{
+    if (ring == nullptr)
+    {
+        return;
+    }
+    pending.magic = PENDING_MAGIC;
+    pending.slotSeconds = slotLength;
+    pending.flushedThrough = flushedThrough;
+    pending.count = 0;
+    if (newest <= flushedThrough)
+    {
+        return;
+    }
+    // More than a block is pending only while SD writes fail; the newest block is kept.
+    const uint32_t blockStart = newest >= FLUSH_BLOCK_SAMPLES ? newest - FLUSH_BLOCK_SAMPLES + 1 : 1;
+    pending.firstSlot = std::max(flushedThrough + 1, blockStart);
+    pending.count = newest - pending.firstSlot + 1;
+    for (uint32_t i = 0; i < pending.count; ++i)
+    {
+        pending.samples[i] = ring[(pending.firstSlot + i) % capacity];
+    }
+}
+
+void ClimateHistory::store(uint32_t slot, ClimateSample sample)
+{
+    if (ring == nullptr || slot == 0)
+    {
+        return;
+    }
+    if (newest != 0 && slot + capacity <= newest)
+    {
+        return; // older than the window
+    }
+    if (newest == 0 && flushedThrough == 0)
+    {
+        flushedThrough = slot - 1; // the log starts at the first reading, not a week before it
+    }
+    if (newest == 0 || slot > newest)
+    {
+        // Slots skipped since the newest sample still hold readings from a week ago.
+        const uint32_t first = newest == 0 ? slot : newest + 1;
+        for (uint32_t s = std::max<uint32_t>(first, slot >= capacity ? slot - capacity + 1 : 0); s < slot; ++s)
+        {
+            ring[s % capacity] = emptySample();
+        }
+        newest = slot;
+    }
+    ring[slot % capacity] = sample;
+}
+
+void ClimateHistory::record(time_t epoch, float temperatureF, float humidity)
+{
+    if (std::isnan(temperatureF) || std::isnan(humidity))
+    {
+        return;
+    }
+    ClimateSample sample;
+    sample.centiF = static_cast<int16_t>(constrain(lroundf(temperatureF * 100.0F), -32000L, 32000L));
+    sample.deciPercent = static_cast<uint16_t>(constrain(lroundf(humidity * 10.0F), 0L, 1000L));
+    store(slotFor(epoch), sample);
+    retainPending();
+}
+
+bool ClimateHistory::at(uint32_t slot, ClimateSample &sample) const
+{
+    if (ring == nullptr || newest == 0 || slot > newest || slot + capacity <= newest)
+    {
+        return false;
+    }
+    sample = ring[slot % capacity];
+    return sample.deciPercent != CLIMATE_NO_SAMPLE;
+}
+
+ClimateStats ClimateHistory::stats(uint32_t firstSlot, uint32_t lastSlot) const
+{
+    ClimateStats result;
+    int32_t sumCentiF = 0;
+    uint32_t sumDeciPercent = 0;
+    ClimateSample sample;
+    for (uint32_t slot = firstSlot; slot <= lastSlot; ++slot)
+    {
+        if (!at(slot, sample))
+        {
+            continue;
+        }
+        if (result.count == 0)
+        {
+            result.minCentiF = result.maxCentiF = sample.centiF;
+            result.minDeciPercent = result.maxDeciPercent = sample.deciPercent;
+        }
+        result.minCentiF = std::min(result.minCentiF, sample.centiF);
+        result.maxCentiF = std::max(result.maxCentiF, sample.centiF);
+        result.minDeciPercent = std::min(result.minDeciPercent, sample.deciPercent);
+        result.maxDeciPercent = std::max(result.maxDeciPercent, sample.deciPercent);
+        sumCentiF += sample.centiF;
+        sumDeciPercent += sample.deciPercent;
+        ++result.count;
+    }
+    if (result.count > 0)
+    {
+        result.avgCentiF = sumCentiF / static_cast<int32_t>(result.count);
+        result.avgDeciPercent = sumDeciPercent / result.count;
+    }
+    return result;
+}
+
+bool ClimateHistory::load(fs::FS &fs, const char *path)
+{
+    if (ring == nullptr)
+    {
+        return false;
+    }
+    recoverSideFile(fs, path);
+    if (!fs.exists(path))
+    {
+        replayed = true; // nothing logged yet
+        return false;
+    }
+    File f = fs.open(path, FILE_READ);
+    if (!f)
+    {
+        return false;
+    }
+    size_t blocks = 0;
+    uint32_t logNewest = 0;
+    BlockHeader header{};
+    ClimateSample chunk[FLUSH_BLOCK_SAMPLES];
+    while (f.read(reinterpret_cast<uint8_t *>(&header), sizeof(header)) == sizeof(header))
+    {
+        if (header.magic != BLOCK_MAGIC)
+        {
+            Serial.printf("[Climate] %s has a damaged block; keeping what came before it.\n", path);
+            break;
+        }
+        // Read in chunks so a long compacted block needs no second buffer.
+        uint32_t crc = 0;
+        const size_t start = f.position();
+        for (size_t done = 0; done < header.count;)
+        {
+            const size_t n = std::min<size_t>(header.count - done, FLUSH_BLOCK_SAMPLES);
+            if (f.read(reinterpret_cast<uint8_t *>(chunk), n * sizeof(ClimateSample)) != n * sizeof(ClimateSample))
+            {
+                break;
+            }
+            crc = crc32Update(crc, reinterpret_cast<const uint8_t *>(chunk), n * sizeof(ClimateSample));
+            done += n;
+        }
+        if (crc != header.crc)
+        {
+            Serial.printf("[Climate] %s block failed its checksum; keeping what came before it.\n", path);
+            break;
+        }
+        if (header.slotSeconds != slotLength)
+        {
+            continue; // written with another indoor interval
+        }
+        f.seek(start);
+        for (size_t done = 0; done < header.count;)
+        {
+            const size_t n = std::min<size_t>(header.count - done, FLUSH_BLOCK_SAMPLES);
+            f.read(reinterpret_cast<uint8_t *>(chunk), n * sizeof(ClimateSample));
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (chunk[i].deciPercent != CLIMATE_NO_SAMPLE)
+                {
+                    store(header.firstSlot + done + i, chunk[i]);
+                }
+            }
+            done += n;
+        }
+        logNewest = std::max<uint32_t>(logNewest, header.firstSlot + header.count - 1);
+        ++blocks;
+    }
+    f.close();
+    // Samples recorded before the replay are still pending; the log holds only what it held.
+    flushedThrough = std::max(flushedThrough, logNewest);
+    replayed = true;
+    retainPending();
+    Serial.printf("[Climate] Replayed %u block(s) from %s.\n", (unsigned)blocks, path);
+    return blocks > 0;
+}
+
+bool ClimateHistory::appendBlock(fs::FS &fs, const char *path, uint32_t firstSlot, uint32_t lastSlot)
+{
+    File f = fs.open(path, FILE_APPEND);
+    if (!f)
+    {
+        Serial.printf("[Climate] Failed to open %s for appending\n", path);
+        return false;
+    }
+    // Blocks are bounded by the uint16 count; a compacted ring may need several.
+    bool ok = true;
+    for (uint32_t blockStart = firstSlot; ok && blockStart <= lastSlot; blockStart += UINT16_MAX)
+    {
+        const uint32_t blockEnd = std::min<uint32_t>(lastSlot, blockStart + UINT16_MAX - 1);
+        BlockHeader header{};
+        header.magic = BLOCK_MAGIC;
+        header.firstSlot = blockStart;
+        header.count = static_cast<uint16_t>(blockEnd - blockStart + 1);
+        header.slotSeconds = static_cast<uint16_t>(slotLength);
+        for (uint32_t slot = blockStart; slot <= blockEnd; ++slot)
+        {
+            const ClimateSample &sample = ring[slot % capacity];
+            header.crc = crc32Update(header.crc, reinterpret_cast<const uint8_t *>(&sample), sizeof(sample));
+        }
+        ok = f.write(reinterpret_cast<const uint8_t *>(&header), sizeof(header)) == sizeof(header);
+        for (uint32_t slot = blockStart; ok && slot <= blockEnd; ++slot)
+        {
+            ok = f.write(reinterpret_cast<const uint8_t *>(&ring[slot % capacity]), sizeof(ClimateSample)) ==
+                 sizeof(ClimateSample);
+        }
+    }
+    f.close();
+    return ok;
+}
+
+bool ClimateHistory::compact(fs::FS &fs, const char *path)
+{
+    // Same side-file swap as the snapshot; load() recovers a swap cut short.
+    const String tempPath = String(path) + ".tmp";
+    fs.remove(tempPath);
+    const uint32_t oldest = newest >= capacity ? newest - capacity + 1 : 1;
+    if (!appendBlock(fs, tempPath.c_str(), oldest, newest))
+    {
+        fs.remove(tempPath);
+        return false;
+    }
+    if (!commitSideFile(fs, tempPath, path))
+    {
+        return false;
+    }
+    Serial.printf("[Climate] Compacted %s to one window.\n", path);
+    return true;
+}
+
+bool ClimateHistory::flush(fs::FS &fs, const char *path)
+{
+    if (ring == nullptr || newest == 0 || newest <= flushedThrough)
+    {
+        return true;
+    }
+    const uint32_t oldest = newest >= capacity ? newest - capacity + 1 : 1;
+    const uint32_t first = std::max(flushedThrough + 1, oldest);
+    if (newest - first + 1 < FLUSH_BLOCK_SAMPLES)
+    {
+        return true;
+    }
+
+    bool ok = false;
+    File existing = fs.open(path, FILE_READ);
+    const size_t logBytes = existing ? existing.size() : 0;
+    if (existing)
+    {
+        existing.close();
+    }
+    if (logBytes > 2 * capacity * sizeof(ClimateSample))
+    {
+        // Compaction rewrites the log from the ring, so the ring must hold the log first.
+        if (!replayed)
+        {
+            load(fs, path);
+        }
+        ok = replayed ? compact(fs, path) : appendBlock(fs, path, first, newest);
+    }
+    else
+    {
+        ok = appendBlock(fs, path, first, newest);
+    }
+    if (ok)
+    {
+        flushedThrough = newest;
+        retainPending();
+    }
+    return ok;
+}
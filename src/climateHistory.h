@@ -0,0 +1,73 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+
+// One indoor reading in fixed point: hundredths of a degree Fahrenheit and
+// tenths of a percent RH. An empty slot has `deciPercent == CLIMATE_NO_SAMPLE`.
+struct ClimateSample
+{
+    int16_t centiF;
+    uint16_t deciPercent;
+};
+constexpr uint16_t CLIMATE_NO_SAMPLE = 0xFFFF;
+
+// Range and mean of the samples in a window, still in fixed point.
+struct ClimateStats
+{
+    size_t count{0};
+    int16_t minCentiF{0};
+    int16_t maxCentiF{0};
+    int32_t avgCentiF{0};
+    uint16_t minDeciPercent{0};
+    uint16_t maxDeciPercent{0};
+    uint32_t avgDeciPercent{0};
+};
+
+// Seven days of indoor readings in a PSRAM ring. Time is implicit: the ring is
+// indexed by slot number (epoch / slotSeconds), so a reading costs four bytes
+// and slots the device slept through or was off for simply stay empty.
+//
+// New samples are appended to an SD log in blocks, each a 16-byte header
+//   uint32 magic 'ICLB' | uint32 first slot | uint16 count | uint16 slotSeconds | uint32 CRC-32
+// followed by `count` ClimateSamples for consecutive slots. Samples not yet in
+// the log are mirrored into RTC memory, so deep sleep neither loses them nor
+// forces a short block out. load() replays the log; the log is rewritten as a
+// single block once it holds about two windows' worth.
+class ClimateHistory
+{
+public:
+    static constexpr uint32_t WINDOW_SECONDS = 7UL * 24UL * 60UL * 60UL;
+    // Pending samples written to SD as one block.
+    static constexpr size_t FLUSH_BLOCK_SAMPLES = 36;
+
+    // Allocates the ring for one reading per `slotSeconds` (60 s to 1 h) and
+    // restores the samples still pending from before a deep sleep.
+    bool begin(uint32_t slotSeconds);
+    void record(time_t epoch, float temperatureF, float humidity);
+    // Replays the SD log into the ring; blocks for another slot size are skipped.
+    // Until then the ring holds only the samples recorded since begin().
+    bool load(fs::FS &fs, const char *path);
+    bool loaded() const { return replayed; }
+    // Appends the pending samples once they fill a block.
+    bool flush(fs::FS &fs, const char *path);
+
+    uint32_t slotSeconds() const { return slotLength; }
+    uint32_t slotFor(time_t epoch) const { return static_cast<uint32_t>(epoch / slotLength); }
+    // The reading stored for `slot`, or false if it is empty or has left the ring.
+    bool at(uint32_t slot, ClimateSample &sample) const;
+    ClimateStats stats(uint32_t firstSlot, uint32_t lastSlot) const;
+
+private:
+    void store(uint32_t slot, ClimateSample sample);
+    bool appendBlock(fs::FS &fs, const char *path, uint32_t firstSlot, uint32_t lastSlot);
+    bool compact(fs::FS &fs, const char *path);
+    void retainPending() const;
+
+    ClimateSample *ring{nullptr};
+    size_t capacity{0};
+    uint32_t slotLength{0};
+    uint32_t newest{0};         // highest slot stored; 0 while empty
+    uint32_t flushedThrough{0}; // highest slot already in the SD log
+    bool replayed{false};
+};
@@ -0,0 +1,448 @@
+#include "connectionPool.h"
+
+#include <WiFi.h>
+#include <type_traits>
+
+#include "hal.h"
+
+namespace
+{
+constexpr size_t DNS_CACHE_ENTRIES = 4;
+constexpr size_t DNS_HOST_LENGTH = 48;
+// lwIP does not report record TTLs; addresses are re-resolved after this or on a failed connect.
+constexpr time_t DNS_CACHE_TTL_SECONDS = 12 * 60 * 60;
+constexpr uint32_t DNS_CACHE_MAGIC = 0x444E5343; // "DNSC"
+
+struct DnsCacheEntry
+{
+    char host[DNS_HOST_LENGTH];
+    uint32_t address;
+    time_t resolvedAt;
+};
+
+struct DnsCache
+{
+    uint32_t magic;
+    DnsCacheEntry entries[DNS_CACHE_ENTRIES];
+    uint8_t next;
+};
+
+static_assert(std::is_trivially_copyable<DnsCache>::value, "DnsCache is kept as raw bytes in RTC memory");
+
+// A cold boot zeroes it; findCachedHost() resets it on the missing magic.
+RTC_DATA_ATTR DnsCache dnsCache;
+
+DnsCacheEntry *findCachedHost(const char *host)
+{
+    if (dnsCache.magic != DNS_CACHE_MAGIC)
+    {
+        memset(&dnsCache, 0, sizeof(dnsCache));
+        dnsCache.magic = DNS_CACHE_MAGIC;
+    }
+    for (DnsCacheEntry &entry : dnsCache.entries)
+    {
+        if (entry.address != 0 && strncmp(entry.host, host, DNS_HOST_LENGTH) == 0)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool lookupCachedHost(const char *host, IPAddress &address)
+{
+    const DnsCacheEntry *entry = findCachedHost(host);
+    if (entry == nullptr)
+    {
+        return false;
+    }
+    const time_t age = halEpochNow() - entry->resolvedAt;
+    if (age < 0 || age > DNS_CACHE_TTL_SECONDS)
+    {
+        return false;
+    }
+    address = IPAddress(entry->address);
+    return true;
+}
+
+void storeCachedHost(const char *host, const IPAddress &address)
+{
+    if (strlen(host) >= DNS_HOST_LENGTH)
+    {
+        return;
+    }
+    DnsCacheEntry *entry = findCachedHost(host);
+    if (entry == nullptr)
+    {
+        entry = &dnsCache.entries[dnsCache.next];
+        dnsCache.next = (dnsCache.next + 1) % DNS_CACHE_ENTRIES;
+    }
+    snprintf(entry->host, sizeof(entry->host), "%s", host);
+    entry->address = static_cast<uint32_t>(address);
+    entry->resolvedAt = halEpochNow();
+}
+
+void forgetCachedHost(const char *host)
+{
+    DnsCacheEntry *entry = findCachedHost(host);
+    if (entry != nullptr)
+    {
+        entry->address = 0;
+    }
+}
+
+// Splits "https://host[:port]/path" into its connection parameters.
+bool parseOrigin(const String &url, String &host, uint16_t &port, bool &secure)
+{
+    const int schemeEnd = url.indexOf("://");
+    if (schemeEnd <= 0)
+    {
+        return false;
+    }
+    secure = url.startsWith("https");
+    const int hostStart = schemeEnd + 3;
+    int hostEnd = url.indexOf('/', hostStart);
+    if (hostEnd < 0)
+    {
+        hostEnd = url.length();
+    }
+    host = url.substring(hostStart, hostEnd);
+    port = secure ? 443 : 80;
+    const int colon = host.indexOf(':');
+    if (colon >= 0)
+    {
+        port = static_cast<uint16_t>(host.substring(colon + 1).toInt());
+        host = host.substring(0, colon);
+    }
+    return host.length() > 0;
+}
+} // namespace
+
+void RequestTimings::log(const char *label) const
+{
+    Serial.printf("[Net] %s: dns %lu ms%s, connect%s %lu ms%s, first byte %lu ms, transfer %lu ms\n", label,
+                  (unsigned long)dnsMs, dnsCached ? " (cached)" : "", secure ? "+tls" : "", (unsigned long)connectMs,
+                  reused ? " (reused)" : "", (unsigned long)firstByteMs, (unsigned long)transferMs);
+}
+
+// -------- ConnectionPool --------
+ConnectionPool::Slot *ConnectionPool::slotFor(const String &host, uint16_t port, bool secure)
+{
+    for (Slot &slot : slots)
+    {
+        if (slot.port == port && slot.secure == secure && slot.host == host)
+        {
+            return &slot;
+        }
+    }
+    for (Slot &slot : slots)
+    {
+        if (slot.port == 0)
+        {
+            return &slot;
+        }
+    }
+    Slot &evicted = slots[nextEviction];
+    nextEviction = (nextEviction + 1) % MAX_HOSTS;
+    evicted.client().stop();
+    evicted.port = 0;
+    return &evicted;
+}
+
+bool ConnectionPool::connect(Slot &slot, RequestTimings &timings)
+{
+    IPAddress address;
+    timings.dnsCached = lookupCachedHost(slot.host.c_str(), address);
+    for (int attempt = 0; attempt < 2; ++attempt)
+    {
+        if (!timings.dnsCached)
+        {
+            const uint32_t dnsStart = millis();
+            if (WiFi.hostByName(slot.host.c_str(), address) != 1)
+            {
+                Serial.printf("[Net] DNS lookup failed for %s\n", slot.host.c_str());
+                return false;
+            }
+            timings.dnsMs = millis() - dnsStart;
+            storeCachedHost(slot.host.c_str(), address);
+        }
+
+        const uint32_t connectStart = millis();
+        int connected = 0;
+        if (slot.secure)
+        {
+            slot.secureClient.setInsecure();
+            // Connecting by address with the host name keeps SNI intact.
+            connected = slot.secureClient.connect(address, slot.port, slot.host.c_str(), nullptr, nullptr, nullptr);
+        }
+        else
+        {
+            connected = slot.plainClient.connect(address, slot.port);
+        }
+        timings.connectMs = millis() - connectStart;
+        if (connected)
+        {
+            return true;
+        }
+        if (!timings.dnsCached)
+        {
+            break;
+        }
+        // The cached address may be stale; resolve again once.
+        Serial.printf("[Net] Connect to cached %s failed; resolving again.\n", slot.host.c_str());
+        forgetCachedHost(slot.host.c_str());
+        timings.dnsCached = false;
+    }
+    Serial.printf("[Net] Connect to %s:%u failed\n", slot.host.c_str(), slot.port);
+    return false;
+}
+
+HTTPClient *ConnectionPool::begin(const String &url, RequestTimings &timings)
+{
+    timings = RequestTimings();
+    String host;
+    uint16_t port = 0;
+    bool secure = false;
+    if (!parseOrigin(url, host, port, secure))
+    {
+        return nullptr;
+    }
+
+    Slot &slot = *slotFor(host, port, secure);
+    slot.host = host;
+    slot.port = port;
+    slot.secure = secure;
+    timings.secure = secure;
+    timings.reused = slot.client().connected();
+    if (!timings.reused && !connect(slot, timings))
+    {
+        slot.port = 0;
+        return nullptr;
+    }
+
+    slot.http.setReuse(true);
+    slot.http.useHTTP10(false);
+    if (!slot.http.begin(slot.client(), url))
+    {
+        slot.client().stop();
+        slot.port = 0;
+        return nullptr;
+    }
+    return &slot.http;
+}
+
+void ConnectionPool::end(HTTPClient *http, bool reusable)
+{
+    if (http == nullptr)
+    {
+        return;
+    }
+    for (Slot &slot : slots)
+    {
+        if (&slot.http != http)
+        {
+            continue;
+        }
+        http->end();
+        if (!reusable)
+        {
+            slot.client().stop();
+        }
+        if (!slot.client().connected())
+        {
+            slot.port = 0;
+        }
+        return;
+    }
+}
+
+void ConnectionPool::closeAll()
+{
+    for (Slot &slot : slots)
+    {
+        if (slot.port != 0)
+        {
+            slot.http.end();
+            slot.client().stop();
+            slot.port = 0;
+        }
+    }
+}
+
+// -------- HttpBodyStream --------
+HttpBodyStream::HttpBodyStream(Stream &source, int contentLength, bool chunked)
+    : source(source), chunked(chunked), lengthKnown(chunked || contentLength >= 0),
+      remaining(chunked ? 0 : contentLength)
+{
+    if (!chunked && contentLength == 0)
+    {
+        finished = true;
+    }
+}
+
+int HttpBodyStream::rawRead()
+{
+    const uint32_t start = millis();
+    do
+    {
+        const int c = source.read();
+        if (c >= 0)
+        {
+            return c;
+        }
+        delay(1);
+    } while (millis() - start < READ_TIMEOUT_MS);
+    return -1;
+}
+
+bool HttpBodyStream::readLine(char *line, size_t size)
+{
+    size_t length = 0;
+    while (true)
+    {
+        const int c = rawRead();
+        if (c < 0)
+        {
+            return false;
+        }
+        if (c == '\n')
+        {
+            break;
+        }
+        if (c != '\r' && length + 1 < size)
+        {
+            line[length++] = static_cast<char>(c);
+        }
+    }
+    line[length] = '\0';
+    return true;
+}
+
+// Reads a chunk-size line; a zero-size chunk ends the body after its trailers.
+bool HttpBodyStream::beginChunk()
+{
+    char line[32];
+    if (!readLine(line, sizeof(line)))
+    {
+        return false;
+    }
+    remaining = strtol(line, nullptr, 16);
+    if (remaining > 0)
+    {
+        return true;
+    }
+    while (readLine(line, sizeof(line)) && line[0] != '\0')
+    {
+    }
+    finished = true;
+    return false;
+}
+
+int HttpBodyStream::read()
+{
+    if (peeked >= 0)
+    {
+        const int c = peeked;
+        peeked = -1;
+        return c;
+    }
+    if (finished)
+    {
+        return -1;
+    }
+    if (chunked && remaining == 0 && !beginChunk())
+    {
+        finished = true;
+        return -1;
+    }
+    const int c = rawRead();
+    if (c < 0)
+    {
+        finished = true;
+        return -1;
+    }
+    if (lengthKnown && --remaining == 0)
+    {
+        if (!chunked)
+        {
+            finished = true;
+        }
+        else
+        {
+            char crlf[4];
+            readLine(crlf, sizeof(crlf)); // CRLF closing the chunk data
+        }
+    }
+    return c;
+}
+
+int HttpBodyStream::peek()
+{
+    if (peeked < 0)
+    {
+        peeked = read();
+    }
+    return peeked;
+}
+
+int HttpBodyStream::available()
+{
+    if (peeked >= 0)
+    {
+        return 1;
+    }
+    return finished ? 0 : source.available();
+}
+
+size_t HttpBodyStream::readBytes(char *buffer, size_t length)
+{
+    size_t n = 0;
+    if (n < length && peeked >= 0)
+    {
+        buffer[n++] = static_cast<char>(read());
+    }
+    // Plain bodies can be copied in bulk; chunk framing needs the byte path.
+    while (n < length && !finished && !chunked)
+    {
+        size_t want = length - n;
+        if (lengthKnown && static_cast<int64_t>(want) > remaining)
+        {
+            want = static_cast<size_t>(remaining);
+        }
+        const size_t got = source.readBytes(buffer + n, want);
+        if (got == 0)
+        {
+            finished = true;
+            break;
+        }
+        n += got;
+        if (lengthKnown && (remaining -= got) == 0)
+        {
+            finished = true;
+        }
+    }
+    while (n < length)
+    {
+        const int c = read();
+        if (c < 0)
+        {
+            break;
+        }
+        buffer[n++] = static_cast<char>(c);
+    }
+    return n;
+}
+
+bool HttpBodyStream::drain(size_t limit)
+{
+    if (!lengthKnown)
+    {
+        return false;
+    }
+    size_t discarded = 0;
+    while (!finished && discarded < limit && read() >= 0)
+    {
+        ++discarded;
+    }
+    return finished && peeked < 0;
+}
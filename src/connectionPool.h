@@ -0,0 +1,90 @@
+#pragma once
+
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+
+// Where the time of one request went. `connectMs` covers the TCP connect and,
+// for HTTPS, the TLS handshake. The two cannot be timed apart: the core's
+// WiFiClientSecure::connect() opens the socket and runs the handshake in one
+// call and has no plain-start mode, so `secure` marks which numbers include it.
+struct RequestTimings
+{
+    uint32_t dnsMs{0};
+    uint32_t connectMs{0};
+    uint32_t firstByteMs{0};
+    uint32_t transferMs{0};
+    bool dnsCached{false};
+    bool reused{false};
+    bool secure{false};
+
+    void log(const char *label) const;
+};
+
+// Keeps one keep-alive connection per host for the length of a fetch window,
+// and remembers resolved addresses in RTC memory so later wakes skip DNS.
+class ConnectionPool
+{
+public:
+    static constexpr size_t MAX_HOSTS = 2;
+
+    // Returns an HTTPClient bound to a live connection to the URL's host (reusing
+    // the open one when possible), or nullptr if it could not connect.
+    HTTPClient *begin(const String &url, RequestTimings &timings);
+    // Finishes the request. The connection stays open only if `reusable` (the
+    // whole body was consumed) and the server agreed to keep it alive.
+    void end(HTTPClient *http, bool reusable);
+    void closeAll();
+
+private:
+    struct Slot
+    {
+        String host;
+        uint16_t port{0};
+        bool secure{false};
+        WiFiClientSecure secureClient;
+        WiFiClient plainClient;
+        HTTPClient http;
+
+        WiFiClient &client() { return secure ? static_cast<WiFiClient &>(secureClient) : plainClient; }
+    };
+
+    Slot *slotFor(const String &host, uint16_t port, bool secure);
+    bool connect(Slot &slot, RequestTimings &timings);
+
+    Slot slots[MAX_HOSTS];
+    size_t nextEviction{0};
+};
+
+// Response body reader that understands Content-Length and chunked transfer
+// encoding, so a kept-alive connection can be left exactly at the end of the
+// body. With neither, the body runs until the server closes.
+class HttpBodyStream : public Stream
+{
+public:
+    HttpBodyStream(Stream &source, int contentLength, bool chunked);
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t readBytes(char *buffer, size_t length) override;
+    size_t write(uint8_t) override { return 0; }
+
+    // Reads and discards the rest of the body (at most `limit` bytes). Returns
+    // true if the end of the body was reached, i.e. the connection is reusable.
+    bool drain(size_t limit);
+
+private:
+    static constexpr uint32_t READ_TIMEOUT_MS = 5000;
+
+    int rawRead();
+    bool readLine(char *line, size_t size);
+    bool beginChunk();
+
+    Stream &source;
+    const bool chunked;
+    const bool lengthKnown;
+    int64_t remaining; // bytes left in the body (or the current chunk)
+    bool finished{false};
+    int peeked{-1};
+};
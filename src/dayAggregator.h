@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+#include "forecastTimeline.h"
+#include "weatherSnapshot.h"
+
+// Folds 3-hourly /forecast entries into daily summaries for up to `MaxDays`
+// days after the current, partial one. Storage is a fixed array sized by the
+// template argument; how many of those days are filled is chosen at runtime.
+//
+// Entries are bucketed by local calendar day arithmetically, so each costs a
+// division and a histogram increment. A day's condition is the class with the
+// largest weight, where entries between 06:00 and 18:00 count three times as
+// much as night ones: a clear night no longer stands in for a rainy day. Ties
+// go to the higher ConditionClass, i.e. towards precipitation.
+//
+// /forecast ends five days after the current hour, so the last day can hold
+// only its early entries. A day whose entries do not span the daytime (one
+// before 09:00 and one from 15:00 on) is left empty rather than summarised
+// from a few night hours.
+template <size_t MaxDays>
+class DayAggregator
+{
+public:
+    static constexpr int DAYTIME_WEIGHT = 3;
+    static constexpr int NIGHT_WEIGHT = 1;
+
+    explicit DayAggregator(size_t dayCount) : limit(dayCount < MaxDays ? dayCount : MaxDays) {}
+
+    // `localTime` is the entry's time shifted to the location's UTC offset.
+    // The first entry fixes "today". `description` must stay valid until finish().
+    void add(time_t localTime, float temperature, int owmId, const char *description)
+    {
+        const long dayNumber = static_cast<long>(localTime / SECONDS_PER_DAY);
+        if (!started)
+        {
+            firstDay = dayNumber;
+            started = true;
+        }
+        const long index = dayNumber - firstDay - 1;
+        if (index < 0 || index >= static_cast<long>(limit))
+        {
+            return;
+        }
+
+        Day &day = days[index];
+        if (day.entries++ == 0)
+        {
+            day.timestamp = localTime;
+        }
+        if (!std::isnan(temperature))
+        {
+            day.minTemperature = std::isnan(day.minTemperature) ? temperature : std::fmin(day.minTemperature, temperature);
+            day.maxTemperature = std::isnan(day.maxTemperature) ? temperature : std::fmax(day.maxTemperature, temperature);
+        }
+
+        const uint8_t cls = static_cast<uint8_t>(conditionClassForOwmId(owmId));
+        const int hour = static_cast<int>(localTime % SECONDS_PER_DAY) / 3600;
+        day.earliestHour = hour < day.earliestHour ? hour : day.earliestHour;
+        day.latestHour = hour > day.latestHour ? hour : day.latestHour;
+        const bool daytime = hour >= 6 && hour < 18;
+        if (daytime)
+        {
+            day.dayWeights[cls] += DAYTIME_WEIGHT;
+        }
+        else
+        {
+            day.nightWeights[cls] += NIGHT_WEIGHT;
+        }
+        // Keep the first description of each class, preferring a daytime one.
+        const uint16_t bit = static_cast<uint16_t>(1U << cls);
+        if (day.owmIds[cls] == 0 || (daytime && (day.daytimeSeen & bit) == 0))
+        {
+            day.owmIds[cls] = owmId;
+            day.descriptions[cls] = description;
+        }
+        if (daytime)
+        {
+            day.daytimeSeen |= bit;
+        }
+    }
+
+    // Writes one summary per configured day to `out`; days without entries, or
+    // without the whole daytime, stay empty.
+    void finish(DailyForecast *out) const
+    {
+        for (size_t i = 0; i < limit; ++i)
+        {
+            const Day &day = days[i];
+            DailyForecast &forecast = out[i];
+            forecast = DailyForecast();
+            if (day.entries == 0 || day.earliestHour >= 9 || day.latestHour < 15)
+            {
+                continue;
+            }
+            forecast.timestamp = day.timestamp;
+            forecast.minTemperature = day.minTemperature;
+            forecast.maxTemperature = day.maxTemperature;
+
+            const uint8_t dominant = strongest(day.dayWeights, day.nightWeights);
+            forecast.iconId = day.owmIds[dominant];
+            snprintf(forecast.summary, sizeof(forecast.summary), "%s",
+                     day.descriptions[dominant] != nullptr ? day.descriptions[dominant] : "");
+            snprintf(forecast.iconCode, sizeof(forecast.iconCode), "%s", iconCodeForCondition(dominant));
+
+            static const uint16_t NO_WEIGHTS[CLASS_COUNT] = {};
+            const uint8_t night = strongest(NO_WEIGHTS, day.nightWeights);
+            if (night != 0)
+            {
+                snprintf(forecast.nightIconCode, sizeof(forecast.nightIconCode), "%s",
+                         iconCodeForCondition(night | CONDITION_NIGHT_FLAG));
+            }
+        }
+    }
+
+    size_t size() const { return limit; }
+
+private:
+    static constexpr time_t SECONDS_PER_DAY = 24 * 60 * 60;
+    static constexpr size_t CLASS_COUNT = static_cast<size_t>(ConditionClass::Fog) + 1;
+
+    struct Day
+    {
+        time_t timestamp{};
+        float minTemperature{NAN};
+        float maxTemperature{NAN};
+        uint16_t entries{0};
+        int earliestHour{24}; // local hours of the first and last entry
+        int latestHour{-1};
+        uint16_t daytimeSeen{0}; // bit per class
+        uint16_t dayWeights[CLASS_COUNT]{};
+        uint16_t nightWeights[CLASS_COUNT]{};
+        int owmIds[CLASS_COUNT]{};
+        const char *descriptions[CLASS_COUNT]{};
+    };
+
+    // Class with the most combined weight, Unknown only if nothing else was seen.
+    static uint8_t strongest(const uint16_t *dayWeights, const uint16_t *nightWeights)
+    {
+        uint8_t best = 0;
+        int bestWeight = 0;
+        for (size_t cls = 1; cls < CLASS_COUNT; ++cls)
+        {
+            const int weight = dayWeights[cls] + nightWeights[cls];
+            if (weight > 0 && weight >= bestWeight)
+            {
+                best = static_cast<uint8_t>(cls);
+                bestWeight = weight;
+            }
+        }
+        return best;
+    }
+
+    Day days[MaxDays];
+    size_t limit;
+    long firstDay{0};
+    bool started{false};
+};
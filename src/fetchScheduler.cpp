@@ -0,0 +1,79 @@
+#include "fetchScheduler.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+constexpr time_t BUDGET_WINDOW_SECONDS = 60 * 60;
+
+struct Backoff
+{
+    time_t baseSeconds;
+    time_t maxSeconds;
+};
+
+// Indexed by FetchFailure - 1.
+constexpr Backoff BACKOFF[] = {
+    {60, 60 * 60},          // WiFi: AP reboots and DHCP hiccups are short
+    {2 * 60, 2 * 60 * 60},  // Http: server or quota trouble
+    {15 * 60, 6 * 60 * 60}, // Parse: likely to repeat until the API changes back
+};
+} // namespace
+
+time_t FetchScheduler::budgetResumeAt() const
+{
+    // Once the hour's budget is spent, nothing starts before the window rolls over.
+    return budgetUsedMs >= RADIO_BUDGET_MS_PER_HOUR ? budgetWindowStart + BUDGET_WINDOW_SECONDS : 0;
+}
+
+time_t FetchScheduler::nextAttempt(time_t lastSuccess, time_t interval) const
+{
+    const time_t due = failure == FetchFailure::None ? lastSuccess + interval : retryEpoch;
+    return std::max(due, budgetResumeAt());
+}
+
+void FetchScheduler::recordSuccess()
+{
+    failure = FetchFailure::None;
+    std::fill(std::begin(streaks), std::end(streaks), 0);
+    retryEpoch = 0;
+}
+
+time_t FetchScheduler::recordFailure(FetchFailure kind, time_t now, uint32_t jitter)
+{
+    if (kind == FetchFailure::None)
+    {
+        return 0;
+    }
+    const int index = static_cast<int>(kind) - 1;
+    const Backoff &backoff = BACKOFF[index];
+    const uint8_t streak = streaks[index];
+    if (streak < UINT8_MAX)
+    {
+        ++streaks[index];
+    }
+
+    time_t delay = backoff.baseSeconds;
+    for (uint8_t i = 0; i < streak && delay < backoff.maxSeconds; ++i)
+    {
+        delay *= 2;
+    }
+    delay = std::min(delay, backoff.maxSeconds);
+    // 80..120% so a houseful of devices does not retry in lockstep.
+    delay = delay * static_cast<time_t>(80 + jitter % 41) / 100;
+
+    failure = kind;
+    retryEpoch = now + delay;
+    return delay;
+}
+
+void FetchScheduler::chargeRadio(time_t now, uint32_t radioMs)
+{
+    if (budgetWindowStart == 0 || now < budgetWindowStart || now - budgetWindowStart >= BUDGET_WINDOW_SECONDS)
+    {
+        budgetWindowStart = now;
+        budgetUsedMs = 0;
+    }
+    budgetUsedMs += radioMs;
+}
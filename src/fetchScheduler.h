@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+// Why a weather update failed. Each class backs off on its own curve: a dead
+// access point clears up sooner than a rejected key or a malformed response.
+enum class FetchFailure : uint8_t
+{
+    None,
+    WiFi,  // association or DHCP never completed
+    Http,  // no answer, or a non-200 status
+    Parse, // a 200 whose body could not be used
+};
+
+// Decides when the next weather fetch may start. On success the regular
+// interval applies; after a failure the next attempt waits an exponentially
+// growing, jittered delay for that failure class. Independently, radio-on time
+// is capped per hour so an unreachable network cannot drain the battery.
+class FetchScheduler
+{
+public:
+    static constexpr uint32_t RADIO_BUDGET_MS_PER_HOUR = 3UL * 60UL * 1000UL;
+
+    // Earliest epoch at which a fetch may start, given the last success.
+    time_t nextAttempt(time_t lastSuccess, time_t interval) const;
+    void recordSuccess();
+    // Schedules the retry and returns its delay in seconds. `jitter` is any
+    // random value; it spreads the delay by up to +/-20%.
+    time_t recordFailure(FetchFailure kind, time_t now, uint32_t jitter);
+    // Adds radio-on time to the current one-hour window.
+    void chargeRadio(time_t now, uint32_t radioMs);
+
+    FetchFailure lastFailure() const { return failure; }
+    time_t retryAt() const { return retryEpoch; }
+
+private:
+    static constexpr int CLASS_COUNT = 3;
+
+    time_t budgetResumeAt() const;
+
+    FetchFailure failure{FetchFailure::None};
+    uint8_t streaks[CLASS_COUNT]{};
+    time_t retryEpoch{0};
+    time_t budgetWindowStart{0};
+    uint32_t budgetUsedMs{0};
+};
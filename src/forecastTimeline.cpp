@@ -0,0 +1,64 @@
+#include "forecastTimeline.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+// Indexed by ConditionClass; day and night variants of each OWM icon.
+constexpr const char *ICON_CODES[][2] = {
+    {"", ""},       {"01d", "01n"}, {"02d", "02n"}, {"03d", "03n"}, {"04d", "04n"},
+    {"09d", "09n"}, {"10d", "10n"}, {"11d", "11n"}, {"13d", "13n"}, {"50d", "50n"},
+};
+} // namespace
+
+ConditionClass conditionClassForOwmId(int id)
+{
+    if (id >= 200 && id < 300) return ConditionClass::Thunder;
+    if (id >= 300 && id < 400) return ConditionClass::Showers;
+    if (id == 511) return ConditionClass::Snow;
+    if (id >= 500 && id < 520) return ConditionClass::Rain;
+    if (id >= 520 && id < 600) return ConditionClass::Showers;
+    if (id >= 600 && id < 700) return ConditionClass::Snow;
+    if (id >= 700 && id < 800) return ConditionClass::Fog;
+    if (id == 800) return ConditionClass::Clear;
+    if (id == 801) return ConditionClass::FewClouds;
+    if (id == 802) return ConditionClass::Scattered;
+    if (id == 803 || id == 804) return ConditionClass::Clouds;
+    return ConditionClass::Unknown;
+}
+
+const char *iconCodeForCondition(uint8_t condition)
+{
+    const uint8_t cls = condition & ~CONDITION_NIGHT_FLAG;
+    if (cls >= sizeof(ICON_CODES) / sizeof(ICON_CODES[0]))
+    {
+        return "";
+    }
+    return ICON_CODES[cls][(condition & CONDITION_NIGHT_FLAG) != 0 ? 1 : 0];
+}
+
+bool ForecastTimeline::append(time_t localTime, float temperature, int owmId, const char *iconCode, float pop)
+{
+    if (count >= TIMELINE_MAX_POINTS)
+    {
+        return false;
+    }
+    if (count == 0)
+    {
+        start = localTime;
+    }
+    const time_t offset = (localTime - start) / 60;
+    if (offset < 0 || offset > UINT16_MAX)
+    {
+        return false;
+    }
+    offsetMinutes[count] = static_cast<uint16_t>(offset);
+    centiDegrees[count] = std::isnan(temperature) ? INT16_MIN
+                                                  : static_cast<int16_t>(std::lround(std::fmax(-320.0F, std::fmin(320.0F, temperature)) * 100.0F));
+    const bool night = iconCode != nullptr && strlen(iconCode) >= 3 && iconCode[2] == 'n';
+    condition[count] = static_cast<uint8_t>(conditionClassForOwmId(owmId)) | (night ? CONDITION_NIGHT_FLAG : 0);
+    precipPercent[count] = std::isnan(pop) ? 0 : static_cast<uint8_t>(std::lround(std::fmax(0.0F, std::fmin(1.0F, pop)) * 100.0F));
+    ++count;
+    return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+// Coarse sky condition, one per OWM icon family ("01".."50").
+enum class ConditionClass : uint8_t
+{
+    Unknown,
+    Clear,     // 800
+    FewClouds, // 801
+    Scattered, // 802
+    Clouds,    // 803-804
+    Showers,   // 3xx, 520-531
+    Rain,      // 500-504
+    Thunder,   // 2xx
+    Snow,      // 511, 6xx
+    Fog,       // 7xx
+};
+// Set in a `condition` byte for points between sunset and sunrise.
+constexpr uint8_t CONDITION_NIGHT_FLAG = 0x80;
+
+// Every forecast point of the last fetch: 3-hourly /forecast entries (up to
+// 120 h) or One Call hourly entries (48 h). Stored as parallel arrays of small
+// fixed-point fields so the whole series is a few hundred bytes of POD that
+// travels inside WeatherSnapshot.
+constexpr size_t TIMELINE_MAX_POINTS = 48;
+
+struct ForecastTimeline
+{
+    time_t start{};  // local time of point 0
+    uint8_t count{0};
+    uint16_t offsetMinutes[TIMELINE_MAX_POINTS]{}; // from `start`
+    int16_t centiDegrees[TIMELINE_MAX_POINTS]{};   // configured units; INT16_MIN if missing
+    uint8_t condition[TIMELINE_MAX_POINTS]{};      // ConditionClass | CONDITION_NIGHT_FLAG
+    uint8_t precipPercent[TIMELINE_MAX_POINTS]{};  // probability of precipitation
+
+    // Appends a point; returns false once full or if `localTime` is out of range.
+    bool append(time_t localTime, float temperature, int owmId, const char *iconCode, float pop);
+    time_t timeAt(size_t index) const { return start + static_cast<time_t>(offsetMinutes[index]) * 60; }
+};
+
+ConditionClass conditionClassForOwmId(int id);
+// OWM icon code ("10d") for a stored condition byte; empty for Unknown.
+const char *iconCodeForCondition(uint8_t condition);
@@ -0,0 +1,122 @@
+#include "frameDiff.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+constexpr uint16_t BAND_HEIGHT = 16;
+
+uint32_t rectArea(const DirtyRect &rect)
+{
+    return static_cast<uint32_t>(rect.w) * rect.h;
+}
+
+DirtyRect rectUnion(const DirtyRect &a, const DirtyRect &b)
+{
+    const uint16_t left = std::min(a.x, b.x);
+    const uint16_t top = std::min(a.y, b.y);
+    const uint16_t right = std::max<uint16_t>(a.x + a.w, b.x + b.w);
+    const uint16_t bottom = std::max<uint16_t>(a.y + a.h, b.y + b.h);
+    return DirtyRect{left, top, static_cast<uint16_t>(right - left), static_cast<uint16_t>(bottom - top)};
+}
+} // namespace
+
+size_t computeDirtyRects(const uint8_t *previous, const uint8_t *next, uint16_t width, uint16_t height,
+                         DirtyRect *out, size_t maxRects)
+{
+    const size_t stride = width / 2;
+    size_t count = 0;
+    bool overflowed = false;
+    bool anyChange = false;
+    DirtyRect bounds{};
+
+    for (uint16_t bandY = 0; bandY < height; bandY += BAND_HEIGHT)
+    {
+        const uint16_t bandEnd = std::min<uint16_t>(height, bandY + BAND_HEIGHT);
+        size_t minByte = stride;
+        size_t maxByte = 0;
+        uint16_t firstRow = bandEnd;
+        uint16_t lastRow = 0;
+
+        for (uint16_t row = bandY; row < bandEnd; ++row)
+        {
+            const uint8_t *a = previous + row * stride;
+            const uint8_t *b = next + row * stride;
+            if (memcmp(a, b, stride) == 0)
+            {
+                continue;
+            }
+            size_t left = 0;
+            while (a[left] == b[left])
+            {
+                ++left;
+            }
+            size_t right = stride - 1;
+            while (a[right] == b[right])
+            {
+                --right;
+            }
+            minByte = std::min(minByte, left);
+            maxByte = std::max(maxByte, right);
+            firstRow = std::min(firstRow, row);
+            lastRow = row;
+        }
+
+        if (firstRow == bandEnd)
+        {
+            continue;
+        }
+
+        const uint16_t left = static_cast<uint16_t>(minByte * 2) / FRAME_DIFF_ALIGN * FRAME_DIFF_ALIGN;
+        uint16_t right = static_cast<uint16_t>((maxByte + 1) * 2);
+        right = std::min<uint16_t>(width, (right + FRAME_DIFF_ALIGN - 1) / FRAME_DIFF_ALIGN * FRAME_DIFF_ALIGN);
+        const DirtyRect rect{left, firstRow, static_cast<uint16_t>(right - left),
+                             static_cast<uint16_t>(lastRow - firstRow + 1)};
+
+        bounds = anyChange ? rectUnion(bounds, rect) : rect;
+        anyChange = true;
+
+        if (count > 0)
+        {
+            // Fold into the previous rect when it ends within a band of this one
+            // and the union wastes at most a quarter more pixels than the pair.
+            DirtyRect &last = out[count - 1];
+            if (last.y + last.h + BAND_HEIGHT >= rect.y)
+            {
+                const DirtyRect merged = rectUnion(last, rect);
+                if (rectArea(merged) * 4 <= (rectArea(last) + rectArea(rect)) * 5)
+                {
+                    last = merged;
+                    continue;
+                }
+            }
+        }
+
+        if (count < maxRects)
+        {
+            out[count++] = rect;
+        }
+        else
+        {
+            overflowed = true;
+        }
+    }
+
+    if (overflowed)
+    {
+        out[0] = bounds;
+        return 1;
+    }
+    return count;
+}
+
+uint32_t dirtyArea(const DirtyRect *rects, size_t count)
+{
+    uint32_t total = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        total += rectArea(rects[i]);
+    }
+    return total;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Horizontal alignment (in pixels) of dirty rects. The IT8951 loads 4bpp image
+// data four pixels per word, so partial writes must start and end on that grid.
+constexpr uint16_t FRAME_DIFF_ALIGN = 4;
+
+// Region of the panel that changed between two frames.
+struct DirtyRect
+{
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+};
+
+// Compares two packed 4bpp frames (two pixels per byte, row-major, `width` a
+// multiple of FRAME_DIFF_ALIGN) and writes the changed regions to `out`.
+// Rows are scanned in bands; vertically adjacent bands are merged when that
+// barely grows the refreshed area. If more than `maxRects` regions remain,
+// a single bounding rect is returned instead. Returns the number of rects.
+size_t computeDirtyRects(const uint8_t *previous, const uint8_t *next, uint16_t width, uint16_t height,
+                         DirtyRect *out, size_t maxRects);
+
+// Total pixel count covered by `rects`.
+uint32_t dirtyArea(const DirtyRect *rects, size_t count);
@@ -0,0 +1,275 @@
+#include "glyphAtlas.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "snapshotStore.h"
+#include "utf8.h"
+
+namespace
+{
+constexpr uint32_t REPLACEMENT = '?';
+} // namespace
+
+bool GlyphAtlas::begin(fs::FS &fs, const char *path)
+{
+    sizeCount = 0;
+    if (!fs.exists(path))
+    {
+        return false;
+    }
+    File f = fs.open(path, FILE_READ);
+    if (!f)
+    {
+        return false;
+    }
+    GlyphAtlasHeader header{};
+    if (f.read(reinterpret_cast<uint8_t *>(&header), sizeof(header)) != sizeof(header) ||
+        header.magic != GLYPH_ATLAS_MAGIC || header.version != GLYPH_ATLAS_VERSION || header.sizeCount == 0 ||
+        header.sizeCount > MAX_SIZES)
+    {
+        Serial.printf("[Font] %s is not a glyph atlas this build can read.\n", path);
+        f.close();
+        return false;
+    }
+
+    // The metric tables of every size are small; keep them resident.
+    free(tables);
+    tables = static_cast<uint8_t *>(ps_malloc(header.tablesBytes));
+    const bool read = tables != nullptr && f.read(tables, header.tablesBytes) == header.tablesBytes;
+    f.close();
+    if (!read || crc32Update(0, tables, header.tablesBytes) != header.tablesCrc)
+    {
+        Serial.printf("[Font] %s failed its checksum; ignoring it.\n", path);
+        free(tables);
+        tables = nullptr;
+        return false;
+    }
+
+    // Offsets in the file are absolute; the tables start right after the header.
+    const auto *sizes = reinterpret_cast<const GlyphAtlasSize *>(tables);
+    for (size_t i = 0; i < header.sizeCount; ++i)
+    {
+        const GlyphAtlasSize &info = sizes[i];
+        const size_t glyphsAt = info.tablesOffset - sizeof(header);
+        const size_t kernsAt = glyphsAt + info.glyphCount * sizeof(GlyphAtlasGlyph);
+        if (info.tablesOffset < sizeof(header) ||
+            kernsAt + info.kernCount * sizeof(GlyphAtlasKern) > header.tablesBytes)
+        {
+            Serial.printf("[Font] %s has a truncated table; ignoring it.\n", path);
+            sizeCount = 0;
+            free(tables);
+            tables = nullptr;
+            return false;
+        }
+        Face &face = faces[sizeCount++];
+        free(face.bitmaps);
+        face.info = info;
+        face.glyphs = reinterpret_cast<const GlyphAtlasGlyph *>(tables + glyphsAt);
+        face.kerns = reinterpret_cast<const GlyphAtlasKern *>(tables + kernsAt);
+        face.bitmaps = nullptr;
+        face.bitmapsFailed = false;
+    }
+    this->fs = &fs;
+    this->path = path;
+    Serial.printf("[Font] Glyph atlas has %u size(s).\n", (unsigned)sizeCount);
+    return true;
+}
+
+const GlyphAtlas::Face *GlyphAtlas::find(uint16_t pixelSize) const
+{
+    for (size_t i = 0; i < sizeCount; ++i)
+    {
+        if (faces[i].info.pixelSize == pixelSize)
+        {
+            return &faces[i];
+        }
+    }
+    return nullptr;
+}
+
+const GlyphAtlasGlyph *GlyphAtlas::glyphFor(const Face &face, uint32_t codepoint) const
+{
+    const GlyphAtlasGlyph *end = face.glyphs + face.info.glyphCount;
+    const GlyphAtlasGlyph *it = std::lower_bound(face.glyphs, end, codepoint, [](const GlyphAtlasGlyph &glyph, uint32_t cp) {
+        return glyph.codepoint < cp;
+    });
+    return it != end && it->codepoint == codepoint ? it : nullptr;
+}
+
+int16_t GlyphAtlas::kerning(const Face &face, uint32_t left, uint32_t right) const
+{
+    if (face.info.kernCount == 0 || left > UINT16_MAX || right > UINT16_MAX)
+    {
+        return 0;
+    }
+    const uint32_t key = left << 16 | right;
+    const GlyphAtlasKern *end = face.kerns + face.info.kernCount;
+    const GlyphAtlasKern *it = std::lower_bound(face.kerns, end, key, [](const GlyphAtlasKern &kern, uint32_t k) {
+        return (static_cast<uint32_t>(kern.left) << 16 | kern.right) < k;
+    });
+    return it != end && it->left == left && it->right == right ? it->adjust : 0;
+}
+
+bool GlyphAtlas::loadBitmaps(Face &face)
+{
+    if (face.bitmaps != nullptr)
+    {
+        return true;
+    }
+    if (face.bitmapsFailed || fs == nullptr)
+    {
+        return false;
+    }
+    face.bitmapsFailed = true;
+    face.bitmaps = static_cast<uint8_t *>(ps_malloc(face.info.bitmapBytes));
+    if (face.bitmaps == nullptr)
+    {
+        return false;
+    }
+    const uint32_t start = millis();
+    File f = fs->open(path, FILE_READ);
+    const bool read = f && f.seek(face.info.bitmapOffset) &&
+                      f.read(face.bitmaps, face.info.bitmapBytes) == face.info.bitmapBytes;
+    if (f)
+    {
+        f.close();
+    }
+    if (!read || crc32Update(0, face.bitmaps, face.info.bitmapBytes) != face.info.bitmapCrc)
+    {
+        Serial.printf("[Font] Glyphs for size %u failed to load.\n", face.info.pixelSize);
+        free(face.bitmaps);
+        face.bitmaps = nullptr;
+        return false;
+    }
+    face.bitmapsFailed = false;
+    Serial.printf("[Font] Loaded %u glyphs at size %u (%u bytes) in %lu ms\n", face.info.glyphCount,
+                  face.info.pixelSize, (unsigned)face.info.bitmapBytes, (unsigned long)(millis() - start));
+    return true;
+}
+
+bool GlyphAtlas::covers(uint16_t pixelSize, const char *text) const
+{
+    const Face *face = find(pixelSize);
+    if (face == nullptr)
+    {
+        return false;
+    }
+    const size_t length = strlen(text);
+    uint32_t codepoint = 0;
+    for (size_t i = 0; i < length;)
+    {
+        i += decodeUtf8(text + i, length - i, codepoint);
+        if (glyphFor(*face, codepoint) == nullptr)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int16_t GlyphAtlas::textWidth(uint16_t pixelSize, const char *text) const
+{
+    const Face *face = find(pixelSize);
+    if (face == nullptr)
+    {
+        return 0;
+    }
+    const size_t length = strlen(text);
+    int width = 0;
+    uint32_t previous = 0;
+    uint32_t codepoint = 0;
+    for (size_t i = 0; i < length;)
+    {
+        i += decodeUtf8(text + i, length - i, codepoint);
+        const GlyphAtlasGlyph *glyph = glyphFor(*face, codepoint);
+        if (glyph == nullptr)
+        {
+            codepoint = REPLACEMENT;
+            glyph = glyphFor(*face, codepoint);
+        }
+        if (glyph == nullptr)
+        {
+            continue;
+        }
+        width += kerning(*face, previous, codepoint) + glyph->advance;
+        previous = codepoint;
+    }
+    return static_cast<int16_t>(width);
+}
+
+int16_t GlyphAtlas::lineHeight(uint16_t pixelSize) const
+{
+    const Face *face = find(pixelSize);
+    return face != nullptr ? face->info.ascent + face->info.descent : 0;
+}
+
+int16_t GlyphAtlas::ascent(uint16_t pixelSize) const
+{
+    const Face *face = find(pixelSize);
+    return face != nullptr ? face->info.ascent : 0;
+}
+
+bool GlyphAtlas::draw(uint8_t *frame, uint16_t frameWidth, uint16_t frameHeight, uint16_t pixelSize, const char *text,
+                      int x, int baselineY, uint8_t color)
+{
+    Face *face = const_cast<Face *>(find(pixelSize));
+    if (face == nullptr || frame == nullptr || !loadBitmaps(*face))
+    {
+        return false;
+    }
+    color &= 0x0F;
+    const int frameStride = frameWidth / 2;
+    const size_t length = strlen(text);
+    int penX = x;
+    uint32_t previous = 0;
+    uint32_t codepoint = 0;
+    for (size_t i = 0; i < length;)
+    {
+        i += decodeUtf8(text + i, length - i, codepoint);
+        const GlyphAtlasGlyph *glyph = glyphFor(*face, codepoint);
+        if (glyph == nullptr)
+        {
+            codepoint = REPLACEMENT;
+            glyph = glyphFor(*face, codepoint);
+        }
+        if (glyph == nullptr)
+        {
+            continue;
+        }
+        penX += kerning(*face, previous, codepoint);
+        previous = codepoint;
+
+        const uint8_t *rows = face->bitmaps + glyph->bitmapOffset;
+        const int rowBytes = (glyph->width + 1) / 2;
+        const int originX = penX + glyph->left;
+        const int originY = baselineY - glyph->top;
+        for (int row = 0; row < glyph->height; ++row)
+        {
+            const int frameY = originY + row;
+            if (frameY < 0 || frameY >= frameHeight)
+            {
+                continue;
+            }
+            uint8_t *frameRow = frame + frameY * frameStride;
+            for (int column = 0; column < glyph->width; ++column)
+            {
+                const int frameX = originX + column;
+                const uint8_t packed = rows[row * rowBytes + column / 2];
+                const int coverage = (column & 1) ? packed & 0x0F : packed >> 4;
+                if (coverage == 0 || frameX < 0 || frameX >= frameWidth)
+                {
+                    continue;
+                }
+                uint8_t &cell = frameRow[frameX / 2];
+                const int shift = (frameX & 1) ? 0 : 4;
+                const int under = (cell >> shift) & 0x0F;
+                // Coverage blends the text colour over whatever is already there.
+                const int blended = under + ((color - under) * coverage + (color > under ? 7 : -7)) / 15;
+                cell = static_cast<uint8_t>((cell & ~(0x0F << shift)) | (blended << shift));
+            }
+        }
+        penX += glyph->advance;
+    }
+    return true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+
+#include "glyphAtlasFormat.h"
+
+// Text rasterised ahead of time by tools/glyphbake: per pixel size, 4bpp
+// coverage bitmaps with metrics and kerning for exactly the characters the
+// firmware draws. begin() reads only the metric tables; a size's bitmaps are
+// read into PSRAM the first time text is drawn at it. Drawing is a blend of
+// those bitmaps into the canvas framebuffer, with no FreeType and no glyph
+// cache on the heap.
+class GlyphAtlas
+{
+public:
+    static constexpr size_t MAX_SIZES = 6;
+
+    bool begin(fs::FS &fs, const char *path);
+    bool ready() const { return sizeCount > 0; }
+    bool hasSize(uint16_t pixelSize) const { return find(pixelSize) != nullptr; }
+
+    // False if any character of `text` was not baked at this size.
+    bool covers(uint16_t pixelSize, const char *text) const;
+    // Advance width of `text` including kerning; missing glyphs count as '?'.
+    int16_t textWidth(uint16_t pixelSize, const char *text) const;
+    // ascent + descent, the height of the line box.
+    int16_t lineHeight(uint16_t pixelSize) const;
+    int16_t ascent(uint16_t pixelSize) const;
+    // Blends `text` in `color` into a 4bpp frame with its baseline at `baselineY`.
+    bool draw(uint8_t *frame, uint16_t frameWidth, uint16_t frameHeight, uint16_t pixelSize, const char *text, int x,
+              int baselineY, uint8_t color);
+
+private:
+    struct Face
+    {
+        GlyphAtlasSize info;
+        const GlyphAtlasGlyph *glyphs;
+        const GlyphAtlasKern *kerns;
+        uint8_t *bitmaps; // loaded on first draw
+        bool bitmapsFailed;
+    };
+
+    const Face *find(uint16_t pixelSize) const;
+    const GlyphAtlasGlyph *glyphFor(const Face &face, uint32_t codepoint) const;
+    int16_t kerning(const Face &face, uint32_t left, uint32_t right) const;
+    bool loadBitmaps(Face &face);
+
+    fs::FS *fs{nullptr};
+    String path;
+    uint8_t *tables{nullptr};
+    Face faces[MAX_SIZES]{};
+    size_t sizeCount{0};
+};
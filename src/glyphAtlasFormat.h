@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk layout of the baked glyph atlas (/font/glyphs.bin), written by
+// tools/glyphbake and read by GlyphAtlas. All fields are little-endian.
+//
+//   GlyphAtlasHeader
+//   GlyphAtlasSize[sizeCount]
+//   per size: GlyphAtlasGlyph[glyphCount], GlyphAtlasKern[kernCount]
+//   per size: bitmap blob
+//
+// `tablesCrc` covers everything between the header and the first bitmap blob;
+// each size's `bitmapCrc` covers its blob. Both are CRC-32 (crc32Update).
+// Glyph bitmaps are coverage 0..15, two pixels per byte with the left pixel in
+// the high nibble (the canvas layout), each row padded to a whole byte.
+constexpr uint32_t GLYPH_ATLAS_MAGIC = 0x4C544147; // "GATL"
+constexpr uint16_t GLYPH_ATLAS_VERSION = 1;
+
+struct GlyphAtlasHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t sizeCount;
+    uint32_t tablesBytes;
+    uint32_t tablesCrc;
+};
+
+struct GlyphAtlasSize
+{
+    uint16_t pixelSize; // as passed to setTextSize() once the smooth font is active
+    int16_t ascent;     // baseline to top of the line box
+    int16_t descent;    // baseline to bottom of the line box, positive
+    uint16_t glyphCount;
+    uint16_t kernCount;
+    uint16_t reserved;
+    uint32_t tablesOffset; // of this size's glyph records, from the start of the file
+    uint32_t bitmapOffset; // of this size's blob, from the start of the file
+    uint32_t bitmapBytes;
+    uint32_t bitmapCrc;
+};
+
+// Sorted by codepoint.
+struct GlyphAtlasGlyph
+{
+    uint32_t codepoint;
+    uint16_t width;
+    uint16_t height;
+    int16_t left;    // pen position to the bitmap's left edge
+    int16_t top;     // baseline up to the bitmap's top edge
+    int16_t advance; // pen movement after the glyph
+    uint16_t reserved;
+    uint32_t bitmapOffset; // within the size's blob
+};
+
+// Sorted by (left, right); only pairs with a non-zero adjustment are stored.
+struct GlyphAtlasKern
+{
+    uint16_t left;
+    uint16_t right;
+    int16_t adjust;
+    uint16_t reserved;
+};
+
+static_assert(sizeof(GlyphAtlasHeader) == 16, "atlas header layout");
+static_assert(sizeof(GlyphAtlasSize) == 28, "atlas size layout");
+static_assert(sizeof(GlyphAtlasGlyph) == 20, "atlas glyph layout");
+static_assert(sizeof(GlyphAtlasKern) == 8, "atlas kern layout");
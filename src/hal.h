@@ -0,0 +1,10 @@
+#pragma once
+
+#include <ctime>
+
+// Platform hooks the app needs beyond the Arduino/M5EPD classes, which both
+// targets already provide (the native build through lib/NativeHal). The
+// device implementation is halEsp32.cpp; env:native substitutes a virtual
+// clock so sleeps take no real time.
+time_t halEpochNow();
+void halSetEpoch(time_t epoch);
@@ -0,0 +1,15 @@
+#include "hal.h"
+
+#include <sys/time.h>
+
+time_t halEpochNow()
+{
+    return time(nullptr);
+}
+
+void halSetEpoch(time_t epoch)
+{
+    timeval tv{};
+    tv.tv_sec = epoch;
+    settimeofday(&tv, nullptr);
+}
@@ -0,0 +1,344 @@
+#include "iconAtlas.h"
+
+#include <M5EPD.h>
+#include <algorithm>
+#include <utility/pngle.h>
+
+namespace
+{
+constexpr uint32_t TILE_MAGIC = 0x4C495449; // "ITIL"
+constexpr uint8_t ALPHA_THRESHOLD = 127;    // same cut-off drawPngFile() was given
+constexpr size_t FEED_CHUNK = 512;
+
+struct TileHeader
+{
+    uint32_t magic;
+    char key[IconAtlas::KEY_LENGTH];
+    uint16_t boxW;
+    uint16_t boxH;
+    uint16_t tileW;
+    uint16_t tileH;
+};
+
+size_t tileBytes(uint16_t w, uint16_t h)
+{
+    return static_cast<size_t>(w) * h / 2;
+}
+
+// Decode target for pngle: 8-bit luminance plus an opacity mask, clipped to the box.
+struct DecodeContext
+{
+    uint16_t boxW;
+    uint16_t boxH;
+    uint16_t width{0};
+    uint16_t height{0};
+    uint8_t *gray{nullptr};
+    uint8_t *opaque{nullptr};
+    bool failed{false};
+};
+
+void onPngInit(pngle_t *pngle, uint32_t w, uint32_t h)
+{
+    DecodeContext &ctx = *static_cast<DecodeContext *>(pngle_get_user_data(pngle));
+    // Even width keeps every tile row byte-aligned in the 4bpp layout.
+    ctx.width = static_cast<uint16_t>(std::min<uint32_t>(w, ctx.boxW) & ~1U);
+    ctx.height = static_cast<uint16_t>(std::min<uint32_t>(h, ctx.boxH));
+    const size_t pixels = static_cast<size_t>(ctx.width) * ctx.height;
+    ctx.gray = static_cast<uint8_t *>(malloc(pixels));
+    ctx.opaque = static_cast<uint8_t *>(calloc(pixels, 1));
+    ctx.failed = ctx.gray == nullptr || ctx.opaque == nullptr || pixels == 0;
+}
+
+void onPngDraw(pngle_t *pngle, uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint8_t rgba[4])
+{
+    DecodeContext &ctx = *static_cast<DecodeContext *>(pngle_get_user_data(pngle));
+    if (ctx.failed || rgba[3] <= ALPHA_THRESHOLD)
+    {
+        return;
+    }
+    const uint8_t luminance = static_cast<uint8_t>((rgba[0] * 77U + rgba[1] * 150U + rgba[2] * 29U) >> 8);
+    // Interlaced passes report blocks larger than one pixel.
+    for (uint32_t py = y; py < y + h && py < ctx.height; ++py)
+    {
+        for (uint32_t px = x; px < x + w && px < ctx.width; ++px)
+        {
+            const size_t i = py * ctx.width + px;
+            ctx.gray[i] = luminance;
+            ctx.opaque[i] = 1;
+        }
+    }
+}
+
+// Floyd-Steinberg error diffusion from 8-bit luminance to the 16 panel levels
+// (canvas colour 0 = white, 15 = black). Transparent pixels stay white and do
+// not take part in the diffusion.
+void ditherInto(M5EPD_Canvas &tile, const DecodeContext &ctx)
+{
+    const int width = ctx.width;
+    int16_t *current = static_cast<int16_t *>(calloc(width + 2, sizeof(int16_t)));
+    int16_t *next = static_cast<int16_t *>(calloc(width + 2, sizeof(int16_t)));
+    if (current == nullptr || next == nullptr)
+    {
+        free(current);
+        free(next);
+        return;
+    }
+    for (int y = 0; y < ctx.height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const size_t i = static_cast<size_t>(y) * width + x;
+            if (!ctx.opaque[i])
+            {
+                continue;
+            }
+            const int value = std::max(0, std::min(255, ctx.gray[i] + current[x + 1]));
+            const int level = (value * 15 + 127) / 255;
+            const int error = value - level * 17;
+            current[x + 2] += error * 7 / 16;
+            next[x] += error * 3 / 16;
+            next[x + 1] += error * 5 / 16;
+            next[x + 2] += error / 16;
+            tile.drawPixel(x, y, 15 - level);
+        }
+        std::swap(current, next);
+        memset(next, 0, (width + 2) * sizeof(int16_t));
+    }
+    free(current);
+    free(next);
+}
+} // namespace
+
+bool IconAtlas::begin(fs::FS &filesystem, const char *atlasPath)
+{
+    fs = &filesystem;
+    path = atlasPath;
+    tileCount = 0;
+    if (reader)
+    {
+        reader.close();
+    }
+    if (!fs->exists(path))
+    {
+        return true;
+    }
+
+    File f = fs->open(path, FILE_READ);
+    if (!f)
+    {
+        return false;
+    }
+    const size_t fileSize = f.size();
+    size_t offset = 0;
+    TileHeader header;
+    while (tileCount < MAX_TILES && offset + sizeof(header) <= fileSize)
+    {
+        f.seek(offset);
+        if (f.read(reinterpret_cast<uint8_t *>(&header), sizeof(header)) != sizeof(header) || header.magic != TILE_MAGIC)
+        {
+            break;
+        }
+        const size_t dataOffset = offset + sizeof(header);
+        const size_t bytes = tileBytes(header.tileW, header.tileH);
+        if (dataOffset + bytes > fileSize)
+        {
+            break; // torn final record from an interrupted append
+        }
+        Entry &entry = entries[tileCount++];
+        memcpy(entry.key, header.key, KEY_LENGTH);
+        entry.key[KEY_LENGTH - 1] = '\0';
+        entry.boxW = header.boxW;
+        entry.boxH = header.boxH;
+        entry.tileW = header.tileW;
+        entry.tileH = header.tileH;
+        entry.offset = static_cast<uint32_t>(dataOffset);
+        offset = dataOffset + bytes;
+    }
+    f.close();
+    Serial.printf("[Icon] Atlas has %u tile(s).\n", (unsigned)tileCount);
+    return true;
+}
+
+const IconAtlas::Entry *IconAtlas::find(const char *key, uint16_t boxW, uint16_t boxH) const
+{
+    for (size_t i = 0; i < tileCount; ++i)
+    {
+        const Entry &entry = entries[i];
+        if (entry.boxW == boxW && entry.boxH == boxH && strncmp(entry.key, key, KEY_LENGTH) == 0)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool IconAtlas::contains(const char *key, uint16_t boxW, uint16_t boxH) const
+{
+    return find(key, boxW, boxH) != nullptr;
+}
+
+bool IconAtlas::append(const char *key, uint16_t boxW, uint16_t boxH, uint16_t tileW, uint16_t tileH,
+                       const uint8_t *pixels)
+{
+    if (fs == nullptr || tileCount >= MAX_TILES || strlen(key) >= KEY_LENGTH)
+    {
+        return false;
+    }
+    if (reader)
+    {
+        reader.close();
+    }
+
+    TileHeader header{};
+    header.magic = TILE_MAGIC;
+    strncpy(header.key, key, KEY_LENGTH - 1);
+    header.boxW = boxW;
+    header.boxH = boxH;
+    header.tileW = tileW;
+    header.tileH = tileH;
+
+    File f = fs->open(path, FILE_APPEND);
+    if (!f)
+    {
+        return false;
+    }
+    const size_t start = f.size();
+    const size_t bytes = tileBytes(tileW, tileH);
+    const bool ok = f.write(reinterpret_cast<const uint8_t *>(&header), sizeof(header)) == sizeof(header) &&
+                    f.write(pixels, bytes) == bytes;
+    f.close();
+    if (!ok)
+    {
+        return false;
+    }
+
+    Entry &entry = entries[tileCount++];
+    memcpy(entry.key, header.key, KEY_LENGTH);
+    entry.boxW = boxW;
+    entry.boxH = boxH;
+    entry.tileW = tileW;
+    entry.tileH = tileH;
+    entry.offset = static_cast<uint32_t>(start + sizeof(header));
+    return true;
+}
+
+bool IconAtlas::bake(const char *key, const char *pngPath, uint16_t boxW, uint16_t boxH)
+{
+    if (fs == nullptr)
+    {
+        return false;
+    }
+    if (contains(key, boxW, boxH))
+    {
+        return true;
+    }
+    File png = fs->open(pngPath, FILE_READ);
+    if (!png)
+    {
+        return false;
+    }
+
+    const uint32_t start = millis();
+    DecodeContext ctx{boxW, boxH};
+    pngle_t *pngle = pngle_new();
+    pngle_set_user_data(pngle, &ctx);
+    pngle_set_init_callback(pngle, onPngInit);
+    pngle_set_draw_callback(pngle, onPngDraw);
+
+    uint8_t buffer[FEED_CHUNK];
+    size_t pending = 0;
+    bool decodeOk = true;
+    while (png.available() && !ctx.failed)
+    {
+        const size_t n = png.read(buffer + pending, sizeof(buffer) - pending);
+        if (n == 0)
+        {
+            break;
+        }
+        pending += n;
+        const int consumed = pngle_feed(pngle, buffer, pending);
+        if (consumed < 0)
+        {
+            Serial.printf("[Icon] PNG decode failed for %s: %s\n", pngPath, pngle_error(pngle));
+            decodeOk = false;
+            break;
+        }
+        pending -= consumed;
+        memmove(buffer, buffer + consumed, pending);
+    }
+    png.close();
+    pngle_destroy(pngle);
+
+    bool baked = false;
+    if (decodeOk && !ctx.failed && ctx.width > 0)
+    {
+        M5EPD_Canvas tile(&M5.EPD);
+        if (tile.createCanvas(ctx.width, ctx.height))
+        {
+            tile.fillCanvas(0);
+            ditherInto(tile, ctx);
+            baked = append(key, boxW, boxH, ctx.width, ctx.height, static_cast<const uint8_t *>(tile.frameBuffer()));
+            tile.deleteCanvas();
+        }
+    }
+    free(ctx.gray);
+    free(ctx.opaque);
+
+    if (baked)
+    {
+        Serial.printf("[Icon] Baked %s (%ux%u) into atlas in %lu ms\n", key, ctx.width, ctx.height,
+                      (unsigned long)(millis() - start));
+    }
+    return baked;
+}
+
+bool IconAtlas::draw(uint8_t *frame, uint16_t frameWidth, uint16_t frameHeight, const char *key, int x, int y,
+                     uint16_t boxW, uint16_t boxH)
+{
+    const Entry *entry = find(key, boxW, boxH);
+    if (entry == nullptr || frame == nullptr || fs == nullptr)
+    {
+        return false;
+    }
+
+    const size_t bytes = tileBytes(entry->tileW, entry->tileH);
+    if (scratchSize < bytes)
+    {
+        free(scratch);
+        scratch = static_cast<uint8_t *>(malloc(bytes));
+        scratchSize = scratch != nullptr ? bytes : 0;
+        if (scratch == nullptr)
+        {
+            return false;
+        }
+    }
+    if (!reader)
+    {
+        reader = fs->open(path, FILE_READ);
+        if (!reader)
+        {
+            return false;
+        }
+    }
+    if (!reader.seek(entry->offset) || reader.read(scratch, bytes) != bytes)
+    {
+        reader.close();
+        return false;
+    }
+
+    // Tiles are copied a byte (two pixels) at a time, so snap to an even column.
+    x &= ~1;
+    const int rowBytes = entry->tileW / 2;
+    const int frameStride = frameWidth / 2;
+    const int copyBytes = std::min(rowBytes, (static_cast<int>(frameWidth) - x) / 2);
+    for (int row = 0; row < entry->tileH; ++row)
+    {
+        const int frameY = y + row;
+        if (frameY < 0 || frameY >= frameHeight || x < 0 || copyBytes <= 0)
+        {
+            continue;
+        }
+        memcpy(frame + frameY * frameStride + x / 2, scratch + row * rowBytes, copyBytes);
+    }
+    return true;
+}
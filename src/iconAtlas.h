@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+
+// Pre-rendered weather icons. Each PNG is decoded once, clipped to its display
+// box, dithered to the panel's 16 gray levels and appended to a single atlas
+// file on SD as packed 4bpp canvas pixels. Drawing an icon is then one read of
+// the tile and a row copy into the canvas: no PNG decode and no per-icon
+// file lookup.
+//
+// Atlas file: a sequence of records, each a 28-byte header
+//   uint32 magic 'ITIL' | char key[16] | uint16 boxW | uint16 boxH | uint16 tileW | uint16 tileH
+// followed by tileW * tileH / 2 bytes of pixels in the canvas framebuffer layout.
+class IconAtlas
+{
+public:
+    static constexpr size_t MAX_TILES = 64;
+    static constexpr size_t KEY_LENGTH = 16;
+
+    // Scans the record headers once and builds the in-RAM index.
+    bool begin(fs::FS &fs, const char *path);
+    bool contains(const char *key, uint16_t boxW, uint16_t boxH) const;
+    // Decodes `pngPath`, dithers it and appends it under `key` for this box size.
+    bool bake(const char *key, const char *pngPath, uint16_t boxW, uint16_t boxH);
+    // Copies the tile into a 4bpp framebuffer with its top-left corner at (x, y).
+    bool draw(uint8_t *frame, uint16_t frameWidth, uint16_t frameHeight, const char *key, int x, int y,
+              uint16_t boxW, uint16_t boxH);
+    size_t size() const { return tileCount; }
+
+private:
+    struct Entry
+    {
+        char key[KEY_LENGTH];
+        uint16_t boxW;
+        uint16_t boxH;
+        uint16_t tileW;
+        uint16_t tileH;
+        uint32_t offset; // of the pixel data
+    };
+
+    const Entry *find(const char *key, uint16_t boxW, uint16_t boxH) const;
+    bool append(const char *key, uint16_t boxW, uint16_t boxH, uint16_t tileW, uint16_t tileH, const uint8_t *pixels);
+
+    fs::FS *fs{nullptr};
+    String path;
+    File reader;
+    Entry entries[MAX_TILES];
+    size_t tileCount{0};
+    uint8_t *scratch{nullptr};
+    size_t scratchSize{0};
+};
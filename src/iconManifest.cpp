@@ -0,0 +1,146 @@
+#include "iconManifest.h"
+
+#include "snapshotStore.h"
+
+namespace
+{
+constexpr char MANIFEST_TAG[] = "m5pw-icons 1";
+constexpr char FULL_SET_LINE[] = "full";
+} // namespace
+
+const char *const OWM_ICON_CODES[OWM_ICON_CODE_COUNT] = {
+    "01d", "01n", "02d", "02n", "03d", "03n", "04d", "04n", "09d",
+    "09n", "10d", "10n", "11d", "11n", "13d", "13n", "50d", "50n",
+};
+
+bool IconManifest::begin(fs::FS &filesystem, const char *manifestPath)
+{
+    fs = &filesystem;
+    path = manifestPath;
+    codeCount = 0;
+    fullSet = false;
+    dirty = true;
+
+    recoverSideFile(*fs, path.c_str());
+    if (!fs->exists(path))
+    {
+        return false;
+    }
+    File f = fs->open(path, FILE_READ);
+    if (!f)
+    {
+        return false;
+    }
+    String line = f.readStringUntil('\n');
+    line.trim();
+    if (line != MANIFEST_TAG)
+    {
+        Serial.printf("[Icon] %s has an unknown format; rebuilding it.\n", path.c_str());
+        f.close();
+        return false;
+    }
+    while (f.available() > 0)
+    {
+        line = f.readStringUntil('\n');
+        line.trim();
+        if (line == FULL_SET_LINE)
+        {
+            fullSet = true;
+        }
+        else if (line.length() > 0)
+        {
+            add(line.c_str());
+        }
+    }
+    f.close();
+    dirty = false;
+    Serial.printf("[Icon] Manifest lists %u downloaded icon(s)%s.\n", (unsigned)codeCount,
+                  fullSet ? ", full set" : "");
+    return true;
+}
+
+int IconManifest::indexOf(const char *code) const
+{
+    for (size_t i = 0; i < codeCount; ++i)
+    {
+        if (strncmp(codes[i], code, CODE_LENGTH) == 0)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool IconManifest::contains(const char *code) const
+{
+    return indexOf(code) >= 0;
+}
+
+void IconManifest::add(const char *code)
+{
+    if (indexOf(code) >= 0 || codeCount >= MAX_CODES || strlen(code) >= CODE_LENGTH)
+    {
+        return;
+    }
+    snprintf(codes[codeCount++], CODE_LENGTH, "%s", code);
+    dirty = true;
+}
+
+void IconManifest::remove(const char *code)
+{
+    const int index = indexOf(code);
+    if (index < 0)
+    {
+        return;
+    }
+    codes[index][0] = '\0';
+    for (size_t i = index + 1; i < codeCount; ++i)
+    {
+        memcpy(codes[i - 1], codes[i], CODE_LENGTH);
+    }
+    --codeCount;
+    // A lost file means the set is no longer complete.
+    fullSet = false;
+    dirty = true;
+}
+
+void IconManifest::setFullSetLoaded(bool value)
+{
+    if (fullSet != value)
+    {
+        fullSet = value;
+        dirty = true;
+    }
+}
+
+bool IconManifest::save()
+{
+    if (!dirty || fs == nullptr)
+    {
+        return true;
+    }
+    // Side file and swap, as for the snapshot; begin() recovers a swap cut short.
+    const String tempPath = path + ".tmp";
+    File f = fs->open(tempPath, FILE_WRITE);
+    if (!f)
+    {
+        Serial.printf("[Icon] Failed to open %s for writing\n", tempPath.c_str());
+        return false;
+    }
+    f.println(MANIFEST_TAG);
+    if (fullSet)
+    {
+        f.println(FULL_SET_LINE);
+    }
+    for (size_t i = 0; i < codeCount; ++i)
+    {
+        f.println(codes[i]);
+    }
+    f.close();
+    if (!commitSideFile(*fs, tempPath, path.c_str()))
+    {
+        return false;
+    }
+    dirty = false;
+    return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+
+// Every icon code OpenWeatherMap uses ("01d" .. "50n").
+constexpr size_t OWM_ICON_CODE_COUNT = 18;
+extern const char *const OWM_ICON_CODES[OWM_ICON_CODE_COUNT];
+
+// In-RAM list of the OWM icon PNGs already downloaded to SD, loaded once so the
+// prefetch stage can decide what to fetch without a FAT lookup per code.
+//
+// Manifest file: plain text, one entry per line.
+//   "m5pw-icons 1"      format tag and version
+//   "full"              optional: the whole OWM set has been preloaded
+//   "<code>"            one line per downloaded icon, e.g. "10d"
+class IconManifest
+{
+public:
+    static constexpr size_t MAX_CODES = 32;
+    static constexpr size_t CODE_LENGTH = 8;
+
+    // Reads the manifest. A missing or foreign file leaves it empty and returns
+    // false; the next save() writes it even if nothing is added.
+    bool begin(fs::FS &fs, const char *path);
+    bool contains(const char *code) const;
+    void add(const char *code);
+    void remove(const char *code);
+    bool fullSetLoaded() const { return fullSet; }
+    void setFullSetLoaded(bool value);
+    // Writes the manifest back if anything changed since begin() or the last save.
+    bool save();
+
+private:
+    int indexOf(const char *code) const;
+
+    fs::FS *fs{nullptr};
+    String path;
+    char codes[MAX_CODES][CODE_LENGTH];
+    size_t codeCount{0};
+    bool fullSet{false};
+    bool dirty{false};
+};
@@ -0,0 +1,42 @@
+#include "layerCache.h"
+
+bool LayerCache::restore(uint8_t key, uint8_t *frame) const
+{
+    if (key >= MAX_LAYERS || frame == nullptr)
+    {
+        return false;
+    }
+    const Layer &layer = layers[key];
+    if (layer.pixels == nullptr || layer.generation != generation)
+    {
+        return false;
+    }
+    memcpy(frame, layer.pixels, frameBytes);
+    return true;
+}
+
+bool LayerCache::store(uint8_t key, const uint8_t *frame)
+{
+    if (key >= MAX_LAYERS || frame == nullptr || refused(key))
+    {
+        return false;
+    }
+    Layer &layer = layers[key];
+    if (layer.pixels == nullptr)
+    {
+        // Allocated on first use, so views never opened cost no PSRAM.
+        if (ESP.getFreePsram() >= frameBytes + psramReserve)
+        {
+            layer.pixels = static_cast<uint8_t *>(ps_malloc(frameBytes));
+        }
+        if (layer.pixels == nullptr)
+        {
+            Serial.printf("[Display] No PSRAM for %s %u; drawing it every time.\n", name, key);
+            layer.refusedGeneration = generation;
+            return false;
+        }
+    }
+    memcpy(layer.pixels, frame, frameBytes);
+    layer.generation = generation;
+    return true;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Pre-rendered full-frame layers in PSRAM, one per small integer key. A layer
+// holds the parts of a view that are the same on every render (titles,
+// labels, card frames) in the canvas framebuffer layout, so a render starts
+// with one block copy instead of a clear and a pass of text rasterisation.
+//
+// The same structure holds whole pre-rendered views, keyed by UI mode.
+//
+// Layers remember the generation they were drawn in; invalidate() bumps it,
+// so a font or config change redraws every layer on its next use. A layer that
+// found no PSRAM is not tried again until then.
+class LayerCache
+{
+public:
+    static constexpr size_t MAX_LAYERS = 8;
+
+    // A new layer is only allocated while `psramReserve` bytes of PSRAM stay
+    // free after it, so an optional cache cannot starve later allocations.
+    LayerCache(size_t frameBytes, const char *name, size_t psramReserve = 0)
+        : frameBytes(frameBytes), name(name), psramReserve(psramReserve)
+    {
+    }
+
+    // Copies layer `key` into `frame`; false if it was never stored or is stale.
+    bool restore(uint8_t key, uint8_t *frame) const;
+    // Keeps a copy of `frame` as layer `key`; false if there is no PSRAM for it.
+    bool store(uint8_t key, const uint8_t *frame);
+    bool fresh(uint8_t key) const { return key < MAX_LAYERS && layers[key].generation == generation; }
+    // True if store() already failed for `key` in this generation.
+    bool refused(uint8_t key) const { return key < MAX_LAYERS && layers[key].refusedGeneration == generation; }
+    void invalidate() { ++generation; }
+
+private:
+    struct Layer
+    {
+        uint8_t *pixels{nullptr};
+        uint32_t generation{0};
+        uint32_t refusedGeneration{0};
+    };
+
+    size_t frameBytes;
+    const char *name;
+    size_t psramReserve;
+    uint32_t generation{1};
+    Layer layers[MAX_LAYERS];
+};
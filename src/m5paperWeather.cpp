@@ -10,9 +10,31 @@
 #include <type_traits>
 #include <limits>
 #include <SD.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include "batteryModel.h"
+#include "climateHistory.h"
+#include "connectionPool.h"
+#include "dayAggregator.h"
+#include "fetchScheduler.h"
+#include "frameDiff.h"
+#include "glyphAtlas.h"
+#include "hal.h"
+#include "iconAtlas.h"
+#include "iconManifest.h"
+#include "layerCache.h"
+#include "netWorker.h"
+#include "perfLog.h"
+#include "snapshotStore.h"
+#include "textLayout.h"
+#include "textRenderer.h"
+#include "touchInput.h"
+#include "weatherSnapshot.h"
+#include "wifiConnect.h"
 
 // Forward declarations for functions defined later but used early
 int mapLegacySizeToPx(int legacy);
+uint8_t resolveTextSize(int size);
 void setTextSizeCompat(int size);
 void tryLoadSmoothFont();
 
@@ -26,75 +48,492 @@ constexpr float DEFAULT_OWM_LATITUDE = 0.0F;
 constexpr float DEFAULT_OWM_LONGITUDE = 0.0F;
 constexpr char DEFAULT_OWM_UNITS[] = "imperial";
 constexpr char DEFAULT_OWM_LANGUAGE[] = "en";
+constexpr char DEFAULT_OWM_BASE_URL[] = "https://api.openweathermap.org";
+constexpr char DEFAULT_OWM_ICON_BASE_URL[] = "http://openweathermap.org";
 constexpr uint32_t DEFAULT_WEATHER_UPDATE_INTERVAL = 12UL * 60UL * 60UL * 1000UL; // 12 hours
 constexpr uint32_t DEFAULT_INDOOR_UPDATE_INTERVAL = 10UL * 60UL * 1000UL; // 10 minutes
+constexpr uint8_t DEFAULT_FORECAST_DAYS = 3;
+constexpr uint16_t DEFAULT_TARGET_RUNTIME_DAYS = 0; // 0 = fixed intervals
+constexpr float DEFAULT_LOW_BATTERY_PERCENT = 10.0F;
+
+// How the device idles between scheduled updates.
+//  None  - legacy 50 ms polling loop, never sleeps
+//  Light - light sleep; RAM retained, wakes on timer or touch
+//  Deep  - deep sleep; state kept in RTC memory, wakes on timer or touch
+enum class SleepMode : uint8_t
+{
+    None,
+    Light,
+    Deep,
+};
+constexpr SleepMode DEFAULT_SLEEP_MODE = SleepMode::Light;
+
+// Which OpenWeather API supplies the data.
+//  Forecast  - /weather + /forecast (two requests), daily min/max rebuilt from 3-hourly entries
+//  OneCall25 - One Call 2.5: current and daily forecast in one request
+//  OneCall30 - One Call 3.0 (needs the "One Call by Call" subscription)
+enum class WeatherBackend : uint8_t
+{
+    Forecast,
+    OneCall25,
+    OneCall30,
+};
+constexpr WeatherBackend DEFAULT_WEATHER_BACKEND = WeatherBackend::Forecast;
+
+// A place to forecast. The first one is the `openweathermap` lat/lon unless
+// weather.json has a `locations` list.
+constexpr size_t MAX_LOCATIONS = 4;
+struct WeatherLocation
+{
+    String name; // dashboard title; empty shows "Location N"
+    float latitude;
+    float longitude;
+    uint32_t updateInterval; // ms; 0 follows update.weatherHours
+};
 
 // Runtime-configurable settings (loaded from SD if present)
 String CFG_WIFI_SSID = DEFAULT_WIFI_SSID;
 String CFG_WIFI_PASSWORD = DEFAULT_WIFI_PASSWORD;
+// Further access points from wifi.networks, after the primary ssid/password.
+WifiNetwork CFG_WIFI_EXTRA_NETWORKS[MAX_WIFI_NETWORKS - 1];
+size_t CFG_WIFI_EXTRA_NETWORK_COUNT = 0;
+StaticIpConfig CFG_WIFI_STATIC_IP;
 String CFG_OWM_API_KEY = DEFAULT_OWM_API_KEY;
-float CFG_OWM_LATITUDE = DEFAULT_OWM_LATITUDE;
-float CFG_OWM_LONGITUDE = DEFAULT_OWM_LONGITUDE;
+WeatherLocation CFG_LOCATIONS[MAX_LOCATIONS] = {{String(), DEFAULT_OWM_LATITUDE, DEFAULT_OWM_LONGITUDE, 0}};
+size_t CFG_LOCATION_COUNT = 1;
 String CFG_OWM_UNITS = DEFAULT_OWM_UNITS;
 String CFG_OWM_LANGUAGE = DEFAULT_OWM_LANGUAGE;
+// Scheme and host (no trailing slash) the API and icon paths are appended to;
+// overridable so a local stand-in server can answer instead.
+String CFG_OWM_BASE_URL = DEFAULT_OWM_BASE_URL;
+String CFG_OWM_ICON_BASE_URL = DEFAULT_OWM_ICON_BASE_URL;
 uint32_t CFG_WEATHER_UPDATE_INTERVAL = DEFAULT_WEATHER_UPDATE_INTERVAL;
 uint32_t CFG_INDOOR_UPDATE_INTERVAL = DEFAULT_INDOOR_UPDATE_INTERVAL;
+SleepMode CFG_SLEEP_MODE = DEFAULT_SLEEP_MODE;
+WeatherBackend CFG_WEATHER_BACKEND = DEFAULT_WEATHER_BACKEND;
+uint8_t CFG_FORECAST_DAYS = DEFAULT_FORECAST_DAYS; // 1..MAX_FORECAST_DAYS
+uint16_t CFG_TARGET_RUNTIME_DAYS = DEFAULT_TARGET_RUNTIME_DAYS;
+float CFG_LOW_BATTERY_PERCENT = DEFAULT_LOW_BATTERY_PERCENT;
 constexpr uint16_t CANVAS_WIDTH = 960;
 constexpr uint16_t CANVAS_HEIGHT = 540;
 constexpr uint8_t DISPLAY_ROTATION = 0;
 constexpr uint8_t COLOR_WHITE = 0;
 constexpr uint8_t COLOR_BLACK = 15;
+// Views cycled by tapping or swiping: 0 = main dashboard, 1..N = day detail for
+// the configured forecast days, then the forecast timeline and indoor history.
+uint8_t uiModeCount() { return CFG_FORECAST_DAYS + 3; }
+uint8_t uiModeTimeline() { return CFG_FORECAST_DAYS + 1; }
+uint8_t uiModeClimateHistory() { return CFG_FORECAST_DAYS + 2; }
+// Timing page outside the tap cycle, opened and closed with a long press.
+constexpr uint8_t UI_MODE_DIAGNOSTICS = 0xFF;
 // Optional TrueType/OpenType font on SD for smoother text rendering.
 constexpr char FONT_PATH_REGULAR[] = "/font/Roboto-Regular.ttf"; // place on SD card
+// The same font pre-rasterised by tools/glyphbake; used instead of FreeType when present.
+constexpr char FONT_ATLAS_PATH[] = "/font/glyphs.bin";
+// Partial refresh: only regions that changed since the last push are refreshed,
+// with a non-flashing waveform. A full GC16 pass runs periodically to clear ghosting.
+constexpr size_t FRAME_BYTES = static_cast<size_t>(CANVAS_WIDTH) * CANVAS_HEIGHT / 2;
+constexpr m5epd_update_mode_t PARTIAL_REFRESH_MODE = UPDATE_MODE_GL16;
+constexpr uint8_t PARTIAL_REFRESHES_BEFORE_FULL = 24;
+constexpr uint32_t PARTIAL_REFRESH_MAX_COVERAGE_PERCENT = 40;
+constexpr size_t MAX_DIRTY_RECTS = 8;
+// Dirty rects narrower than the panel are packed here a strip at a time before
+// they go over SPI; 16 KB is 34 full-width rows.
+constexpr size_t PARTIAL_WRITE_SCRATCH_BYTES = 16 * 1024;
+// Free PSRAM that pre-rendered views must leave for everything else.
+constexpr size_t PRERENDER_PSRAM_RESERVE = 512 * 1024;
+// Sleep scheduling. The GT911 INT line (GPIO36) pulls low on touch; GPIO2 holds
+// the main power rail on when running from battery and must stay latched in deep sleep.
+constexpr gpio_num_t TOUCH_INT_PIN = GPIO_NUM_36;
+constexpr gpio_num_t MAIN_POWER_PIN = GPIO_NUM_2;
+constexpr uint32_t TOUCH_IDLE_BEFORE_SLEEP_MS = 4000; // stay awake for follow-up taps
+// Weather fetches run on a task on the protocol core, beside the Wi-Fi stack.
+constexpr uint32_t NET_TASK_STACK_BYTES = 16 * 1024;
+constexpr BaseType_t NET_TASK_CORE = 0;
+constexpr uint32_t FETCH_POLL_MS = 100;
+constexpr uint32_t RETAINED_STATE_MAGIC = 0x57534C50; // "WSLP"
+constexpr time_t MIN_VALID_EPOCH = 1672531200; // 2023-01-01; older RTC values mean "never set"
+// Last good snapshot, rendered at boot before any network traffic.
+constexpr char SNAPSHOT_DIR[] = "/cache";
+constexpr char SNAPSHOT_PATH[] = "/cache/weather.bin";
+// Append-only log of indoor readings behind the history view.
+constexpr char CLIMATE_LOG_PATH[] = "/cache/climate.log";
+// One CSV row of phase timings per update cycle; rotated to perf.csv.1 past the cap.
+constexpr char PERF_LOG_DIR[] = "/logs";
+constexpr char PERF_LOG_PATH[] = "/logs/perf.csv";
+constexpr size_t PERF_LOG_MAX_BYTES = 256 * 1024;
+constexpr uint8_t SPARKLINE_AREA_GRAY = 3;
+constexpr uint8_t PRECIP_BAR_GRAY = 6;
+// Timeline page geometry, shared by its chrome layer and its plot.
+constexpr int TIMELINE_GRAPH_X = 80;
+constexpr int TIMELINE_GRAPH_W = CANVAS_WIDTH - 30 - TIMELINE_GRAPH_X;
+constexpr int TIMELINE_GRAPH_Y = 210;
+constexpr int TIMELINE_GRAPH_H = 200;
+constexpr int TIMELINE_PRECIP_Y = TIMELINE_GRAPH_Y + TIMELINE_GRAPH_H + 10;
+constexpr int TIMELINE_PRECIP_H = 50;
+// Forecast card row on the dashboard; cards share its width.
+constexpr int FORECAST_CARD_X = 30;
+constexpr int FORECAST_CARD_Y = 360;
+constexpr int FORECAST_CARD_HEIGHT = 150;
+constexpr int FORECAST_CARD_SPACING = 20;
+// Taps above this line on the dashboard hit the title (above the WiFi line).
+constexpr int DASHBOARD_TITLE_BOTTOM = 80;
+constexpr char ICON_ATLAS_PATH[] = "/icons/atlas.bin";
+constexpr char ICON_MANIFEST_PATH[] = "/icons/manifest.txt";
+constexpr int DETAIL_ICON_BOX_W = 150;
+constexpr int DETAIL_ICON_BOX_H = 150;
+// Cap on one downloaded OWM icon; the @2x PNGs are a few KB.
+constexpr size_t MAX_ICON_BYTES = 32 * 1024;
+// Hard caps on OpenWeather response bodies; a /forecast reply is ~16 KB.
+constexpr size_t MAX_CURRENT_RESPONSE_BYTES = 4 * 1024;
+constexpr size_t MAX_FORECAST_RESPONSE_BYTES = 32 * 1024;
+constexpr size_t MAX_ONECALL_RESPONSE_BYTES = 40 * 1024; // current + 48 hourly + 8 daily entries is ~30 KB
+// Unparsed tail of a body read off so its keep-alive connection can carry the next request.
+constexpr size_t KEEP_ALIVE_DRAIN_BYTES = 2 * 1024;
+// Filtered documents only hold dt, main.temp, pop and weather[0].{id,icon,description}.
+constexpr size_t FORECAST_MAX_ENTRIES = 40; // 5 days of 3-hourly entries
+constexpr size_t WEATHER_STRINGS_SLACK = 64; // description + icon code per entry
+constexpr size_t CURRENT_DOC_CAPACITY = JSON_OBJECT_SIZE(4) + JSON_OBJECT_SIZE(1) + JSON_ARRAY_SIZE(1) +
+                                        JSON_OBJECT_SIZE(3) + WEATHER_STRINGS_SLACK;
+constexpr size_t FORECAST_ENTRY_CAPACITY = JSON_OBJECT_SIZE(4) + JSON_OBJECT_SIZE(1) + JSON_ARRAY_SIZE(1) +
+                                           JSON_OBJECT_SIZE(3) + WEATHER_STRINGS_SLACK;
+constexpr size_t FORECAST_DOC_CAPACITY = JSON_OBJECT_SIZE(2) + JSON_OBJECT_SIZE(1) + JSON_ARRAY_SIZE(FORECAST_MAX_ENTRIES) +
+                                         FORECAST_MAX_ENTRIES * FORECAST_ENTRY_CAPACITY;
+// One Call keeps timezone_offset, current.{dt,temp,weather[0]}, hourly[].{dt,temp,pop,weather[0].{id,icon}}
+// and daily[].{dt,temp.{min,max},weather[0]}.
+constexpr size_t ONECALL_HOURLY_MAX_ENTRIES = 48;
+constexpr size_t ONECALL_HOURLY_ENTRY_CAPACITY = JSON_OBJECT_SIZE(4) + JSON_ARRAY_SIZE(1) + JSON_OBJECT_SIZE(2) + 8;
+constexpr size_t ONECALL_DAILY_MAX_ENTRIES = 8;
+constexpr size_t ONECALL_DAILY_ENTRY_CAPACITY = JSON_OBJECT_SIZE(3) + JSON_OBJECT_SIZE(2) + JSON_ARRAY_SIZE(1) +
+                                                JSON_OBJECT_SIZE(3) + WEATHER_STRINGS_SLACK;
+constexpr size_t ONECALL_DOC_CAPACITY = JSON_OBJECT_SIZE(4) + CURRENT_DOC_CAPACITY +
+                                        JSON_ARRAY_SIZE(ONECALL_HOURLY_MAX_ENTRIES) +
+                                        ONECALL_HOURLY_MAX_ENTRIES * ONECALL_HOURLY_ENTRY_CAPACITY +
+                                        JSON_ARRAY_SIZE(ONECALL_DAILY_MAX_ENTRIES) +
+                                        ONECALL_DAILY_MAX_ENTRIES * ONECALL_DAILY_ENTRY_CAPACITY;
+
+// Everything a rendered frame depends on besides latestWeather and uiMode.
+struct DisplayInputs
+{
+    float indoorTemp{NAN};
+    float indoorHumidity{NAN};
+    bool indoorValid{false};
+    float batteryLevel{0.0F};
+    char wifiSsid[33]{}; // empty while disconnected
+    char errorBadge[48]{}; // last fetch failure and retry time; empty when healthy
+    time_t renderedAt{}; // wall clock used for the data age shown on screen
+};
+
+// State that has to survive deep sleep. RTC slow memory is zeroed on a cold
+// boot, so `magic` distinguishes a wake from a fresh start.
+struct RetainedState
+{
+    uint32_t magic;
+    WeatherSnapshot weather;
+    uint8_t activeLocation;
+    uint8_t uiMode;
+    time_t lastWeatherEpoch[MAX_LOCATIONS];
+    time_t lastIndoorEpoch;
+    // The frame on the panel, so it can be recomposed and diffed after waking.
+    bool panelShowsUi;
+    uint8_t shownUiMode;
+    DisplayInputs shownInputs;
+    // Awake-time accounting for the power log.
+    time_t dutyWindowStart;
+    uint32_t dutyAwakeMs;
+    bool oneCallRejected;
+    FetchScheduler fetchScheduler;
+    BatteryModel batteryModel;
+};
+static_assert(std::is_trivially_copyable<RetainedState>::value,
+              "RetainedState is kept as raw bytes in RTC memory across deep sleep");
+
+// An icon PNG downloaded by the network task into PSRAM, written to SD and
+// baked by the UI core afterwards.
+struct IconDownload
+{
+    uint8_t *data{nullptr};
+    size_t size{0};
+};
 
-struct DailyForecast
+// Steps of the network half of a weather update; see runFetchJob().
+enum class FetchStage : uint8_t
 {
-    time_t timestamp{};
-    float minTemperature{NAN};
-    float maxTemperature{NAN};
-    String summary;
-    String iconCode;
-    int iconId{0};
+    Connecting,
+    Requesting,
+    Icons,
+    Done,
 };
 
-struct WeatherSnapshot
+// One configured location as the network task sees it.
+struct FetchTarget
 {
-    float outdoorTemperature{NAN};
-    String outdoorDescription;
-    DailyForecast days[3];
-    time_t updatedAt{};
-    String currentIconCode;
-    int currentIconId{0};
+    float latitude;
+    float longitude;
+    bool wanted;  // input: due in this cycle
+    bool fetched; // result: its snapshot is complete
 };
 
-struct DayAggregate
+// Everything one weather fetch reads and produces. While netWorker runs the
+// job, the network task owns it; the UI core fills the inputs before start()
+// and reads the results after takeResult(), never in between.
+struct FetchJob
 {
-    float minTemperature{std::numeric_limits<float>::infinity()};
-    float maxTemperature{-std::numeric_limits<float>::infinity()};
-    String description;
-    String iconCode;
-    int iconId{0};
-    time_t localTimestamp{};
-    int yyyymmdd{0};
-    bool hasData{false};
+    // Inputs. Each wanted location's snapshot is overwritten by its responses
+    // (the shown one starts as a copy of latestWeather); the icon flags say
+    // which OWM codes the UI could not find in the atlas, the manifest or on SD.
+    FetchTarget targets[MAX_LOCATIONS];
+    WeatherSnapshot snapshots[MAX_LOCATIONS];
+    // Location the requests are currently for.
+    uint8_t location;
+    bool iconMissing[OWM_ICON_CODE_COUNT];
+    bool preloadFullIconSet;
+    // Results.
+    FetchFailure failure;
+    String errorMessage;
+    // Status of the most recent request; <= 0 means it never got an answer.
+    int httpStatus;
+    // Server time from the most recent response (HTTP Date header).
+    time_t serverEpoch;
+    char ssid[33];
+    WifiConnectReport wifi;
+    uint32_t radioMs;
+    PerfLog perf;
+    IconDownload icons[OWM_ICON_CODE_COUNT];
+
+    const FetchTarget &target() const { return targets[location]; }
+    WeatherSnapshot &snapshot() { return snapshots[location]; }
+};
+
+// Reader handed to deserializeJson(): pulls bytes from the HTTP stream and stops
+// once `remaining` hits zero, flagging the response as truncated.
+struct CappedStreamReader
+{
+    Stream *source;
+    size_t remaining;
+    size_t consumed{0};
+    bool truncated{false};
+
+    int read()
+    {
+        char c;
+        return readBytes(&c, 1) == 1 ? static_cast<unsigned char>(c) : -1;
+    }
+
+    size_t readBytes(char *buffer, size_t length)
+    {
+        if (remaining == 0)
+        {
+            truncated = true;
+            return 0;
+        }
+        const size_t n = source->readBytes(buffer, std::min(length, remaining));
+        remaining -= n;
+        consumed += n;
+        return n;
+    }
 };
 
 M5EPD_Canvas canvas(&M5.EPD);
+TextRenderer textRenderer(canvas);
+GlyphAtlas glyphAtlas;
+TextLayoutEngine textLayout(textRenderer);
+// Static chrome of each view, keyed by ChromeLayer; see beginFrame().
+enum class ChromeLayer : uint8_t
+{
+    Dashboard,
+    Detail,
+    Timeline,
+    ClimateHistory,
+};
+LayerCache chromeLayers(FRAME_BYTES, "chrome layer");
+// Finished frames of the tap-cycle views, keyed by UI mode, all drawn from the
+// inputs on the panel (shownInputs); see prerenderNextView().
+LayerCache viewFrames(FRAME_BYTES, "pre-rendered view", PRERENDER_PSRAM_RESERVE);
+// Keep-alive connections for the current Wi-Fi window; closed in powerDownWifi().
+ConnectionPool connectionPool;
 bool canvasReady = false;
 bool fontReady = false;
 bool sdReady = false;
+IconAtlas iconAtlas;
+bool iconAtlasReady = false;
+IconManifest iconManifest;
+bool iconManifestReady = false;
+ClimateHistory climateHistory;
+bool climateHistoryReady = false;
+// Phase timings of the update cycle in progress; see endUpdateCycle().
+PerfLog perfLog;
+// Charge estimate and learned cycle costs; stretches the update intervals.
+BatteryModel batteryModel;
+// Snapshot of the location the views show. The others stay on SD (see
+// locationSnapshotPath()) until a tap on the dashboard title selects them.
 WeatherSnapshot latestWeather;
-uint32_t lastWeatherUpdate = 0;
-uint32_t lastIndoorUpdate = 0;
-String lastErrorMessage;
-// UI mode: 0 = main dashboard, 1..3 = detailed forecast for day index-1
+uint8_t activeLocation = 0;
+// Schedule in wall-clock seconds so it stays meaningful across deep sleep,
+// where millis() restarts from zero. 0 means the location is due.
+time_t lastWeatherEpoch[MAX_LOCATIONS] = {};
+time_t lastIndoorEpoch = 0;
+// Weather fetches run on their own task on core 0, so rendering and touch on
+// core 1 never wait for the network; fetchJob is the mailbox between them.
+NetWorker netWorker;
+FetchJob fetchJob;
+// The configured One Call API refused our key; use the two-request path until
+// reboot. Written by the network task, saved only while no fetch runs.
+bool oneCallRejected = false;
+// Retry timing after failed fetches and the hourly radio-on budget.
+FetchScheduler fetchScheduler;
+// Full-screen status text currently on the panel (only while !panelShowsUi).
+String shownStatusMessage;
+// UI mode: see uiModeCount()
 uint8_t uiMode = 0;
-bool wasTouching = false;
+// Gestures from the GT911 reader task.
+TouchInput touchInput;
 uint32_t lastTouchTime = 0;
 bool pendingFullRefresh = false;
+// Copy of the frame last sent to the panel (PSRAM), used to diff the next one.
+uint8_t *lastPushedFrame = nullptr;
+// Packed rows of one dirty rect on their way to the controller (PSRAM).
+uint8_t *partialWriteScratch = nullptr;
+bool lastPushedFrameValid = false;
+uint8_t partialRefreshCount = 0;
+// What the panel currently shows, recorded by renderUi() for the deep-sleep replay.
+bool panelShowsUi = false;
+uint8_t shownUiMode = 0;
+DisplayInputs shownInputs;
+// Awake time since the start of the current one-hour accounting window.
+time_t dutyWindowStart = 0;
+uint32_t dutyAwakeMs = 0;
+uint32_t awakeSinceMs = 0;
+RTC_DATA_ATTR RetainedState retained;
 
 // Forward declare renderDisplay so renderUi can call it before definition
-void renderDisplay(float indoorTemp, float indoorHumidity, bool indoorValid);
+void renderDisplay(const DisplayInputs &inputs);
+
+// Copies a (possibly null) C string into a fixed-size field, trimming any
+// UTF-8 sequence that the truncation would cut in half.
+template <size_t N>
+void copyText(char (&dest)[N], const char *src)
+{
+    snprintf(dest, N, "%s", src != nullptr ? src : "");
+    size_t len = strlen(dest);
+    if (len == N - 1)
+    {
+        size_t start = len;
+        while (start > 0 && (static_cast<unsigned char>(dest[start - 1]) & 0xC0) == 0x80)
+        {
+            --start;
+        }
+        if (start > 0 && (static_cast<unsigned char>(dest[start - 1]) & 0x80) != 0)
+        {
+            const unsigned char lead = static_cast<unsigned char>(dest[start - 1]);
+            const size_t expected = (lead & 0xE0) == 0xC0 ? 2 : (lead & 0xF0) == 0xE0 ? 3 : 4;
+            if (len - (start - 1) < expected)
+            {
+                dest[start - 1] = '\0';
+            }
+        }
+    }
+}
+
+// -------- Wall clock --------
+// The system clock survives deep sleep; across power loss it is seeded from the
+// BM8563, which in turn is corrected from OpenWeather's HTTP Date header.
+time_t currentEpoch()
+{
+    return halEpochNow();
+}
+
+time_t epochFromUtc(int year, int month, int day, int hour, int minute, int second)
+{
+    // Days-from-civil; avoids depending on the TZ setting behind mktime().
+    year -= month <= 2 ? 1 : 0;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153U * static_cast<unsigned>(month + (month > 2 ? -3 : 9)) + 2U) / 5U + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365U + yearOfEra / 4U - yearOfEra / 100U + dayOfYear;
+    const long days = era * 146097L + static_cast<long>(dayOfEra) - 719468L;
+    return static_cast<time_t>(days) * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+// Parses an RFC 7231 date such as "Sun, 06 Nov 1994 08:49:37 GMT". Returns 0 on failure.
+time_t parseHttpDate(const String &value)
+{
+    int day = 0;
+    int year = 0;
+    int hour = 0;
+    int minute = 0;
+    int second = 0;
+    char monthName[4] = {};
+    if (sscanf(value.c_str(), "%*3s, %d %3s %d %d:%d:%d", &day, monthName, &year, &hour, &minute, &second) != 6)
+    {
+        return 0;
+    }
+    static const char MONTHS[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    const char *match = strstr(MONTHS, monthName);
+    if (match == nullptr || strlen(monthName) != 3 || (match - MONTHS) % 3 != 0)
+    {
+        return 0;
+    }
+    return epochFromUtc(year, static_cast<int>(match - MONTHS) / 3 + 1, day, hour, minute, second);
+}
+
+void setSystemClock(time_t epoch)
+{
+    halSetEpoch(epoch);
+}
+
+void loadClockFromRtc()
+{
+    rtc_date_t date;
+    rtc_time_t clock;
+    M5.RTC.getDate(&date);
+    M5.RTC.getTime(&clock);
+    const time_t epoch = epochFromUtc(date.year, date.mon, date.day, clock.hour, clock.min, clock.sec);
+    if (epoch < MIN_VALID_EPOCH)
+    {
+        Serial.println("[Clock] RTC not set yet; waiting for the first weather fetch.");
+        return;
+    }
+    setSystemClock(epoch);
+    Serial.printf("[Clock] System time restored from RTC: %ld\n", (long)epoch);
+}
+
+// Moves the system clock and the BM8563 to server time. Schedule timestamps
+// shift by the same amount so the jump never makes an update look overdue.
+void syncClock(time_t serverEpoch)
+{
+    if (serverEpoch < MIN_VALID_EPOCH)
+    {
+        return;
+    }
+    const time_t delta = serverEpoch - currentEpoch();
+    if (delta > -2 && delta < 2)
+    {
+        return;
+    }
+    setSystemClock(serverEpoch);
+    for (time_t &epoch : lastWeatherEpoch)
+    {
+        epoch += delta;
+    }
+    lastIndoorEpoch += delta;
+    dutyWindowStart += delta;
+
+    struct tm utc;
+    gmtime_r(&serverEpoch, &utc);
+    rtc_date_t date;
+    date.year = static_cast<int16_t>(utc.tm_year + 1900);
+    date.mon = static_cast<int8_t>(utc.tm_mon + 1);
+    date.day = static_cast<int8_t>(utc.tm_mday);
+    date.week = static_cast<int8_t>(utc.tm_wday);
+    rtc_time_t clock;
+    clock.hour = static_cast<int8_t>(utc.tm_hour);
+    clock.min = static_cast<int8_t>(utc.tm_min);
+    clock.sec = static_cast<int8_t>(utc.tm_sec);
+    M5.RTC.setDate(&date);
+    M5.RTC.setTime(&clock);
+    Serial.printf("[Clock] Synced to server time (adjusted by %ld s).\n", (long)delta);
+}
 
 // Ensure SD is initialised before asset loads
 bool ensureSdReady()
@@ -131,18 +570,68 @@ void applyConfigDefaults()
 {
     CFG_WIFI_SSID = DEFAULT_WIFI_SSID;
     CFG_WIFI_PASSWORD = DEFAULT_WIFI_PASSWORD;
+    CFG_WIFI_EXTRA_NETWORK_COUNT = 0;
+    CFG_WIFI_STATIC_IP = StaticIpConfig();
     CFG_OWM_API_KEY = DEFAULT_OWM_API_KEY;
-    CFG_OWM_LATITUDE = DEFAULT_OWM_LATITUDE;
-    CFG_OWM_LONGITUDE = DEFAULT_OWM_LONGITUDE;
+    CFG_LOCATIONS[0] = WeatherLocation{String(), DEFAULT_OWM_LATITUDE, DEFAULT_OWM_LONGITUDE, 0};
+    CFG_LOCATION_COUNT = 1;
     CFG_OWM_UNITS = DEFAULT_OWM_UNITS;
     CFG_OWM_LANGUAGE = DEFAULT_OWM_LANGUAGE;
+    CFG_OWM_BASE_URL = DEFAULT_OWM_BASE_URL;
+    CFG_OWM_ICON_BASE_URL = DEFAULT_OWM_ICON_BASE_URL;
     CFG_WEATHER_UPDATE_INTERVAL = DEFAULT_WEATHER_UPDATE_INTERVAL;
     CFG_INDOOR_UPDATE_INTERVAL = DEFAULT_INDOOR_UPDATE_INTERVAL;
+    CFG_SLEEP_MODE = DEFAULT_SLEEP_MODE;
+    CFG_WEATHER_BACKEND = DEFAULT_WEATHER_BACKEND;
+    CFG_FORECAST_DAYS = DEFAULT_FORECAST_DAYS;
+    CFG_TARGET_RUNTIME_DAYS = DEFAULT_TARGET_RUNTIME_DAYS;
+    CFG_LOW_BATTERY_PERCENT = DEFAULT_LOW_BATTERY_PERCENT;
+}
+
+SleepMode parseSleepMode(const char *value)
+{
+    if (value == nullptr)
+    {
+        return DEFAULT_SLEEP_MODE;
+    }
+    if (strcmp(value, "none") == 0) return SleepMode::None;
+    if (strcmp(value, "light") == 0) return SleepMode::Light;
+    if (strcmp(value, "deep") == 0) return SleepMode::Deep;
+    Serial.printf("[Config] Unknown power.sleep \"%s\"; using default.\n", value);
+    return DEFAULT_SLEEP_MODE;
+}
+
+WeatherBackend parseWeatherBackend(const char *value)
+{
+    if (value == nullptr)
+    {
+        return DEFAULT_WEATHER_BACKEND;
+    }
+    if (strcmp(value, "forecast") == 0) return WeatherBackend::Forecast;
+    if (strcmp(value, "onecall") == 0 || strcmp(value, "onecall2.5") == 0) return WeatherBackend::OneCall25;
+    if (strcmp(value, "onecall3") == 0 || strcmp(value, "onecall3.0") == 0) return WeatherBackend::OneCall30;
+    Serial.printf("[Config] Unknown openweathermap.api \"%s\"; using default.\n", value);
+    return DEFAULT_WEATHER_BACKEND;
+}
+
+// "http://192.168.1.20:8080/" -> "http://192.168.1.20:8080", so paths can be appended.
+String trimBaseUrl(const char *value)
+{
+    String url(value == nullptr ? "" : value);
+    url.trim();
+    while (url.endsWith("/"))
+    {
+        url.remove(url.length() - 1);
+    }
+    return url;
 }
 
 bool loadConfigFromSD()
 {
     applyConfigDefaults();
+    // Titles and card frames depend on the configuration.
+    chromeLayers.invalidate();
+    viewFrames.invalidate();
     if (!ensureSdReady())
     {
         Serial.println("[Config] SD not ready; using defaults.");
@@ -173,15 +662,70 @@ bool loadConfigFromSD()
     {
         if (wifi["ssid"]) CFG_WIFI_SSID = String(wifi["ssid"].as<const char*>());
         if (wifi["password"]) CFG_WIFI_PASSWORD = String(wifi["password"].as<const char*>());
+        for (JsonObject network : wifi["networks"].as<JsonArray>())
+        {
+            if (CFG_WIFI_EXTRA_NETWORK_COUNT < MAX_WIFI_NETWORKS - 1 && network["ssid"])
+            {
+                WifiNetwork &extra = CFG_WIFI_EXTRA_NETWORKS[CFG_WIFI_EXTRA_NETWORK_COUNT++];
+                extra.ssid = String(network["ssid"].as<const char *>());
+                extra.password = String(network["password"] | "");
+            }
+        }
+        JsonObject staticIp = wifi["static"].as<JsonObject>();
+        if (!staticIp.isNull())
+        {
+            StaticIpConfig &config = CFG_WIFI_STATIC_IP;
+            config.enabled = config.ip.fromString(staticIp["ip"] | "") && config.gateway.fromString(staticIp["gateway"] | "") &&
+                             config.subnet.fromString(staticIp["subnet"] | "255.255.255.0");
+            if (!config.dns.fromString(staticIp["dns"] | ""))
+            {
+                config.dns = config.gateway;
+            }
+            if (!config.enabled)
+            {
+                Serial.println("[Config] wifi.static needs valid ip and gateway; using DHCP.");
+            }
+        }
     }
     JsonObject owm = doc["openweathermap"].as<JsonObject>();
     if (!owm.isNull())
     {
         if (owm["apiKey"]) CFG_OWM_API_KEY = String(owm["apiKey"].as<const char*>());
-        if (owm["lat"]) CFG_OWM_LATITUDE = owm["lat"].as<float>();
-        if (owm["lon"]) CFG_OWM_LONGITUDE = owm["lon"].as<float>();
+        if (owm["lat"]) CFG_LOCATIONS[0].latitude = owm["lat"].as<float>();
+        if (owm["lon"]) CFG_LOCATIONS[0].longitude = owm["lon"].as<float>();
         if (owm["units"]) CFG_OWM_UNITS = String(owm["units"].as<const char*>());
         if (owm["lang"]) CFG_OWM_LANGUAGE = String(owm["lang"].as<const char*>());
+        if (owm["api"]) CFG_WEATHER_BACKEND = parseWeatherBackend(owm["api"].as<const char *>());
+        if (owm["baseUrl"]) CFG_OWM_BASE_URL = trimBaseUrl(owm["baseUrl"].as<const char *>());
+        if (owm["iconBaseUrl"]) CFG_OWM_ICON_BASE_URL = trimBaseUrl(owm["iconBaseUrl"].as<const char *>());
+    }
+    size_t locationCount = 0;
+    for (JsonObject location : doc["locations"].as<JsonArray>())
+    {
+        if (locationCount == MAX_LOCATIONS)
+        {
+            Serial.printf("[Config] Only the first %u locations are used.\n", (unsigned)MAX_LOCATIONS);
+            break;
+        }
+        if (!location["lat"] || !location["lon"])
+        {
+            Serial.println("[Config] Skipping a location without lat/lon.");
+            continue;
+        }
+        WeatherLocation &entry = CFG_LOCATIONS[locationCount++];
+        entry.name = String(location["name"] | "");
+        entry.latitude = location["lat"].as<float>();
+        entry.longitude = location["lon"].as<float>();
+        entry.updateInterval = location["weatherHours"] ? (uint32_t)(location["weatherHours"].as<float>() * 60.0F * 60.0F * 1000.0F) : 0;
+    }
+    if (locationCount > 0)
+    {
+        CFG_LOCATION_COUNT = locationCount;
+    }
+    JsonObject forecast = doc["forecast"].as<JsonObject>();
+    if (!forecast.isNull())
+    {
+        if (forecast["days"]) CFG_FORECAST_DAYS = (uint8_t)constrain(forecast["days"].as<int>(), 1, (int)MAX_FORECAST_DAYS);
     }
     JsonObject upd = doc["update"].as<JsonObject>();
     if (!upd.isNull())
@@ -189,10 +733,59 @@ bool loadConfigFromSD()
         if (upd["weatherHours"]) CFG_WEATHER_UPDATE_INTERVAL = (uint32_t)(upd["weatherHours"].as<uint32_t>() * 60UL * 60UL * 1000UL);
         if (upd["indoorMinutes"]) CFG_INDOOR_UPDATE_INTERVAL = (uint32_t)(upd["indoorMinutes"].as<uint32_t>() * 60UL * 1000UL);
     }
+    JsonObject power = doc["power"].as<JsonObject>();
+    if (!power.isNull())
+    {
+        if (power["sleep"]) CFG_SLEEP_MODE = parseSleepMode(power["sleep"].as<const char *>());
+        if (power["targetDays"]) CFG_TARGET_RUNTIME_DAYS = (uint16_t)constrain(power["targetDays"].as<int>(), 0, 365);
+        if (power["lowBatteryPercent"]) CFG_LOW_BATTERY_PERCENT = constrain(power["lowBatteryPercent"].as<float>(), 0.0F, 50.0F);
+    }
     Serial.println("[Config] Loaded configuration from SD.");
     return true;
 }
 
+// Custom icons are keyed by name ("c:rain"), OWM icons by their code ("10d").
+String iconKeyForOwmId(int id)
+{
+    String path = iconPathForOwmId(id);
+    const int slash = path.lastIndexOf('/');
+    const int dot = path.lastIndexOf('.');
+    return String("c:") + path.substring(slash + 1, dot);
+}
+
+bool ensureIconAtlas()
+{
+    if (iconAtlasReady)
+    {
+        return true;
+    }
+    if (!ensureSdReady())
+    {
+        return false;
+    }
+    SD.mkdir("/icons");
+    iconAtlasReady = iconAtlas.begin(SD, ICON_ATLAS_PATH);
+    return iconAtlasReady;
+}
+
+// Blits a pre-dithered tile, baking it from `pngPath` the first time it is needed.
+bool drawAtlasIcon(const String &key, const String &pngPath, int x, int y, int maxW, int maxH)
+{
+    if (!ensureIconAtlas())
+    {
+        return false;
+    }
+    if (!iconAtlas.contains(key.c_str(), maxW, maxH))
+    {
+        if (!SD.exists(pngPath) || !iconAtlas.bake(key.c_str(), pngPath.c_str(), maxW, maxH))
+        {
+            return false;
+        }
+    }
+    return iconAtlas.draw(static_cast<uint8_t *>(canvas.frameBuffer()), CANVAS_WIDTH, CANVAS_HEIGHT, key.c_str(), x, y,
+                          maxW, maxH);
+}
+
 bool drawWeatherIcon(int id, int x, int y, int maxW, int maxH)
 {
     if (!ensureSdReady())
@@ -200,12 +793,16 @@ bool drawWeatherIcon(int id, int x, int y, int maxW, int maxH)
         return false;
     }
     String path = iconPathForOwmId(id);
+    // Try the atlas first; PNGs are baked into it on first use
+    if (path.endsWith(".png") && drawAtlasIcon(iconKeyForOwmId(id), path, x, y, maxW, maxH))
+    {
+        return true;
+    }
     if (!SD.exists(path))
     {
         Serial.printf("[Icon] Missing asset: %s\n", path.c_str());
         return false;
     }
-    // Try PNG first
     if (path.endsWith(".png"))
     {
         return canvas.drawPngFile(SD, path.c_str(), x, y, maxW, maxH, 0, 0, 1.0, 127);
@@ -225,152 +822,397 @@ String owmIconPath(const String &code)
 
 String owmIconUrl(const String &code)
 {
-    return String("http://openweathermap.org/img/wn/") + code + "@2x.png";
+    return CFG_OWM_ICON_BASE_URL + "/img/wn/" + code + "@2x.png";
 }
 
-bool ensureIconCached(const String &code)
+bool ensureIconManifest()
 {
-    if (code.length() == 0)
+    if (iconManifestReady)
     {
-        return false;
+        return true;
     }
     if (!ensureSdReady())
     {
         return false;
     }
     SD.mkdir("/icons");
-    const String path = owmIconPath(code);
-    if (SD.exists(path))
+    if (!iconManifest.begin(SD, ICON_MANIFEST_PATH))
     {
-        return true;
+        // Adopt PNGs left by an older build or a lost manifest, once; from then
+        // on the manifest alone says what is on SD.
+        for (const char *code : OWM_ICON_CODES)
+        {
+            if (SD.exists(owmIconPath(code)))
+            {
+                iconManifest.add(code);
+            }
+        }
+        iconManifest.save();
     }
-    Serial.printf("[Icon] Downloading %s -> %s\n", code.c_str(), path.c_str());
+    iconManifestReady = true;
+    return true;
+}
+
+// Collects a PNG body into a PSRAM buffer of fixed size.
+class IconBufferStream : public Stream
+{
+public:
+    IconBufferStream(uint8_t *data, size_t capacity) : data(data), capacity(capacity) {}
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t length) override
+    {
+        const size_t n = std::min(length, capacity - size);
+        memcpy(data + size, buffer, n);
+        size += n;
+        overflowed = overflowed || n < length;
+        return n;
+    }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+
+    uint8_t *data;
+    size_t capacity;
+    size_t size{0};
+    bool overflowed{false};
+};
+
+// Downloads one OWM icon PNG into PSRAM over the pooled icon-server
+// connection. Runs on the network task, which never touches the SD card.
+bool downloadOwmIcon(const char *code, IconDownload &download)
+{
+    Serial.printf("[Icon] Downloading %s\n", code);
 
-    HTTPClient http;
     const String url = owmIconUrl(code);
-    http.setTimeout(7000);
-    if (!http.begin(url))
+    RequestTimings timings;
+    HTTPClient *http = connectionPool.begin(url, timings);
+    if (http == nullptr)
     {
-        Serial.println("[Icon] HTTP begin failed");
+        Serial.println("[Icon] HTTP connect failed");
         return false;
     }
-    const int codeHttp = http.GET();
+    http->setTimeout(7000);
+    const uint32_t sendStart = millis();
+    const int codeHttp = http->GET();
+    timings.firstByteMs = millis() - sendStart;
     if (codeHttp != HTTP_CODE_OK)
     {
         Serial.printf("[Icon] HTTP %d for %s\n", codeHttp, url.c_str());
-        http.end();
+        connectionPool.end(http, false);
         return false;
     }
-    File f = SD.open(path, FILE_WRITE);
-    if (!f)
+    const int declaredSize = http->getSize();
+    const size_t capacity = declaredSize > 0 ? std::min<size_t>(declaredSize, MAX_ICON_BYTES) : MAX_ICON_BYTES;
+    uint8_t *data = static_cast<uint8_t *>(ps_malloc(capacity));
+    if (data == nullptr)
     {
-        Serial.println("[Icon] SD open failed");
-        http.end();
+        Serial.println("[Icon] No memory for the download");
+        connectionPool.end(http, false);
         return false;
     }
-    const size_t written = http.writeToStream(&f);
-    f.close();
-    http.end();
-    Serial.printf("[Icon] Saved %u bytes to %s\n", (unsigned)written, path.c_str());
-    return written > 0;
+    IconBufferStream buffer(data, capacity);
+    const uint32_t transferStart = millis();
+    const int written = http->writeToStream(&buffer);
+    timings.transferMs = millis() - transferStart;
+    // writeToStream() stops exactly at the end of the body, so the connection can carry the next icon.
+    connectionPool.end(http, written > 0 && !buffer.overflowed);
+    timings.log("Icon");
+    if (written <= 0 || buffer.overflowed)
+    {
+        Serial.printf("[Icon] Download of %s failed or exceeded %u bytes\n", code, (unsigned)MAX_ICON_BYTES);
+        free(data);
+        return false;
+    }
+    download = IconDownload{data, buffer.size};
+    return true;
 }
 
-bool drawOwmIcon(const String &code, int x, int y, int maxW, int maxH)
+void freeIconDownloads(FetchJob &job)
 {
-    if (code.length() == 0)
+    for (IconDownload &download : job.icons)
     {
-        return false;
+        free(download.data);
+        download = IconDownload();
     }
-    if (!ensureSdReady())
+}
+
+// Writes a PNG the network task downloaded to `path`.
+bool saveIconDownload(const IconDownload &download, const String &path)
+{
+    File f = SD.open(path, FILE_WRITE);
+    if (!f)
     {
+        Serial.println("[Icon] SD open failed");
         return false;
     }
-    const String path = owmIconPath(code);
-    if (!SD.exists(path))
+    const size_t written = f.write(download.data, download.size);
+    f.close();
+    Serial.printf("[Icon] Saved %u bytes to %s\n", (unsigned)written, path.c_str());
+    if (written != download.size)
     {
+        SD.remove(path);
         return false;
     }
-    return canvas.drawPngFile(SD, path.c_str(), x, y, maxW, maxH, 0, 0, 1.0, 127);
+    return true;
 }
 
-bool connectToWifi()
+// Makes sure `code` is baked into the atlas. Icons already baked are answered
+// from RAM; otherwise the manifest says whether the PNG is on SD or has to
+// come from `download` (the network task's copy, if it fetched one).
+bool cacheOwmIcon(const char *code, const IconDownload *download)
 {
-    if (WiFi.status() == WL_CONNECTED)
+    if (iconAtlas.contains(code, DETAIL_ICON_BOX_W, DETAIL_ICON_BOX_H))
     {
-        Serial.printf("[WiFi] Already connected to %s\n", WiFi.SSID().c_str());
         return true;
     }
-
-    Serial.println("[WiFi] Connecting to configured network...");
-    WiFi.mode(WIFI_STA);
-    WiFi.setSleep(false);
-    WiFi.begin(CFG_WIFI_SSID.c_str(), CFG_WIFI_PASSWORD.c_str());
-
-    const uint32_t start = millis();
-    while (WiFi.status() != WL_CONNECTED)
+    const String path = owmIconPath(code);
+    if (!iconManifest.contains(code))
     {
-        if (millis() - start > 30000UL)
+        if (download == nullptr || download->data == nullptr || !saveIconDownload(*download, path))
         {
-            Serial.println("[WiFi] Connection timed out; will retry later.");
-            WiFi.disconnect(true);
             return false;
         }
-        delay(500);
+        iconManifest.add(code);
     }
-
-    Serial.printf("[WiFi] Connected to %s\n", WiFi.SSID().c_str());
-    return true;
+    // Decode while the data is fresh, so renders never pay for PNG decoding
+    if (iconAtlas.bake(code, path.c_str(), DETAIL_ICON_BOX_W, DETAIL_ICON_BOX_H))
+    {
+        return true;
+    }
+    // Listed but unusable (deleted or corrupt): fetch it again next time.
+    iconManifest.remove(code);
+    SD.remove(path);
+    return false;
 }
 
-void powerDownWifi()
+// Bound on the unique codes collectIconCodes() can return.
+constexpr size_t MAX_WANTED_ICON_CODES = MAX_LOCATIONS * (1 + 2 * MAX_FORECAST_DAYS) + OWM_ICON_CODE_COUNT;
+
+// Unique icon codes the snapshots the job fetched need, plus, with `fullSet`,
+// every other OWM code. `wanted` must hold MAX_WANTED_ICON_CODES.
+size_t collectIconCodes(const FetchJob &job, bool fullSet, const char **wanted)
 {
-    if (WiFi.getMode() == WIFI_MODE_NULL)
+    size_t wantedCount = 0;
+    auto want = [&](const char *code) {
+        if (code[0] == '\0')
+        {
+            return;
+        }
+        for (size_t i = 0; i < wantedCount; ++i)
+        {
+            if (strcmp(wanted[i], code) == 0)
+            {
+                return;
+            }
+        }
+        wanted[wantedCount++] = code;
+    };
+    for (size_t location = 0; location < MAX_LOCATIONS; ++location)
     {
-        return;
+        if (!job.targets[location].fetched)
+        {
+            continue;
+        }
+        const WeatherSnapshot &snapshot = job.snapshots[location];
+        want(snapshot.currentIconCode);
+        for (size_t i = 0; i < CFG_FORECAST_DAYS; ++i)
+        {
+            want(snapshot.days[i].iconCode);
+            want(snapshot.days[i].nightIconCode);
+        }
+        // Timeline codes are all in the OWM set, so this bounds the unique codes.
+        for (size_t i = 0; i < snapshot.timeline.count; ++i)
+        {
+            want(iconCodeForCondition(snapshot.timeline.condition[i]));
+        }
     }
-
-    Serial.println("[WiFi] Disabling radio to conserve power.");
-    WiFi.disconnect(true);
-    WiFi.mode(WIFI_MODE_NULL);
-    WiFi.setSleep(true);
+    if (fullSet)
+    {
+        for (const char *code : OWM_ICON_CODES)
+        {
+            want(code);
+        }
+    }
+    return wantedCount;
 }
 
-String buildApiUrl()
+int owmIconIndex(const char *code)
 {
-    String url = "https://api.openweathermap.org/data/2.5/onecall?lat=";
-    url += String(CFG_OWM_LATITUDE, 6);
-    url += "&lon=";
-    url += String(CFG_OWM_LONGITUDE, 6);
-    url += "&exclude=minutely,hourly,alerts&units=";
-    url += CFG_OWM_UNITS;
-    url += "&lang=";
-    url += CFG_OWM_LANGUAGE;
-    url += "&appid=";
-    url += CFG_OWM_API_KEY;
-    return url;
+    for (size_t i = 0; i < OWM_ICON_CODE_COUNT; ++i)
+    {
+        if (strcmp(OWM_ICON_CODES[i], code) == 0)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
 }
 
-template <typename Sensor>
-auto tryInitializeSensor(Sensor &sensor, int) -> decltype(sensor.Begin(), bool())
+// Before a fetch, on the UI core: flags the OWM codes the network task
+// should download if the new snapshots want them.
+void markMissingIcons(FetchJob &job)
 {
-    sensor.Begin();
-    return true;
+    const bool ready = ensureIconAtlas() && ensureIconManifest();
+    job.preloadFullIconSet = ready && !iconManifest.fullSetLoaded();
+    for (size_t i = 0; i < OWM_ICON_CODE_COUNT; ++i)
+    {
+        const char *code = OWM_ICON_CODES[i];
+        job.iconMissing[i] = ready && !iconAtlas.contains(code, DETAIL_ICON_BOX_W, DETAIL_ICON_BOX_H) &&
+                             !iconManifest.contains(code);
+    }
 }
 
-template <typename Sensor>
-auto tryInitializeSensor(Sensor &sensor, long) -> decltype(sensor.begin(), bool())
+// Download stage, on the network task. Missing PNGs are fetched back to back
+// over one keep-alive connection; once everything is baked, a cycle never
+// touches the icon server.
+void downloadMissingIcons(FetchJob &job)
 {
-    sensor.begin();
-    return true;
+    const char *wanted[MAX_WANTED_ICON_CODES];
+    const size_t wantedCount = collectIconCodes(job, job.preloadFullIconSet, wanted);
+    for (size_t i = 0; i < wantedCount; ++i)
+    {
+        const int index = owmIconIndex(wanted[i]);
+        if (index < 0 || !job.iconMissing[index])
+        {
+            continue;
+        }
+        if (!downloadOwmIcon(wanted[i], job.icons[index]))
+        {
+            // The server is likely unreachable; leave the rest for the next fetch.
+            break;
+        }
+    }
 }
 
-template <typename Sensor>
-bool tryInitializeSensor(Sensor &, ...)
+// Bake stage, on the UI core after a successful fetch: stores what the
+// network task downloaded and bakes every icon the new snapshots need, plus,
+// until the whole OWM set has been preloaded once, every other code too.
+void prefetchOwmIcons(const FetchJob &job)
 {
-    return false;
-}
+    if (!ensureIconAtlas() || !ensureIconManifest())
+    {
+        return;
+    }
 
-void initIndoorSensor()
+    const char *wanted[MAX_WANTED_ICON_CODES];
+    const bool preloadFullSet = !iconManifest.fullSetLoaded();
+    const size_t wantedCount = collectIconCodes(job, preloadFullSet, wanted);
+
+    const uint32_t start = millis();
+    size_t failed = 0;
+    for (size_t i = 0; i < wantedCount; ++i)
+    {
+        const int index = owmIconIndex(wanted[i]);
+        if (!cacheOwmIcon(wanted[i], index >= 0 ? &job.icons[index] : nullptr))
+        {
+            ++failed;
+        }
+    }
+
+    if (preloadFullSet)
+    {
+        bool complete = true;
+        for (const char *code : OWM_ICON_CODES)
+        {
+            complete = complete && iconAtlas.contains(code, DETAIL_ICON_BOX_W, DETAIL_ICON_BOX_H);
+        }
+        iconManifest.setFullSetLoaded(complete);
+    }
+    iconManifest.save();
+    Serial.printf("[Icon] Prefetch: %u code(s), %u unavailable, %lu ms%s\n", (unsigned)wantedCount, (unsigned)failed,
+                  (unsigned long)(millis() - start), preloadFullSet ? " (full set preload)" : "");
+}
+
+bool drawOwmIcon(const String &code, int x, int y, int maxW, int maxH)
+{
+    if (code.length() == 0)
+    {
+        return false;
+    }
+    return drawAtlasIcon(code, owmIconPath(code), x, y, maxW, maxH);
+}
+
+bool connectToWifi(WifiConnectReport &report)
+{
+    report = WifiConnectReport();
+    if (WiFi.status() == WL_CONNECTED)
+    {
+        Serial.printf("[WiFi] Already connected to %s\n", WiFi.SSID().c_str());
+        return true;
+    }
+
+    Serial.println("[WiFi] Connecting to configured network...");
+    WifiNetwork networks[MAX_WIFI_NETWORKS];
+    size_t networkCount = 0;
+    networks[networkCount++] = WifiNetwork{CFG_WIFI_SSID, CFG_WIFI_PASSWORD};
+    for (size_t i = 0; i < CFG_WIFI_EXTRA_NETWORK_COUNT; ++i)
+    {
+        networks[networkCount++] = CFG_WIFI_EXTRA_NETWORKS[i];
+    }
+    if (!connectWifi(networks, networkCount, CFG_WIFI_STATIC_IP, 30000UL, report))
+    {
+        Serial.printf("[WiFi] No connection after %lu ms (%s); will retry later.\n", (unsigned long)report.totalMs,
+                      wifiFailureText(report.failure));
+        WiFi.disconnect(true);
+        return false;
+    }
+
+    Serial.printf("[WiFi] Connected to %s\n", WiFi.SSID().c_str());
+    return true;
+}
+
+void powerDownWifi()
+{
+    if (WiFi.getMode() == WIFI_MODE_NULL)
+    {
+        return;
+    }
+
+    Serial.println("[WiFi] Disabling radio to conserve power.");
+    connectionPool.closeAll();
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_MODE_NULL);
+    WiFi.setSleep(true);
+}
+
+String buildApiUrl(WeatherBackend backend)
+{
+    String url = CFG_OWM_BASE_URL;
+    url += backend == WeatherBackend::OneCall30 ? "/data/3.0/onecall?lat=" : "/data/2.5/onecall?lat=";
+    url += String(fetchJob.target().latitude, 6);
+    url += "&lon=";
+    url += String(fetchJob.target().longitude, 6);
+    url += "&exclude=minutely,alerts&units=";
+    url += CFG_OWM_UNITS;
+    url += "&lang=";
+    url += CFG_OWM_LANGUAGE;
+    url += "&appid=";
+    url += CFG_OWM_API_KEY;
+    return url;
+}
+
+template <typename Sensor>
+auto tryInitializeSensor(Sensor &sensor, int) -> decltype(sensor.Begin(), bool())
+{
+    sensor.Begin();
+    return true;
+}
+
+template <typename Sensor>
+auto tryInitializeSensor(Sensor &sensor, long) -> decltype(sensor.begin(), bool())
+{
+    sensor.begin();
+    return true;
+}
+
+template <typename Sensor>
+bool tryInitializeSensor(Sensor &, ...)
+{
+    return false;
+}
+
+void initIndoorSensor()
 {
     auto &sensor = M5.SHT30;
     (void)tryInitializeSensor(sensor, 0);
@@ -415,6 +1257,39 @@ String formatTimestamp(time_t timestamp)
     return String(buffer);
 }
 
+// "Updated: <local time> (<age>)". The age is left out until the clock has
+// been set, since a snapshot loaded at boot may be hours or days old.
+String formatUpdatedLine(time_t renderedAt)
+{
+    if (latestWeather.updatedAt == 0)
+    {
+        return String("Updated: Pending");
+    }
+    String line = String("Updated: ") + formatTimestamp(latestWeather.updatedAt);
+    if (latestWeather.fetchedAt == 0 || renderedAt < MIN_VALID_EPOCH || renderedAt < latestWeather.fetchedAt)
+    {
+        return line;
+    }
+    const long ageMinutes = static_cast<long>(renderedAt - latestWeather.fetchedAt) / 60;
+    if (ageMinutes < 1)
+    {
+        line += " (just now)";
+    }
+    else if (ageMinutes < 60)
+    {
+        line += String(" (") + ageMinutes + " min ago)";
+    }
+    else if (ageMinutes < 48 * 60)
+    {
+        line += String(" (") + ageMinutes / 60 + " h ago)";
+    }
+    else
+    {
+        line += String(" (") + ageMinutes / (24 * 60) + " d ago)";
+    }
+    return line;
+}
+
 template <typename Sensor>
 auto tryReadWithGetTempData(Sensor &sensor, float &temperature, float &humidity, int)
     -> decltype(sensor.GetTempData(&temperature, &humidity), bool())
@@ -525,23 +1400,91 @@ bool readIndoorClimate(float &temperature, float &humidity)
     return true;
 }
 
+// One battery reading: the mean of 16 ADC samples without the highest and
+// lowest, which rejects the spikes the EPD and radio put on the rail.
+uint32_t readBatteryMillivolts()
+{
+    constexpr int samples = 16;
+    uint32_t sum = 0;
+    uint32_t lowest = UINT32_MAX;
+    uint32_t highest = 0;
+    for (int i = 0; i < samples; ++i)
+    {
+        const uint32_t mv = M5.getBatteryVoltage();
+        sum += mv;
+        lowest = std::min(lowest, mv);
+        highest = std::max(highest, mv);
+        delayMicroseconds(200);
+    }
+    return (sum - lowest - highest) / (samples - 2);
+}
+
 float readBatteryLevel()
 {
-    const float voltage = M5.getBatteryVoltage() / 1000.0F; // convert mV -> V
-    float percentage = (voltage - 3.0F) / (4.2F - 3.0F);
-    percentage = constrain(percentage, 0.0F, 1.0F);
-    return percentage * 100.0F;
+    if (!batteryModel.hasReading())
+    {
+        batteryModel.observe(readBatteryMillivolts(), currentEpoch());
+    }
+    return batteryModel.percent();
+}
+
+// Configured weather interval of a location, in ms.
+uint32_t locationUpdateInterval(size_t location)
+{
+    const uint32_t interval = CFG_LOCATIONS[location].updateInterval;
+    return interval != 0 ? interval : CFG_WEATHER_UPDATE_INTERVAL;
 }
 
-void drawBatteryIndicator(float level)
+// Weather cycles run as often as the most frequently updated location needs.
+uint32_t shortestUpdateInterval()
+{
+    uint32_t shortest = locationUpdateInterval(0);
+    for (size_t i = 1; i < CFG_LOCATION_COUNT; ++i)
+    {
+        shortest = std::min(shortest, locationUpdateInterval(i));
+    }
+    return shortest;
+}
+
+// Configured intervals, stretched by the battery model to meet power.targetDays.
+float intervalStretch()
+{
+    return batteryModel.stretch(static_cast<time_t>(shortestUpdateInterval() / 1000UL),
+                                static_cast<time_t>(CFG_INDOOR_UPDATE_INTERVAL / 1000UL), currentEpoch());
+}
+
+time_t weatherIntervalSeconds(size_t location)
+{
+    return static_cast<time_t>(locationUpdateInterval(location) / 1000UL * intervalStretch());
+}
+
+time_t indoorIntervalSeconds()
+{
+    return static_cast<time_t>(CFG_INDOOR_UPDATE_INTERVAL / 1000UL * intervalStretch());
+}
+
+constexpr int BATTERY_INDICATOR_WIDTH = 120;
+constexpr int BATTERY_INDICATOR_HEIGHT = 36;
+constexpr int BATTERY_INDICATOR_X = CANVAS_WIDTH - BATTERY_INDICATOR_WIDTH - 30;
+constexpr int BATTERY_INDICATOR_Y = 20;
+
+// Battery body and terminal; part of the dashboard chrome.
+void drawBatteryOutline()
 {
-    constexpr int indicatorWidth = 120;
-    constexpr int indicatorHeight = 36;
-    const int x = CANVAS_WIDTH - indicatorWidth - 30;
-    const int y = 20;
+    constexpr int x = BATTERY_INDICATOR_X;
+    constexpr int y = BATTERY_INDICATOR_Y;
+    canvas.drawRoundRect(x, y, BATTERY_INDICATOR_WIDTH, BATTERY_INDICATOR_HEIGHT, 6, COLOR_BLACK);
+    canvas.drawRect(x + BATTERY_INDICATOR_WIDTH, y + BATTERY_INDICATOR_HEIGHT / 2 - 6, 6, 12, COLOR_BLACK);
+    canvas.drawRect(x + 7, y + 7, BATTERY_INDICATOR_WIDTH - 14, BATTERY_INDICATOR_HEIGHT - 14, COLOR_BLACK);
+}
 
-    canvas.drawRoundRect(x, y, indicatorWidth, indicatorHeight, 6, COLOR_BLACK);
-    canvas.drawRect(x + indicatorWidth, y + indicatorHeight / 2 - 6, 6, 12, COLOR_BLACK);
+// Charge bar and percentage inside the outline.
+void drawBatteryIndicator(float level)
+{
+    constexpr int indicatorWidth = BATTERY_INDICATOR_WIDTH;
+    constexpr int indicatorHeight = BATTERY_INDICATOR_HEIGHT;
+    const int x = BATTERY_INDICATOR_X;
+    const int y = BATTERY_INDICATOR_Y;
 
     const int innerWidth = indicatorWidth - 14;
     const int innerHeight = indicatorHeight - 14;
@@ -549,16 +1492,155 @@ void drawBatteryIndicator(float level)
     const int innerY = y + 7;
     const int fillWidth = static_cast<int>((innerWidth) * (level / 100.0F));
 
-    canvas.drawRect(innerX, innerY, innerWidth, innerHeight, COLOR_BLACK);
     if (fillWidth > 0)
     {
         canvas.fillRect(innerX, innerY, fillWidth, innerHeight, COLOR_BLACK);
     }
 
-    canvas.setTextDatum(MC_DATUM);
+    textRenderer.setTextDatum(MC_DATUM);
+    setTextSizeCompat(2);
+    textRenderer.drawString(String(static_cast<int>(level + 0.5F)) + "%", x + indicatorWidth / 2, y + indicatorHeight / 2);
+    textRenderer.setTextDatum(TL_DATUM);
+}
+
+// White-on-black note right-aligned at `rightX`, so a failed fetch is visible
+// next to the stale data instead of replacing it.
+void drawErrorBadge(const DisplayInputs &inputs, int rightX, int y)
+{
+    if (inputs.errorBadge[0] == '\0')
+    {
+        return;
+    }
     setTextSizeCompat(2);
-    canvas.drawString(String(static_cast<int>(level + 0.5F)) + "%", x + indicatorWidth / 2, y + indicatorHeight / 2);
-    canvas.setTextDatum(TL_DATUM);
+    constexpr int padding = 8;
+    const int width = textRenderer.textWidth(inputs.errorBadge) + 2 * padding;
+    const int height = textRenderer.fontHeight() + 2 * padding;
+    canvas.fillRoundRect(rightX - width, y, width, height, 6, COLOR_BLACK);
+    textRenderer.setTextColor(COLOR_WHITE);
+    textRenderer.drawString(inputs.errorBadge, rightX - width + padding, y + padding);
+    textRenderer.setTextColor(COLOR_BLACK);
+}
+
+bool ensureFrameHistory()
+{
+    if (lastPushedFrame != nullptr)
+    {
+        return true;
+    }
+    lastPushedFrame = static_cast<uint8_t *>(ps_malloc(FRAME_BYTES));
+    if (lastPushedFrame == nullptr)
+    {
+        Serial.println("[Display] No PSRAM for frame history; partial refresh disabled.");
+    }
+    return lastPushedFrame != nullptr;
+}
+
+void rememberPushedFrame()
+{
+    const uint8_t *frame = static_cast<const uint8_t *>(canvas.frameBuffer());
+    if (frame == nullptr || !ensureFrameHistory())
+    {
+        lastPushedFrameValid = false;
+        return;
+    }
+    memcpy(lastPushedFrame, frame, FRAME_BYTES);
+    lastPushedFrameValid = true;
+}
+
+void pushFullFrame(m5epd_update_mode_t mode)
+{
+    canvas.pushCanvas(0, 0, mode);
+    rememberPushedFrame();
+    partialRefreshCount = 0;
+}
+
+// Loads one dirty rect of `frame` into controller memory. Full-width rects are
+// contiguous in the frame and go straight out; narrower ones are packed into
+// the scratch buffer strip by strip. False if there is no scratch buffer.
+bool writeDirtyRect(const uint8_t *frame, const DirtyRect &rect)
+{
+    const size_t frameStride = CANVAS_WIDTH / 2;
+    if (rect.x == 0 && rect.w == CANVAS_WIDTH)
+    {
+        M5.EPD.WritePartGram4bpp(0, rect.y, rect.w, rect.h, frame + rect.y * frameStride);
+        return true;
+    }
+    if (partialWriteScratch == nullptr)
+    {
+        partialWriteScratch = static_cast<uint8_t *>(ps_malloc(PARTIAL_WRITE_SCRATCH_BYTES));
+        if (partialWriteScratch == nullptr)
+        {
+            return false;
+        }
+    }
+    const size_t rowBytes = rect.w / 2;
+    const uint16_t stripRows = static_cast<uint16_t>(PARTIAL_WRITE_SCRATCH_BYTES / rowBytes);
+    for (uint16_t row = 0; row < rect.h; row += stripRows)
+    {
+        const uint16_t rows = std::min<uint16_t>(stripRows, rect.h - row);
+        for (uint16_t i = 0; i < rows; ++i)
+        {
+            memcpy(partialWriteScratch + i * rowBytes, frame + (rect.y + row + i) * frameStride + rect.x / 2,
+                   rowBytes);
+        }
+        M5.EPD.WritePartGram4bpp(rect.x, rect.y + row, rect.w, rows, partialWriteScratch);
+    }
+    return true;
+}
+
+void pushCanvasSmart()
+{
+    const uint8_t *frame = static_cast<const uint8_t *>(canvas.frameBuffer());
+    // On a low battery the ghosting-clearing GC16 passes wait; only changed
+    // regions are driven, with the non-flashing waveform.
+    const bool saving = batteryModel.lowBattery();
+    if (saving && (!lastPushedFrameValid || frame == nullptr))
+    {
+        pushFullFrame(PARTIAL_REFRESH_MODE);
+        pendingFullRefresh = false;
+        return;
+    }
+    // A view change pushes the whole frame with GL16, which replaces every pixel
+    // without the GC16 flash; the periodic ghosting pass and large changes use GC16.
+    if (!saving && (pendingFullRefresh || !lastPushedFrameValid || frame == nullptr ||
+                    partialRefreshCount >= PARTIAL_REFRESHES_BEFORE_FULL))
+    {
+        pushFullFrame(pendingFullRefresh ? UPDATE_MODE_GL16 : UPDATE_MODE_GC16);
+        pendingFullRefresh = false;
+        return;
+    }
+
+    DirtyRect rects[MAX_DIRTY_RECTS];
+    const size_t count = computeDirtyRects(lastPushedFrame, frame, CANVAS_WIDTH, CANVAS_HEIGHT, rects, MAX_DIRTY_RECTS);
+    if (count == 0)
+    {
+        Serial.println("[Display] Frame unchanged; skipping EPD refresh.");
+        return;
+    }
+
+    const uint32_t area = dirtyArea(rects, count);
+    const uint32_t coveragePercent = area * 100UL / (static_cast<uint32_t>(CANVAS_WIDTH) * CANVAS_HEIGHT);
+    if (!saving && coveragePercent > PARTIAL_REFRESH_MAX_COVERAGE_PERCENT)
+    {
+        pushFullFrame(UPDATE_MODE_GC16);
+        return;
+    }
+
+    // Only the changed regions travel over SPI and get the waveform.
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!writeDirtyRect(frame, rects[i]))
+        {
+            Serial.println("[Display] No PSRAM to pack dirty rects; pushing the whole frame.");
+            pushFullFrame(PARTIAL_REFRESH_MODE);
+            return;
+        }
+        M5.EPD.UpdateArea(rects[i].x, rects[i].y, rects[i].w, rects[i].h, PARTIAL_REFRESH_MODE);
+    }
+    memcpy(lastPushedFrame, frame, FRAME_BYTES);
+    partialRefreshCount = std::min<int>(partialRefreshCount + 1, UINT8_MAX);
+    Serial.printf("[Display] Partial refresh: %u rect(s), %lu px (%lu%%)\n",
+                  (unsigned)count, (unsigned long)area, (unsigned long)coveragePercent);
 }
 
 void renderStatusMessage(const String &message)
@@ -570,23 +1652,25 @@ void renderStatusMessage(const String &message)
     }
 
     canvas.fillCanvas(COLOR_WHITE);
-    canvas.setTextColor(COLOR_BLACK);
-    canvas.setTextDatum(MC_DATUM);
+    textRenderer.setTextColor(COLOR_BLACK);
+    textRenderer.setTextDatum(MC_DATUM);
     setTextSizeCompat(3);
-    canvas.drawString(message, CANVAS_WIDTH / 2, CANVAS_HEIGHT / 2);
-    canvas.pushCanvas(0, 0, UPDATE_MODE_GC16);
-    canvas.setTextDatum(TL_DATUM);
+    textRenderer.drawString(message, CANVAS_WIDTH / 2, CANVAS_HEIGHT / 2);
+    pushFullFrame(UPDATE_MODE_GC16);
+    panelShowsUi = false;
+    shownStatusMessage = message;
+    textRenderer.setTextDatum(TL_DATUM);
 }
 
 int calculateDegreeRadius() noexcept
 {
-    const int textHeight = canvas.fontHeight();
+    const int textHeight = textRenderer.fontHeight();
     return std::max(2, textHeight / 10);
 }
 
 int calculateDegreeCenterY(int startY, int radius) noexcept
 {
-    return startY + radius + std::max(0, canvas.fontHeight() / 12);
+    return startY + radius + std::max(0, textRenderer.fontHeight() / 12);
 }
 
 void drawDegreesForText(const String &text, int16_t startX, int16_t startY)
@@ -608,8 +1692,8 @@ void drawDegreesForText(const String &text, int16_t startX, int16_t startY)
         }
 
         const String prefix = text.substring(0, fIndex - 1);
-        const int prefixWidth = canvas.textWidth(prefix);
-        const int spaceWidth = canvas.textWidth(" ");
+        const int prefixWidth = textRenderer.textWidth(prefix);
+        const int spaceWidth = textRenderer.textWidth(" ");
         const int fStartX = startX + prefixWidth + spaceWidth;
         const int availableSpace = std::max(1, spaceWidth - 1);
         const int offset = std::min(radius + 1, availableSpace);
@@ -631,17 +1715,54 @@ void drawDegreesForText(const String &text, int16_t startX, int16_t startY)
 
 void drawStringWithDegrees(const String &text, int16_t startX, int16_t startY)
 {
-    canvas.drawString(text, startX, startY);
+    textRenderer.drawString(text, startX, startY);
 }
 
-void pushCanvasSmart()
+// Starts a frame from the static chrome of `layer`. The first render after a
+// font or config change draws it with `drawChrome` onto a blank canvas and
+// keeps a copy; later renders just copy that back.
+void beginFrame(ChromeLayer layer, void (*drawChrome)())
 {
-    m5epd_update_mode_t mode = pendingFullRefresh ? UPDATE_MODE_GL16 : UPDATE_MODE_GC16;
-    canvas.pushCanvas(0, 0, mode);
-    pendingFullRefresh = false;
+    textRenderer.setTextColor(COLOR_BLACK);
+    textRenderer.setTextDatum(TL_DATUM);
+    uint8_t *frame = static_cast<uint8_t *>(canvas.frameBuffer());
+    if (chromeLayers.restore(static_cast<uint8_t>(layer), frame))
+    {
+        return;
+    }
+    canvas.fillCanvas(COLOR_WHITE);
+    drawChrome();
+    textRenderer.setTextDatum(TL_DATUM);
+    chromeLayers.store(static_cast<uint8_t>(layer), frame);
+}
+
+constexpr char DETAIL_TITLE_PREFIX[] = "Forecast: ";
+constexpr int DETAIL_HIGH_Y = 160;
+
+int detailLowY()
+{
+    setTextSizeCompat(7); // slightly smaller than main big temp
+    return DETAIL_HIGH_Y + textRenderer.fontHeight() + 30; // spacing below high value
+}
+
+void drawDetailChrome()
+{
+    setTextSizeCompat(4);
+    textRenderer.drawString(DETAIL_TITLE_PREFIX, 30, 30);
+
+    // Labels in smaller font
+    const int yLow = detailLowY();
+    setTextSizeCompat(3);
+    textRenderer.drawString("High:", 30, DETAIL_HIGH_Y);
+    textRenderer.drawString("Low:", 30, yLow);
+
+    // Footer hint
+    setTextSizeCompat(2);
+    textRenderer.setTextDatum(BC_DATUM);
+    textRenderer.drawString("Tap to cycle days — tap again to return", CANVAS_WIDTH / 2, CANVAS_HEIGHT - 16);
 }
 
-void renderForecastDetail(int dayIndex, float indoorTemp, float indoorHumidity, bool indoorValid)
+void renderForecastDetail(int dayIndex, const DisplayInputs &inputs)
 {
     if (!canvasReady)
     {
@@ -649,57 +1770,46 @@ void renderForecastDetail(int dayIndex, float indoorTemp, float indoorHumidity,
         return;
     }
 
-    canvas.fillCanvas(COLOR_WHITE);
-    canvas.setTextColor(COLOR_BLACK);
-    canvas.setTextDatum(TL_DATUM);
+    beginFrame(ChromeLayer::Detail, drawDetailChrome);
 
     // Safety: bound index
     if (dayIndex < 0) dayIndex = 0;
-    if (dayIndex > 2) dayIndex = 2;
+    if (dayIndex >= CFG_FORECAST_DAYS) dayIndex = CFG_FORECAST_DAYS - 1;
 
     const DailyForecast &forecast = latestWeather.days[dayIndex];
 
-    // Header
+    // Header; "Forecast: " is in the chrome
     setTextSizeCompat(4);
-    const String title = String("Forecast: ") + formatDayOfWeek(forecast.timestamp);
-    canvas.drawString(title, 30, 30);
+    textRenderer.drawString(formatDayOfWeek(forecast.timestamp), 30 + textRenderer.textWidth(DETAIL_TITLE_PREFIX), 30);
 
     // Timestamp of last weather update
     setTextSizeCompat(2);
-    const String updatedText = latestWeather.updatedAt != 0 ? formatTimestamp(latestWeather.updatedAt) : String("Pending");
-    canvas.drawString(String("Updated: ") + updatedText, 30, 80);
+    textRenderer.drawString(formatUpdatedLine(inputs.renderedAt), 30, 80);
 
     // Indoor quick status on the right
     setTextSizeCompat(2);
     const int indoorTextY = 80;
-    if (indoorValid)
+    if (inputs.indoorValid)
     {
-        const String indoorLine = "Indoor: " + String(indoorTemp, 1) + " F  " + String(indoorHumidity, 1) + "% RH";
-        const int indoorWidth = canvas.textWidth(indoorLine);
+        const String indoorLine = "Indoor: " + String(inputs.indoorTemp, 1) + " F  " + String(inputs.indoorHumidity, 1) + "% RH";
+        const int indoorWidth = textRenderer.textWidth(indoorLine);
         const int indoorDrawX = CANVAS_WIDTH - 30 - indoorWidth;
         drawStringWithDegrees(indoorLine, indoorDrawX, indoorTextY);
     }
     else
     {
         const String indoorMessage = "Indoor sensor not available";
-        const int indoorWidth = canvas.textWidth(indoorMessage);
+        const int indoorWidth = textRenderer.textWidth(indoorMessage);
         const int indoorDrawX = CANVAS_WIDTH - 30 - indoorWidth;
-        canvas.drawString(indoorMessage, indoorDrawX, indoorTextY);
+        textRenderer.drawString(indoorMessage, indoorDrawX, indoorTextY);
     }
 
     // Temperatures — use large value font and compute dynamic spacing to avoid overlap
-    setTextSizeCompat(7); // slightly smaller than main big temp
-    const int valueHeight = canvas.fontHeight();
-    const int yHigh = 160;
-    const int yLow = yHigh + valueHeight + 30; // spacing below high value
+    const int yHigh = DETAIL_HIGH_Y;
+    const int yLow = detailLowY();
     String hiStr = std::isnan(forecast.maxTemperature) ? String("-- F") : String(forecast.maxTemperature, 1) + " F";
     String loStr = std::isnan(forecast.minTemperature) ? String("-- F") : String(forecast.minTemperature, 1) + " F";
 
-    // Labels in smaller font
-    setTextSizeCompat(3);
-    canvas.drawString("High:", 30, yHigh);
-    canvas.drawString("Low:", 30, yLow);
-
     // Values in large font
     setTextSizeCompat(7);
     drawStringWithDegrees(hiStr, 180, yHigh);
@@ -708,9 +1818,9 @@ void renderForecastDetail(int dayIndex, float indoorTemp, float indoorHumidity,
     // Weather icon on the right
     const int iconBoxX = CANVAS_WIDTH - 200;
     const int iconBoxY = 140;
-    const int iconBoxW = 150;
-    const int iconBoxH = 150;
-    if (forecast.iconCode.length() > 0)
+    const int iconBoxW = DETAIL_ICON_BOX_W;
+    const int iconBoxH = DETAIL_ICON_BOX_H;
+    if (forecast.iconCode[0] != '\0')
     {
         if (!drawOwmIcon(forecast.iconCode, iconBoxX, iconBoxY, iconBoxW, iconBoxH))
         {
@@ -720,159 +1830,614 @@ void renderForecastDetail(int dayIndex, float indoorTemp, float indoorHumidity,
             }
         }
     }
+    // The night's own condition, when it differs from the day's.
+    if (forecast.nightIconCode[0] != '\0' && strncmp(forecast.nightIconCode, forecast.iconCode, 2) != 0)
+    {
+        const int nightX = iconBoxX - 120;
+        if (drawOwmIcon(forecast.nightIconCode, nightX, iconBoxY, iconBoxW, iconBoxH))
+        {
+            setTextSizeCompat(2);
+            textRenderer.drawString("Night", nightX + 20, iconBoxY + 100);
+        }
+    }
 
     // Summary, wrapped
     setTextSizeCompat(3);
-    const String summary = forecast.summary.length() > 0 ? capitalizeWords(forecast.summary) : String("No summary available");
+    const String summary = forecast.summary[0] != '\0' ? capitalizeWords(forecast.summary) : String("No summary available");
     const int summaryX = 30;
-    int summaryY = 300;
+    const int summaryY = 300;
+    const int summaryLineHeight = 28;
     const int maxSummaryWidth = CANVAS_WIDTH - 60;
-    String line;
-    int index = 0;
-    while (index < summary.length())
-    {
-        while (index < summary.length() && summary[index] == ' ')
-        {
-            ++index;
-        }
-        if (index >= summary.length())
-        {
-            break;
-        }
-        int nextSpace = summary.indexOf(' ', index);
-        if (nextSpace == -1)
+    const int maxSummaryLines = (CANVAS_HEIGHT - 60 - summaryY) / summaryLineHeight;
+    const TextLayout summaryLayout = textLayout.layout(summary, resolveTextSize(3), maxSummaryWidth, maxSummaryLines);
+    textLayout.draw(summary, summaryLayout, summaryX, summaryY, summaryLineHeight);
+}
+
+// Plots one quantity over [firstSlot, lastSlot] into the box as a gray area
+// under a black trace. Each pixel column covers a run of slots and is drawn
+// from their fixed-point range straight into the canvas: one pass, no
+// per-point allocation or text.
+void drawSparkline(int x, int y, int w, int h, uint32_t firstSlot, uint32_t lastSlot, bool humidity, int32_t low,
+                   int32_t high)
+{
+    canvas.drawRect(x - 1, y - 1, w + 2, h + 2, COLOR_BLACK);
+    const uint32_t span = lastSlot - firstSlot + 1;
+    const int32_t range = std::max<int32_t>(1, high - low);
+    const int bottom = y + h - 1;
+    int previousY = -1;
+    ClimateSample sample;
+    for (int column = 0; column < w; ++column)
+    {
+        const uint32_t from = firstSlot + static_cast<uint32_t>(static_cast<uint64_t>(span) * column / w);
+        const uint32_t to = std::max(from + 1, firstSlot + static_cast<uint32_t>(static_cast<uint64_t>(span) * (column + 1) / w));
+        int32_t columnMin = std::numeric_limits<int32_t>::max();
+        int32_t columnMax = std::numeric_limits<int32_t>::min();
+        for (uint32_t slot = from; slot < to; ++slot)
         {
-            nextSpace = summary.length();
+            if (climateHistory.at(slot, sample))
+            {
+                const int32_t value = humidity ? sample.deciPercent : sample.centiF;
+                columnMin = std::min(columnMin, value);
+                columnMax = std::max(columnMax, value);
+            }
         }
-        const String word = summary.substring(index, nextSpace);
-        const String candidate = line.length() > 0 ? line + ' ' + word : word;
-        if (line.length() == 0 || canvas.textWidth(candidate) <= maxSummaryWidth)
+        if (columnMax < columnMin)
         {
-            line = candidate;
+            previousY = -1; // no readings: leave a gap
+            continue;
         }
-        else
+        const int top = bottom - static_cast<int>((columnMax - low) * (h - 1) / range);
+        const int lowest = bottom - static_cast<int>((columnMin - low) * (h - 1) / range);
+        const int middle = (top + lowest) / 2;
+        canvas.drawFastVLine(x + column, top, bottom - top + 1, SPARKLINE_AREA_GRAY);
+        canvas.drawFastVLine(x + column, top, lowest - top + 1, COLOR_BLACK);
+        if (previousY >= 0)
         {
-            canvas.drawString(line, summaryX, summaryY);
-            line = word;
-            summaryY += 28;
+            canvas.drawLine(x + column - 1, previousY, x + column, middle, COLOR_BLACK);
         }
-        index = nextSpace + 1;
+        previousY = middle;
     }
-    if (line.length() > 0)
-    {
-        canvas.drawString(line, summaryX, summaryY);
-    }
-
-    // Footer hint
-    setTextSizeCompat(2);
-    const String hint = "Tap to cycle days — tap again to return";
-    const int hintWidth = canvas.textWidth(hint);
-    canvas.setTextDatum(BC_DATUM);
-    canvas.drawString(hint, CANVAS_WIDTH / 2, CANVAS_HEIGHT - 16);
-    canvas.setTextDatum(TL_DATUM);
-
-    pushCanvasSmart();
 }
 
-void renderUi(float indoorTemp, float indoorHumidity, bool indoorValid)
+// Caption and sparkline for one quantity over the `windowSeconds` ending at `now`.
+void drawClimateGraph(int x, int y, int w, int h, time_t now, uint32_t windowSeconds, bool humidity,
+                      const char *title)
 {
-    if (uiMode == 0)
+    const uint32_t lastSlot = climateHistory.slotFor(now);
+    const uint32_t firstSlot = lastSlot - (windowSeconds / climateHistory.slotSeconds()) + 1;
+    const ClimateStats stats = climateHistory.stats(firstSlot, lastSlot);
+
+    char caption[80];
+    if (stats.count == 0)
     {
-        renderDisplay(indoorTemp, indoorHumidity, indoorValid);
+        snprintf(caption, sizeof(caption), "%s: no data yet", title);
+    }
+    else if (humidity)
+    {
+        snprintf(caption, sizeof(caption), "%s: %.1f-%.1f%%, avg %.1f%%", title, stats.minDeciPercent / 10.0,
+                 stats.maxDeciPercent / 10.0, stats.avgDeciPercent / 10.0);
     }
     else
     {
-        const int dayIndex = static_cast<int>(uiMode) - 1;
-        renderForecastDetail(dayIndex, indoorTemp, indoorHumidity, indoorValid);
+        snprintf(caption, sizeof(caption), "%s: %.1f-%.1f F, avg %.1f F", title, stats.minCentiF / 100.0,
+                 stats.maxCentiF / 100.0, stats.avgCentiF / 100.0);
+    }
+    setTextSizeCompat(2);
+    textRenderer.drawString(caption, x, y - 34);
+    if (stats.count == 0)
+    {
+        canvas.drawRect(x - 1, y - 1, w + 2, h + 2, COLOR_BLACK);
+        return;
+    }
+    // Pad flat series so a steady reading sits mid-box instead of on an edge.
+    const int32_t minimumSpan = humidity ? 20 : 100;
+    int32_t low = humidity ? stats.minDeciPercent : stats.minCentiF;
+    int32_t high = humidity ? stats.maxDeciPercent : stats.maxCentiF;
+    if (high - low < minimumSpan)
+    {
+        const int32_t pad = (minimumSpan - (high - low)) / 2;
+        low -= pad;
+        high += pad;
     }
+    drawSparkline(x, y, w, h, firstSlot, lastSlot, humidity, low, high);
 }
 
-void refreshDisplayForUiChange()
+void drawClimateHistoryChrome()
 {
-    float indoorTemp = NAN;
-    float indoorHumidity = NAN;
-    const bool indoorValid = readIndoorClimate(indoorTemp, indoorHumidity);
-    renderUi(indoorTemp, indoorHumidity, indoorValid);
+    setTextSizeCompat(4);
+    textRenderer.drawString("Indoor History", 30, 30);
 }
-void drawForecastCards()
+
+// Replays the SD log into the history ring the first time the page is drawn
+// after a boot or wake; a wake that never shows the page leaves the log alone.
+void loadClimateHistory()
 {
-    constexpr int baseY = 360;
-    constexpr int cardWidth = 280;
-    constexpr int cardHeight = 150;
-    constexpr int spacing = 20;
-    const int startX = 30;
-    for (int i = 0; i < 3; ++i)
+    if (climateHistoryReady && !climateHistory.loaded() && ensureSdReady())
     {
-        const int x = startX + i * (cardWidth + spacing);
-        canvas.drawRoundRect(x, baseY, cardWidth, cardHeight, 12, COLOR_BLACK);
+        climateHistory.load(SD, CLIMATE_LOG_PATH);
+    }
+}
 
-        const DailyForecast &forecast = latestWeather.days[i];
-        if (forecast.timestamp == 0)
-        {
-            continue;
-        }
+void renderClimateHistory(const DisplayInputs &inputs)
+{
+    loadClimateHistory();
+    beginFrame(ChromeLayer::ClimateHistory, drawClimateHistoryChrome);
+
+    setTextSizeCompat(2);
+    if (inputs.indoorValid)
+    {
+        const String indoorLine = "Now: " + String(inputs.indoorTemp, 1) + " F  " + String(inputs.indoorHumidity, 1) + "% RH";
+        drawStringWithDegrees(indoorLine, CANVAS_WIDTH - 30 - textRenderer.textWidth(indoorLine), 80);
+    }
 
+    if (!climateHistoryReady || inputs.renderedAt < MIN_VALID_EPOCH)
+    {
         setTextSizeCompat(3);
-        canvas.drawString(formatDayOfWeek(forecast.timestamp), x + 20, baseY + 16);
+        textRenderer.drawString("History unavailable", 30, 140);
+        return;
+    }
 
+    constexpr int graphW = 430;
+    constexpr int graphH = 150;
+    constexpr int leftX = 30;
+    constexpr int rightX = CANVAS_WIDTH - 30 - graphW;
+    drawClimateGraph(leftX, 150, graphW, graphH, inputs.renderedAt, 24UL * 60UL * 60UL, false, "24 h");
+    drawClimateGraph(rightX, 150, graphW, graphH, inputs.renderedAt, 24UL * 60UL * 60UL, true, "24 h RH");
+    drawClimateGraph(leftX, 360, graphW, graphH, inputs.renderedAt, ClimateHistory::WINDOW_SECONDS, false, "7 d");
+    drawClimateGraph(rightX, 360, graphW, graphH, inputs.renderedAt, ClimateHistory::WINDOW_SECONDS, true, "7 d RH");
+}
+
+// Every point of the last forecast as a temperature curve over precipitation
+// bars, with condition icons along the top. Works straight from the
+// snapshot's fixed-point arrays with stack buffers for text, so the points are
+// plotted without heap allocation and the page is pushed in one refresh.
+void drawTimelineChrome()
+{
+    canvas.drawRect(TIMELINE_GRAPH_X - 1, TIMELINE_GRAPH_Y - 1, TIMELINE_GRAPH_W + 2, TIMELINE_GRAPH_H + 2, COLOR_BLACK);
+    canvas.drawRect(TIMELINE_GRAPH_X - 1, TIMELINE_PRECIP_Y - 1, TIMELINE_GRAPH_W + 2, TIMELINE_PRECIP_H + 2, COLOR_BLACK);
+    setTextSizeCompat(2);
+    textRenderer.drawString("Rain", TIMELINE_GRAPH_X - 10 - textRenderer.textWidth("Rain"), TIMELINE_PRECIP_Y + TIMELINE_PRECIP_H / 2 - 8);
+}
+
+void renderForecastTimeline(const DisplayInputs &inputs)
+{
+    beginFrame(ChromeLayer::Timeline, drawTimelineChrome);
+
+    const ForecastTimeline &timeline = latestWeather.timeline;
+    const time_t spanSeconds = timeline.count > 1 ? timeline.timeAt(timeline.count - 1) - timeline.start : 0;
+    char text[48];
+    snprintf(text, sizeof(text), "Next %ld h", static_cast<long>(spanSeconds / 3600));
+    setTextSizeCompat(4);
+    textRenderer.drawString(timeline.count > 1 ? text : "Forecast Timeline", 30, 30);
+    setTextSizeCompat(2);
+    textRenderer.drawString(formatUpdatedLine(inputs.renderedAt), 30, 80);
+
+    int16_t low = INT16_MAX;
+    int16_t high = INT16_MIN;
+    for (size_t i = 0; i < timeline.count; ++i)
+    {
+        if (timeline.centiDegrees[i] != INT16_MIN)
+        {
+            low = std::min(low, timeline.centiDegrees[i]);
+            high = std::max(high, timeline.centiDegrees[i]);
+        }
+    }
+    if (timeline.count < 2 || high < low)
+    {
         setTextSizeCompat(3);
-        String tempText;
-        if (std::isnan(forecast.maxTemperature) || std::isnan(forecast.minTemperature))
+        textRenderer.drawString("No forecast points yet", 30, 140);
+        return;
+    }
+    snprintf(text, sizeof(text), "%.0f-%.0f F", low / 100.0, high / 100.0);
+    textRenderer.drawString(text, CANVAS_WIDTH - 30 - textRenderer.textWidth(text), 80);
+    // Whole degrees around the range, padded so a flat day is not drawn as noise.
+    int32_t lowDegrees = static_cast<int32_t>(std::floor(low / 100.0)) - 1;
+    int32_t highDegrees = static_cast<int32_t>(std::ceil(high / 100.0)) + 1;
+    if (highDegrees - lowDegrees < 6)
+    {
+        lowDegrees -= (6 - (highDegrees - lowDegrees)) / 2;
+        highDegrees = lowDegrees + 6;
+    }
+
+    constexpr int graphX = TIMELINE_GRAPH_X;
+    constexpr int graphW = TIMELINE_GRAPH_W;
+    constexpr int iconY = 100;
+    constexpr int iconSize = 100; // OWM @2x PNGs, baked into the atlas by the prefetch
+    constexpr int graphY = TIMELINE_GRAPH_Y;
+    constexpr int graphH = TIMELINE_GRAPH_H;
+    constexpr int precipY = TIMELINE_PRECIP_Y;
+    constexpr int precipH = TIMELINE_PRECIP_H;
+    constexpr int labelY = precipY + precipH + 8;
+    auto columnFor = [&](size_t i) {
+        return graphX + static_cast<int>(static_cast<int64_t>(timeline.timeAt(i) - timeline.start) * (graphW - 1) / spanSeconds);
+    };
+    auto rowFor = [&](int16_t centi) {
+        return graphY + graphH - 1 - static_cast<int>((centi - lowDegrees * 100) * (graphH - 1) / ((highDegrees - lowDegrees) * 100));
+    };
+
+    snprintf(text, sizeof(text), "%ld", static_cast<long>(highDegrees));
+    textRenderer.drawString(text, graphX - 10 - textRenderer.textWidth(text), graphY);
+    snprintf(text, sizeof(text), "%ld", static_cast<long>(lowDegrees));
+    textRenderer.drawString(text, graphX - 10 - textRenderer.textWidth(text), graphY + graphH - 16);
+
+    // Day boundaries (and noon on a short series) as light rules with a label.
+    const int labelHours = spanSeconds <= 48 * 60 * 60 ? 12 : 24;
+    const time_t labelStep = static_cast<time_t>(labelHours) * 60 * 60;
+    for (time_t mark = (timeline.start / labelStep + 1) * labelStep; mark < timeline.start + spanSeconds; mark += labelStep)
+    {
+        const int x = graphX + static_cast<int>(static_cast<int64_t>(mark - timeline.start) * (graphW - 1) / spanSeconds);
+        canvas.drawFastVLine(x, graphY, graphH, SPARKLINE_AREA_GRAY);
+        struct tm markTm;
+        gmtime_r(&mark, &markTm);
+        strftime(text, sizeof(text), markTm.tm_hour == 0 ? "%a" : "%H:%M", &markTm);
+        textRenderer.drawString(text, x - textRenderer.textWidth(text) / 2, labelY);
+    }
+
+    // Bars share the point's column; each is as wide as the gap to the next point.
+    const bool atlasReady = ensureIconAtlas();
+    int previousX = -1;
+    int previousY = -1;
+    int nextIconX = 0;
+    for (size_t i = 0; i < timeline.count; ++i)
+    {
+        const int x = columnFor(i);
+        const int nextX = i + 1 < timeline.count ? columnFor(i + 1) : graphX + graphW;
+        if (timeline.precipPercent[i] > 0)
         {
-            tempText = "-- F / -- F";
+            const int barH = std::max(1, timeline.precipPercent[i] * precipH / 100);
+            canvas.fillRect(x, precipY + precipH - barH, std::max(1, nextX - x - 1), barH, PRECIP_BAR_GRAY);
         }
-        else
+        if (atlasReady && x - iconSize / 2 >= nextIconX)
         {
-            tempText = String(forecast.maxTemperature, 1) + "F / " + String(forecast.minTemperature, 1) + " F";
+            const char *code = iconCodeForCondition(timeline.condition[i]);
+            if (code[0] != '\0' && iconAtlas.draw(static_cast<uint8_t *>(canvas.frameBuffer()), CANVAS_WIDTH,
+                                                   CANVAS_HEIGHT, code, x - iconSize / 2, iconY,
+                                                   DETAIL_ICON_BOX_W, DETAIL_ICON_BOX_H))
+            {
+                nextIconX = x + iconSize / 2;
+            }
         }
-        drawStringWithDegrees(tempText, x + 20, baseY + 56);
+        if (timeline.centiDegrees[i] == INT16_MIN)
+        {
+            previousY = -1; // missing temperature: leave a gap
+            continue;
+        }
+        const int y = rowFor(timeline.centiDegrees[i]);
+        if (previousY >= 0)
+        {
+            canvas.drawLine(previousX, previousY, x, y, COLOR_BLACK);
+            canvas.drawLine(previousX, previousY + 1, x, y + 1, COLOR_BLACK);
+        }
+        canvas.fillRect(x - 1, y - 1, 3, 3, COLOR_BLACK);
+        previousX = x;
+        previousY = y;
+    }
+}
 
-        setTextSizeCompat(2);
-        const String summary = forecast.summary.length() > 0 ? capitalizeWords(forecast.summary) : String("--");
-        const int summaryX = x + 20;
-        int summaryY = baseY + 96;
-        const int maxSummaryWidth = cardWidth - 40;
-        const int maxSummaryBottom = baseY + cardHeight - 16;
+// Milliseconds with one decimal below 10 ms, "-" for a phase the cycle never ran.
+void formatPhaseTime(char *out, size_t size, uint32_t micros)
+{
+    if (micros == 0)
+    {
+        snprintf(out, size, "-");
+    }
+    else if (micros < 10000)
+    {
+        snprintf(out, size, "%.1f", micros / 1000.0);
+    }
+    else
+    {
+        snprintf(out, size, "%lu", (unsigned long)((micros + 500) / 1000));
+    }
+}
+
+// Hidden page: rolling p50/p95 of every phase from the SD timing log, for
+// weather and indoor-only cycles side by side.
+void renderDiagnostics(const DisplayInputs &inputs)
+{
+    canvas.fillCanvas(COLOR_WHITE);
+    textRenderer.setTextColor(COLOR_BLACK);
+    textRenderer.setTextDatum(TL_DATUM);
+    setTextSizeCompat(4);
+    textRenderer.drawString("Diagnostics", 30, 30);
 
-        String line;
-        int index = 0;
-        while (index < summary.length() && summaryY <= maxSummaryBottom)
+    // The battery model's view of the same cycles.
+    char line[96];
+    setTextSizeCompat(2);
+    textRenderer.setTextDatum(TR_DATUM);
+    snprintf(line, sizeof(line), "Battery %.0f%%%s, intervals x%.2f", inputs.batteryLevel,
+             batteryModel.lowBattery() ? " (low)" : "", intervalStretch());
+    textRenderer.drawString(line, CANVAS_WIDTH - 30, 24);
+    snprintf(line, sizeof(line), "Cost: weather %.3f%%, indoor %.3f%%, sleep %.2f%%/h",
+             batteryModel.cycleCost(UpdateCycle::Weather), batteryModel.cycleCost(UpdateCycle::Indoor),
+             batteryModel.sleepCostPerHour());
+    textRenderer.drawString(line, CANVAS_WIDTH - 30, 52);
+    textRenderer.setTextDatum(TL_DATUM);
+
+    PerfSummary weather;
+    PerfSummary indoor;
+    if (ensureSdReady())
+    {
+        summarizePerfLog(SD, PERF_LOG_PATH, "weather", weather);
+        summarizePerfLog(SD, PERF_LOG_PATH, "indoor", indoor);
+    }
+    snprintf(line, sizeof(line), "Last %u weather and %u indoor cycles in %s", (unsigned)weather.cycles,
+             (unsigned)indoor.cycles, PERF_LOG_PATH);
+    textRenderer.drawString(line, 30, 90);
+    if (weather.cycles == 0 && indoor.cycles == 0)
+    {
+        setTextSizeCompat(3);
+        textRenderer.drawString("No cycles logged yet", 30, 160);
+        return;
+    }
+
+    // Right edges of the value columns: weather p50, p95, indoor p50, p95.
+    constexpr int columnX[] = {420, 560, 760, 900};
+    constexpr int headerY = 140;
+    constexpr int rowHeight = 30;
+    const char *headers[] = {"Weather p50", "p95", "Indoor p50", "p95"};
+    textRenderer.drawString("Phase (ms)", 30, headerY);
+    textRenderer.setTextDatum(TR_DATUM);
+    for (size_t c = 0; c < 4; ++c)
+    {
+        textRenderer.drawString(headers[c], columnX[c], headerY);
+    }
+    canvas.drawFastHLine(30, headerY + rowHeight + 2, CANVAS_WIDTH - 60, COLOR_BLACK);
+
+    char cell[16];
+    for (size_t row = 0; row <= PerfLog::PHASE_COUNT + 1; ++row)
+    {
+        const int y = headerY + (static_cast<int>(row) + 1) * rowHeight + 8;
+        const bool phaseRow = row < PerfLog::PHASE_COUNT;
+        const bool totalRow = row == PerfLog::PHASE_COUNT;
+        textRenderer.setTextDatum(TL_DATUM);
+        textRenderer.drawString(phaseRow ? PerfLog::phaseName(static_cast<PerfPhase>(row)) : totalRow ? "total" : "battery drop (mV)",
+                                30, y);
+        textRenderer.setTextDatum(TR_DATUM);
+        const PerfSummary *summaries[] = {&weather, &weather, &indoor, &indoor};
+        for (size_t c = 0; c < 4; ++c)
         {
-            while (index < summary.length() && summary[index] == ' ')
-            {
-                ++index;
-            }
-            if (index >= summary.length())
+            const PerfSummary &summary = *summaries[c];
+            const bool p50 = c % 2 == 0;
+            if (summary.cycles == 0)
             {
-                break;
+                snprintf(cell, sizeof(cell), "-");
             }
-            int nextSpace = summary.indexOf(' ', index);
-            if (nextSpace == -1)
+            else if (phaseRow)
             {
-                nextSpace = summary.length();
+                formatPhaseTime(cell, sizeof(cell), p50 ? summary.p50Us[row] : summary.p95Us[row]);
             }
-            const String word = summary.substring(index, nextSpace);
-            const String candidate = line.length() > 0 ? line + ' ' + word : word;
-            if (line.length() == 0 || canvas.textWidth(candidate) <= maxSummaryWidth)
+            else if (totalRow)
             {
-                line = candidate;
+                formatPhaseTime(cell, sizeof(cell), p50 ? summary.totalP50Us : summary.totalP95Us);
             }
             else
             {
-                canvas.drawString(line, summaryX, summaryY);
-                line = word;
-                summaryY += 22;
+                snprintf(cell, sizeof(cell), "%ld", (long)(p50 ? summary.batteryDropP50Mv : summary.batteryDropP95Mv));
             }
-            index = nextSpace + 1;
+            textRenderer.drawString(cell, columnX[c], y);
         }
-        if (line.length() > 0 && summaryY <= maxSummaryBottom)
+    }
+    textRenderer.setTextDatum(TL_DATUM);
+}
+
+// Draws the given view into the canvas without pushing it to the panel.
+void composeUi(uint8_t mode, const DisplayInputs &inputs)
+{
+    if (mode == UI_MODE_DIAGNOSTICS)
+    {
+        renderDiagnostics(inputs);
+    }
+    else if (mode == 0)
+    {
+        renderDisplay(inputs);
+    }
+    else if (mode == uiModeTimeline())
+    {
+        renderForecastTimeline(inputs);
+    }
+    else if (mode == uiModeClimateHistory())
+    {
+        renderClimateHistory(inputs);
+    }
+    else
+    {
+        const int dayIndex = static_cast<int>(mode) - 1;
+        renderForecastDetail(dayIndex, inputs);
+    }
+}
+
+void renderUi(const DisplayInputs &inputs)
+{
+    if (!canvasReady)
+    {
+        Serial.println("[Display] Skipping render because canvas is not ready.");
+        return;
+    }
+    // New inputs or a new snapshot: every pre-rendered view is stale.
+    viewFrames.invalidate();
+    {
+        ScopedPerfTimer timer(perfLog, PerfPhase::Render);
+        composeUi(uiMode, inputs);
+    }
+    viewFrames.store(uiMode, static_cast<const uint8_t *>(canvas.frameBuffer()));
+    {
+        ScopedPerfTimer timer(perfLog, PerfPhase::Push);
+        pushCanvasSmart();
+    }
+    panelShowsUi = true;
+    shownUiMode = uiMode;
+    shownInputs = inputs;
+}
+
+DisplayInputs captureDisplayInputs()
+{
+    DisplayInputs inputs;
+    inputs.indoorValid = readIndoorClimate(inputs.indoorTemp, inputs.indoorHumidity);
+    inputs.batteryLevel = readBatteryLevel();
+    if (WiFi.status() == WL_CONNECTED)
+    {
+        copyText(inputs.wifiSsid, WiFi.SSID().c_str());
+    }
+    inputs.renderedAt = currentEpoch();
+    if (batteryModel.lowBattery())
+    {
+        snprintf(inputs.errorBadge, sizeof(inputs.errorBadge), "Low battery, weather paused");
+    }
+    else if (fetchScheduler.lastFailure() != FetchFailure::None)
+    {
+        const FetchFailure failure = fetchScheduler.lastFailure();
+        const char *what = failure == FetchFailure::WiFi ? "WiFi" : failure == FetchFailure::Http ? "Server" : "Data";
+        const long retryMinutes = std::max<long>(0, static_cast<long>(fetchScheduler.retryAt() - inputs.renderedAt + 59) / 60);
+        snprintf(inputs.errorBadge, sizeof(inputs.errorBadge), "%s error, retry in %ld min", what, retryMinutes);
+    }
+    return inputs;
+}
+
+// A view change keeps the inputs already on the panel, so no sensor is read
+// and the frame usually comes ready-made from viewFrames. Returns whether it did.
+bool refreshDisplayForUiChange()
+{
+    if (!canvasReady || !panelShowsUi)
+    {
+        renderUi(captureDisplayInputs());
+        return false;
+    }
+    uint8_t *frame = static_cast<uint8_t *>(canvas.frameBuffer());
+    const bool prerendered = viewFrames.restore(uiMode, frame);
+    if (!prerendered)
+    {
+        composeUi(uiMode, shownInputs);
+        viewFrames.store(uiMode, frame);
+    }
+    pushCanvasSmart();
+    shownUiMode = uiMode;
+    return prerendered;
+}
+
+// Draws one stale view of the tap cycle into viewFrames, nearest to the shown
+// view first (next, previous, two ahead, ...). Runs while the loop is idle,
+// one view per call, so a gesture never waits for more than one compose.
+// Returns false once every view is current or PSRAM has run out.
+bool prerenderNextView()
+{
+    if (!canvasReady || !panelShowsUi)
+    {
+        return false;
+    }
+    const uint8_t count = uiModeCount();
+    const uint8_t shown = shownUiMode < count ? shownUiMode : 0;
+    for (uint8_t step = 1; step < count; ++step)
+    {
+        const uint8_t offset = step % 2 != 0 ? (step + 1) / 2 : count - step / 2;
+        const uint8_t mode = (shown + offset) % count;
+        // A view with no PSRAM is skipped, not composed and thrown away every pass.
+        // The history page waits until it is opened rather than replay the log.
+        if (mode == shownUiMode || viewFrames.fresh(mode) || viewFrames.refused(mode) ||
+            (mode == uiModeClimateHistory() && climateHistoryReady && !climateHistory.loaded()))
         {
-            canvas.drawString(line, summaryX, summaryY);
+            continue;
+        }
+        const uint32_t startMs = millis();
+        composeUi(mode, shownInputs);
+        if (!viewFrames.store(mode, static_cast<const uint8_t *>(canvas.frameBuffer())))
+        {
+            return false;
         }
+        Serial.printf("[Display] Pre-rendered view %u in %lu ms.\n", (unsigned)mode, (unsigned long)(millis() - startMs));
+        return true;
     }
+    return false;
+}
+
+int forecastCardWidth()
+{
+    return (CANVAS_WIDTH - 2 * FORECAST_CARD_X - (CFG_FORECAST_DAYS - 1) * FORECAST_CARD_SPACING) / CFG_FORECAST_DAYS;
 }
 
-void renderDisplay(float indoorTemp, float indoorHumidity, bool indoorValid)
+// The location's name once there is more than one; tapping it moves on.
+String dashboardTitle()
+{
+    if (CFG_LOCATION_COUNT < 2)
+    {
+        return "Home Weather Dashboard";
+    }
+    const String &name = CFG_LOCATIONS[activeLocation].name;
+    return (name.length() > 0 ? name : String("Location ") + (activeLocation + 1)) + " (" + (activeLocation + 1) +
+           "/" + CFG_LOCATION_COUNT + ")";
+}
+
+// Titles, battery outline and one card frame per configured forecast day.
+void drawDashboardChrome()
+{
+    setTextSizeCompat(4);
+    textRenderer.drawString(dashboardTitle(), 30, 30);
+    drawBatteryOutline();
+
+    setTextSizeCompat(3);
+    char heading[24];
+    snprintf(heading, sizeof(heading), "%u-Day Forecast", (unsigned)CFG_FORECAST_DAYS);
+    textRenderer.drawString(heading, 30, 330);
+
+    const int cardWidth = forecastCardWidth();
+    for (int i = 0; i < CFG_FORECAST_DAYS; ++i)
+    {
+        const int x = FORECAST_CARD_X + i * (cardWidth + FORECAST_CARD_SPACING);
+        canvas.drawRoundRect(x, FORECAST_CARD_Y, cardWidth, FORECAST_CARD_HEIGHT, 12, COLOR_BLACK);
+    }
+}
+
+// Contents of the forecast cards, inside the frames drawn by the chrome.
+void drawForecastCards()
+{
+    constexpr int baseY = FORECAST_CARD_Y;
+    constexpr int cardHeight = FORECAST_CARD_HEIGHT;
+    const int cardWidth = forecastCardWidth();
+    // Below this, "72.4F / 55.1 F" no longer fits and whole degrees are shown.
+    const bool compact = cardWidth < 260;
+    for (int i = 0; i < CFG_FORECAST_DAYS; ++i)
+    {
+        const int x = FORECAST_CARD_X + i * (cardWidth + FORECAST_CARD_SPACING);
+
+        const DailyForecast &forecast = latestWeather.days[i];
+        if (forecast.timestamp == 0)
+        {
+            continue;
+        }
+
+        setTextSizeCompat(3);
+        textRenderer.drawString(formatDayOfWeek(forecast.timestamp), x + 20, baseY + 16);
+
+        setTextSizeCompat(3);
+        String tempText;
+        if (std::isnan(forecast.maxTemperature) || std::isnan(forecast.minTemperature))
+        {
+            tempText = "-- F / -- F";
+        }
+        else if (compact)
+        {
+            tempText = String(forecast.maxTemperature, 0) + "/" + String(forecast.minTemperature, 0) + " F";
+        }
+        else
+        {
+            tempText = String(forecast.maxTemperature, 1) + "F / " + String(forecast.minTemperature, 1) + " F";
+        }
+        drawStringWithDegrees(tempText, x + 20, baseY + 56);
+
+        setTextSizeCompat(2);
+        const String summary = forecast.summary[0] != '\0' ? capitalizeWords(forecast.summary) : String("--");
+        const int summaryX = x + 20;
+        const int summaryY = baseY + 96;
+        const int summaryLineHeight = 22;
+        const int maxSummaryWidth = cardWidth - 40;
+        const int maxSummaryBottom = baseY + cardHeight - 16;
+        const int maxSummaryLines = (maxSummaryBottom - summaryY) / summaryLineHeight + 1;
+        const TextLayout summaryLayout = textLayout.layout(summary, resolveTextSize(2), maxSummaryWidth, maxSummaryLines);
+        textLayout.draw(summary, summaryLayout, summaryX, summaryY, summaryLineHeight);
+    }
+}
+
+void renderDisplay(const DisplayInputs &inputs)
 {
     if (!canvasReady)
     {
@@ -880,19 +2445,13 @@ void renderDisplay(float indoorTemp, float indoorHumidity, bool indoorValid)
         return;
     }
 
-    canvas.fillCanvas(COLOR_WHITE);
-    canvas.setTextColor(COLOR_BLACK);
-    canvas.setTextDatum(TL_DATUM);
-
-    setTextSizeCompat(4);
-    canvas.drawString("Home Weather Dashboard", 30, 30);
+    beginFrame(ChromeLayer::Dashboard, drawDashboardChrome);
 
     setTextSizeCompat(2);
-    canvas.drawString(String("WiFi: ") + (WiFi.status() == WL_CONNECTED ? WiFi.SSID() : String("Disconnected")), 30, 90);
-    const String updatedText = latestWeather.updatedAt != 0 ? formatTimestamp(latestWeather.updatedAt) : String("Pending");
-    canvas.drawString(String("Updated: ") + updatedText, 30, 130);
+    textRenderer.drawString(String("WiFi: ") + (inputs.wifiSsid[0] != '\0' ? inputs.wifiSsid : "Disconnected"), 30, 90);
+    textRenderer.drawString(formatUpdatedLine(inputs.renderedAt), 30, 130);
 
-    drawBatteryIndicator(readBatteryLevel());
+    drawBatteryIndicator(inputs.batteryLevel);
 
     setTextSizeCompat(8);
     if (std::isnan(latestWeather.outdoorTemperature))
@@ -905,340 +2464,1001 @@ void renderDisplay(float indoorTemp, float indoorHumidity, bool indoorValid)
     }
 
     setTextSizeCompat(3);
-    const String description = latestWeather.outdoorDescription.length() > 0 ? capitalizeWords(latestWeather.outdoorDescription) : String("Waiting for data");
-    canvas.drawString(description, 30, 260);
+    const String description = latestWeather.outdoorDescription[0] != '\0' ? capitalizeWords(latestWeather.outdoorDescription) : String("Waiting for data");
+    textRenderer.drawString(description, 30, 260);
+
+    setTextSizeCompat(3);
+    const int indoorTextY = 90;
+    if (inputs.indoorValid)
+    {
+        const String indoorLine = "Indoor: " + String(inputs.indoorTemp, 1) + " F  " + String(inputs.indoorHumidity, 1) + "% RH";
+        const int indoorWidth = textRenderer.textWidth(indoorLine);
+        const int indoorDrawX = CANVAS_WIDTH - 30 - indoorWidth;
+        drawStringWithDegrees(indoorLine, indoorDrawX, indoorTextY);
+    }
+    else
+    {
+        const String indoorMessage = "Indoor sensor not available";
+        const int indoorWidth = textRenderer.textWidth(indoorMessage);
+        const int indoorDrawX = CANVAS_WIDTH - 30 - indoorWidth;
+        textRenderer.drawString(indoorMessage, indoorDrawX, indoorTextY);
+    }
+
+    drawErrorBadge(inputs, CANVAS_WIDTH - 30, 140);
+
+    drawForecastCards();
+}
+
+// Streams a JSON response straight from the socket into `doc`, keeping only
+// the fields selected by `filter`. The body is never buffered in a String, and
+// anything larger than `maxBytes` is rejected instead of growing the heap.
+// The request goes over the pooled keep-alive connection to the URL's host.
+bool requestFilteredJson(const String &url, const char *label, const JsonDocument &filter, JsonDocument &doc,
+                         size_t maxBytes)
+{
+    const uint32_t heapBefore = ESP.getFreeHeap();
+    // The core cannot reset the heap low-water mark. If this request lowers it,
+    // the new mark gives its exact peak; otherwise the old one only bounds it.
+    const uint32_t lowWaterBefore = ESP.getMinFreeHeap();
+    const uint32_t requestStart = millis();
+
+    static const char *collectedHeaders[] = {"Date", "Transfer-Encoding"};
+    RequestTimings timings;
+    HTTPClient *http = nullptr;
+    fetchJob.httpStatus = 0;
+    int code = 0;
+    // A kept-alive connection the server has since dropped fails here too; the retry reconnects.
+    for (int attempt = 0; attempt < 2 && code <= 0; ++attempt)
+    {
+        if (attempt > 0)
+        {
+            Serial.printf("[Weather] %s HTTP error: %s (%d)\n", label, HTTPClient::errorToString(code).c_str(), code);
+            connectionPool.end(http, false);
+        }
+        http = connectionPool.begin(url, timings);
+        fetchJob.perf.add(PerfPhase::Dns, timings.dnsMs * 1000LL);
+        fetchJob.perf.add(PerfPhase::Connect, timings.connectMs * 1000LL);
+        if (http == nullptr)
+        {
+            code = HTTPC_ERROR_CONNECTION_REFUSED;
+            continue;
+        }
+        http->setTimeout(attempt == 0 ? 12000 : 15000);
+        http->collectHeaders(collectedHeaders, 2);
+        const uint32_t sendStart = millis();
+        {
+            ScopedPerfTimer timer(fetchJob.perf, PerfPhase::Http);
+            code = http->GET();
+        }
+        timings.firstByteMs = millis() - sendStart;
+        Serial.printf("[Weather] %s HTTP %s: %d\n", label, attempt == 0 ? "status code" : "retry status", code);
+    }
+    fetchJob.httpStatus = code;
+    if (http == nullptr)
+    {
+        fetchJob.errorMessage = String("Weather update failed: could not connect (") + label + ")";
+        return false;
+    }
+    if (code > 0)
+    {
+        const time_t serverEpoch = parseHttpDate(http->header("Date"));
+        if (serverEpoch != 0)
+        {
+            fetchJob.serverEpoch = serverEpoch;
+        }
+    }
+
+    if (code != HTTP_CODE_OK)
+    {
+        // Only echo the start of an error body; it is diagnostic, not data. It is
+        // framed like a 200 body: on a kept-alive socket the server does not close
+        // after it, so an unbounded read would sit out the whole stream timeout.
+        char errorBody[257];
+        size_t errorLength = 0;
+        if (code > 0)
+        {
+            HttpBodyStream body(http->getStream(), http->getSize(),
+                                http->header("Transfer-Encoding").equalsIgnoreCase("chunked"));
+            errorLength = body.readBytes(errorBody, sizeof(errorBody) - 1);
+        }
+        errorBody[errorLength] = '\0';
+        if (errorLength > 0)
+        {
+            Serial.printf("[Weather] %s response body: %s\n", label, errorBody);
+        }
+        fetchJob.errorMessage = String("Weather update failed: HTTP ") + code;
+        connectionPool.end(http, false);
+        return false;
+    }
+
+    const int declaredSize = http->getSize();
+    if (declaredSize > 0 && static_cast<size_t>(declaredSize) > maxBytes)
+    {
+        Serial.printf("[Weather] %s response too large: %d bytes (cap %u)\n", label, declaredSize, (unsigned)maxBytes);
+        fetchJob.errorMessage = "Weather update failed: response too large";
+        connectionPool.end(http, false);
+        return false;
+    }
+
+    const uint32_t transferStart = millis();
+    const bool chunked = http->header("Transfer-Encoding").equalsIgnoreCase("chunked");
+    HttpBodyStream body(http->getStream(), declaredSize, chunked);
+    CappedStreamReader reader{&body, maxBytes};
+    DeserializationError err;
+    {
+        ScopedPerfTimer timer(fetchJob.perf, PerfPhase::Parse);
+        err = deserializeJson(doc, reader, DeserializationOption::Filter(filter));
+    }
+    const uint32_t parseMs = millis() - transferStart;
+    const uint32_t heapAfterParse = ESP.getFreeHeap();
+    // The parser stops at the closing brace; read up to the end of the body so
+    // the connection is in step for the next request.
+    bool reusable = false;
+    {
+        ScopedPerfTimer timer(fetchJob.perf, PerfPhase::Http);
+        reusable = !reader.truncated && body.drain(KEEP_ALIVE_DRAIN_BYTES);
+    }
+    timings.transferMs = millis() - transferStart;
+    connectionPool.end(http, reusable);
+    timings.log(label);
+
+    Serial.printf("[Weather] %s: %u bytes streamed, parse %lu ms (total %lu ms), doc %u/%u bytes\n",
+                  label, (unsigned)reader.consumed, (unsigned long)parseMs, (unsigned long)(millis() - requestStart),
+                  (unsigned)doc.memoryUsage(), (unsigned)doc.capacity());
+    const uint32_t lowWater = ESP.getMinFreeHeap();
+    Serial.printf("[Weather] %s heap: free %u -> %u after parse, peak use %s%d, low-water %u, largest block %u\n",
+                  label, heapBefore, heapAfterParse, lowWater < lowWaterBefore ? "" : "<= ",
+                  (int)(heapBefore - lowWater), lowWater, ESP.getMaxAllocHeap());
+
+    if (reader.truncated)
+    {
+        Serial.printf("[Weather] %s response exceeded %u byte cap.\n", label, (unsigned)maxBytes);
+        fetchJob.errorMessage = "Weather update failed: response too large";
+        return false;
+    }
+    if (err)
+    {
+        Serial.printf("[Weather] %s JSON parse error: %s\n", label, err.c_str());
+        fetchJob.errorMessage = String("Weather update failed: JSON ") + err.c_str();
+        return false;
+    }
+    if (doc.overflowed())
+    {
+        Serial.printf("[Weather] %s document overflowed; some entries were dropped.\n", label);
+    }
+    return true;
+}
+
+// Two requests: /weather for current conditions and the 5-day /forecast,
+// whose 3-hourly entries are folded into per-day min/max.
+bool fetchWeatherForecastApi()
+{
+    WeatherSnapshot &snapshot = fetchJob.snapshot();
+    const String currentUrl = CFG_OWM_BASE_URL + "/data/2.5/weather?lat=" +
+                              String(fetchJob.target().latitude, 6) + "&lon=" +
+                              String(fetchJob.target().longitude, 6) + "&units=" +
+                              CFG_OWM_UNITS + "&lang=" + CFG_OWM_LANGUAGE + "&appid=" + CFG_OWM_API_KEY;
+
+    StaticJsonDocument<256> currentFilter;
+    currentFilter["dt"] = true;
+    currentFilter["timezone"] = true;
+    currentFilter["main"]["temp"] = true;
+    currentFilter["weather"][0]["id"] = true;
+    currentFilter["weather"][0]["icon"] = true;
+    currentFilter["weather"][0]["description"] = true;
+
+    DynamicJsonDocument currentDoc(CURRENT_DOC_CAPACITY);
+    if (!requestFilteredJson(currentUrl, "Current", currentFilter, currentDoc, MAX_CURRENT_RESPONSE_BYTES))
+    {
+        return false;
+    }
+
+    const int timezoneOffsetSeconds = currentDoc["timezone"].as<int>();
+    snapshot.outdoorTemperature = currentDoc["main"]["temp"].as<float>();
+    copyText(snapshot.outdoorDescription, currentDoc["weather"][0]["description"].as<const char *>());
+    snapshot.currentIconId = currentDoc["weather"][0]["id"].as<int>();
+    copyText(snapshot.currentIconCode, currentDoc["weather"][0]["icon"].as<const char *>());
+    snapshot.updatedAt = currentDoc["dt"].as<long>() + timezoneOffsetSeconds;
+
+    const String forecastUrl = CFG_OWM_BASE_URL + "/data/2.5/forecast?lat=" +
+                               String(fetchJob.target().latitude, 6) + "&lon=" +
+                               String(fetchJob.target().longitude, 6) + "&units=" +
+                               CFG_OWM_UNITS + "&lang=" + CFG_OWM_LANGUAGE + "&appid=" + CFG_OWM_API_KEY;
+
+    StaticJsonDocument<256> forecastFilter;
+    forecastFilter["city"]["timezone"] = true;
+    forecastFilter["list"][0]["dt"] = true;
+    forecastFilter["list"][0]["main"]["temp"] = true;
+    forecastFilter["list"][0]["pop"] = true;
+    forecastFilter["list"][0]["weather"][0]["id"] = true;
+    forecastFilter["list"][0]["weather"][0]["icon"] = true;
+    forecastFilter["list"][0]["weather"][0]["description"] = true;
+
+    DynamicJsonDocument forecastDoc(FORECAST_DOC_CAPACITY);
+    if (!requestFilteredJson(forecastUrl, "Forecast", forecastFilter, forecastDoc, MAX_FORECAST_RESPONSE_BYTES))
+    {
+        return false;
+    }
+
+    ScopedPerfTimer aggregateTimer(fetchJob.perf, PerfPhase::Aggregate);
+    JsonArray list = forecastDoc["list"].as<JsonArray>();
+    if (list.isNull() || list.size() == 0)
+    {
+        fetchJob.errorMessage = "Weather update failed: empty forecast";
+        return false;
+    }
+
+    const int forecastTimezoneOffset = forecastDoc["city"]["timezone"].as<int>();
+
+    DayAggregator<MAX_FORECAST_DAYS> aggregator(CFG_FORECAST_DAYS);
+    snapshot.timeline = ForecastTimeline();
+
+    for (JsonObject entry : list)
+    {
+        const time_t localTs = static_cast<time_t>(entry["dt"].as<long>() + forecastTimezoneOffset);
+        const float temp = entry["main"]["temp"] | NAN;
+        const int iconId = entry["weather"][0]["id"].as<int>();
+        snapshot.timeline.append(localTs, temp, iconId, entry["weather"][0]["icon"].as<const char *>(),
+                                      entry["pop"] | NAN);
+        aggregator.add(localTs, temp, iconId, entry["weather"][0]["description"].as<const char *>());
+    }
+    aggregator.finish(snapshot.days);
+    for (size_t i = aggregator.size(); i < MAX_FORECAST_DAYS; ++i)
+    {
+        snapshot.days[i] = DailyForecast();
+    }
+
+    return true;
+}
+
+// One request to One Call: current conditions, 48 hourly points for the
+// timeline and a daily forecast with the day's min/max already computed.
+// daily[0] is today, so days 1..3 are shown.
+bool fetchWeatherOneCall(WeatherBackend backend)
+{
+    WeatherSnapshot &snapshot = fetchJob.snapshot();
+    StaticJsonDocument<512> filter;
+    filter["timezone_offset"] = true;
+    filter["current"]["dt"] = true;
+    filter["current"]["temp"] = true;
+    filter["current"]["weather"][0]["id"] = true;
+    filter["current"]["weather"][0]["icon"] = true;
+    filter["current"]["weather"][0]["description"] = true;
+    filter["hourly"][0]["dt"] = true;
+    filter["hourly"][0]["temp"] = true;
+    filter["hourly"][0]["pop"] = true;
+    filter["hourly"][0]["weather"][0]["id"] = true;
+    filter["hourly"][0]["weather"][0]["icon"] = true;
+    filter["daily"][0]["dt"] = true;
+    filter["daily"][0]["temp"]["min"] = true;
+    filter["daily"][0]["temp"]["max"] = true;
+    filter["daily"][0]["weather"][0]["id"] = true;
+    filter["daily"][0]["weather"][0]["icon"] = true;
+    filter["daily"][0]["weather"][0]["description"] = true;
+
+    const char *label = backend == WeatherBackend::OneCall30 ? "OneCall 3.0" : "OneCall 2.5";
+    DynamicJsonDocument doc(ONECALL_DOC_CAPACITY);
+    if (!requestFilteredJson(buildApiUrl(backend), label, filter, doc, MAX_ONECALL_RESPONSE_BYTES))
+    {
+        return false;
+    }
+
+    ScopedPerfTimer aggregateTimer(fetchJob.perf, PerfPhase::Aggregate);
+    JsonObject current = doc["current"].as<JsonObject>();
+    JsonArray daily = doc["daily"].as<JsonArray>();
+    if (current.isNull() || daily.isNull() || daily.size() < 2)
+    {
+        fetchJob.errorMessage = "Weather update failed: incomplete One Call response";
+        return false;
+    }
+
+    const int timezoneOffsetSeconds = doc["timezone_offset"].as<int>();
+    snapshot.outdoorTemperature = current["temp"].as<float>();
+    copyText(snapshot.outdoorDescription, current["weather"][0]["description"].as<const char *>());
+    snapshot.currentIconId = current["weather"][0]["id"].as<int>();
+    copyText(snapshot.currentIconCode, current["weather"][0]["icon"].as<const char *>());
+    snapshot.updatedAt = current["dt"].as<long>() + timezoneOffsetSeconds;
+
+    snapshot.timeline = ForecastTimeline();
+    for (JsonObject hour : doc["hourly"].as<JsonArray>())
+    {
+        snapshot.timeline.append(hour["dt"].as<long>() + timezoneOffsetSeconds, hour["temp"] | NAN,
+                                      hour["weather"][0]["id"].as<int>(), hour["weather"][0]["icon"].as<const char *>(),
+                                      hour["pop"] | NAN);
+    }
+
+    for (size_t i = 0; i < MAX_FORECAST_DAYS; ++i)
+    {
+        DailyForecast &forecast = snapshot.days[i];
+        forecast = DailyForecast();
+        JsonObject day = daily[i + 1];
+        if (i >= CFG_FORECAST_DAYS || day.isNull())
+        {
+            continue;
+        }
+        forecast.timestamp = day["dt"].as<long>() + timezoneOffsetSeconds;
+        forecast.minTemperature = day["temp"]["min"] | NAN;
+        forecast.maxTemperature = day["temp"]["max"] | NAN;
+        copyText(forecast.summary, day["weather"][0]["description"].as<const char *>());
+        forecast.iconId = day["weather"][0]["id"].as<int>();
+        copyText(forecast.iconCode, day["weather"][0]["icon"].as<const char *>());
+    }
+    return true;
+}
+
+bool fetchWeather()
+{
+    Serial.println("[Weather] Requesting latest conditions from OpenWeather...");
+    fetchJob.errorMessage.clear();
+
+    bool fetched = false;
+    if (CFG_WEATHER_BACKEND != WeatherBackend::Forecast && !oneCallRejected)
+    {
+        fetched = fetchWeatherOneCall(CFG_WEATHER_BACKEND);
+        if (!fetched && fetchJob.httpStatus <= 0)
+        {
+            // No answer at all: the second path would only burn more radio time.
+            return false;
+        }
+        if (!fetched && (fetchJob.httpStatus == 401 || fetchJob.httpStatus == 403 || fetchJob.httpStatus == 404))
+        {
+            Serial.println("[Weather] One Call not available for this key; using /weather + /forecast until reboot.");
+            oneCallRejected = true;
+        }
+        if (!fetched)
+        {
+            Serial.println("[Weather] Falling back to /weather + /forecast.");
+            fetchJob.errorMessage.clear();
+        }
+    }
+    if (!fetched && !fetchWeatherForecastApi())
+    {
+        return false;
+    }
+    Serial.println("[Weather] Weather data parsed successfully.");
+    return true;
+}
+
+// Network half of a weather update, on the network task: Wi-Fi, the
+// OpenWeather requests and the icon downloads, one stage after another. It
+// touches nothing but fetchJob, the radio and the connection pool; the
+// snapshot, SD card and display are left to finishWeatherUpdate().
+void runFetchJob()
+{
+    FetchJob &job = fetchJob;
+    job.perf.beginCycle("fetch", 0);
+    const uint32_t radioStart = millis();
+    FetchStage stage = FetchStage::Connecting;
+    while (stage != FetchStage::Done)
+    {
+        switch (stage)
+        {
+        case FetchStage::Connecting:
+        {
+            bool connected = false;
+            {
+                ScopedPerfTimer timer(job.perf, PerfPhase::Wifi);
+                connected = connectToWifi(job.wifi);
+            }
+            if (!connected)
+            {
+                Serial.println("[Update] WiFi connection failed.");
+                job.failure = FetchFailure::WiFi;
+                job.errorMessage = String("WiFi connection failed: ") + wifiFailureText(job.wifi.failure);
+                stage = FetchStage::Done;
+                break;
+            }
+            copyText(job.ssid, WiFi.SSID().c_str());
+            Serial.println("[Update] WiFi connected; fetching weather.");
+            stage = FetchStage::Requesting;
+            break;
+        }
+        case FetchStage::Requesting:
+        {
+            // Every due location over the same keep-alive connection. The
+            // first failure is the one reported; the others still land.
+            FetchFailure failure = FetchFailure::None;
+            String message;
+            bool anyFetched = false;
+            for (uint8_t i = 0; i < MAX_LOCATIONS; ++i)
+            {
+                if (!job.targets[i].wanted)
+                {
+                    continue;
+                }
+                job.location = i;
+                if (fetchWeather())
+                {
+                    job.targets[i].fetched = true;
+                    anyFetched = true;
+                    continue;
+                }
+                Serial.printf("[Update] Weather download or parse failed for location %u.\n", (unsigned)i);
+                if (failure == FetchFailure::None)
+                {
+                    // A 200 that still failed means the body was unusable.
+                    failure = job.httpStatus == HTTP_CODE_OK ? FetchFailure::Parse : FetchFailure::Http;
+                    message = job.errorMessage.length() != 0 ? job.errorMessage : String("Weather update failed");
+                }
+                if (job.httpStatus <= 0)
+                {
+                    // No answer at all: the other locations would only burn more radio time.
+                    break;
+                }
+            }
+            job.failure = failure;
+            job.errorMessage = message;
+            stage = anyFetched ? FetchStage::Icons : FetchStage::Done;
+            break;
+        }
+        case FetchStage::Icons:
+        {
+            ScopedPerfTimer timer(job.perf, PerfPhase::Icons);
+            downloadMissingIcons(job);
+            stage = FetchStage::Done;
+            break;
+        }
+        case FetchStage::Done:
+            break;
+        }
+    }
+    powerDownWifi();
+    job.radioMs = millis() - radioStart;
+}
+
+// The first location keeps the original cache file.
+String locationSnapshotPath(size_t location)
+{
+    if (location == 0)
+    {
+        return SNAPSHOT_PATH;
+    }
+    char path[32];
+    snprintf(path, sizeof(path), "%s/weather-%u.bin", SNAPSHOT_DIR, (unsigned)location);
+    return path;
+}
+
+void persistSnapshot(size_t location, const WeatherSnapshot &snapshot)
+{
+    if (!ensureSdReady())
+    {
+        return;
+    }
+    SD.mkdir(SNAPSHOT_DIR);
+    if (saveSnapshot(SD, locationSnapshotPath(location).c_str(), snapshot))
+    {
+        Serial.printf("[Snapshot] Saved weather snapshot %u to SD.\n", (unsigned)location);
+    }
+}
+
+// Loads a location's last good snapshot from SD. Returns false if there is
+// none, it fails validation or it was fetched for other coordinates (the
+// locations list was edited).
+bool loadLocationSnapshot(size_t location, WeatherSnapshot &snapshot)
+{
+    if (!ensureSdReady())
+    {
+        return false;
+    }
+    WeatherSnapshot cached;
+    if (!loadSnapshot(SD, locationSnapshotPath(location).c_str(), cached))
+    {
+        return false;
+    }
+    const WeatherLocation &configured = CFG_LOCATIONS[location];
+    if (!(fabsf(cached.latitude - configured.latitude) < 1e-4F && fabsf(cached.longitude - configured.longitude) < 1e-4F))
+    {
+        Serial.printf("[Snapshot] Cache %u is for another location; ignoring it.\n", (unsigned)location);
+        return false;
+    }
+    snapshot = cached;
+    return true;
+}
+
+// Loads the shown location's snapshot into latestWeather.
+bool restoreSnapshot()
+{
+    if (!loadLocationSnapshot(activeLocation, latestWeather))
+    {
+        return false;
+    }
+    Serial.printf("[Snapshot] Restored weather fetched at %ld.\n", (long)latestWeather.fetchedAt);
+    return true;
+}
+
+// Sizes the history ring for the configured indoor interval. The SD log is
+// replayed only once the history page is drawn (see loadClimateHistory()).
+void initClimateHistory()
+{
+    climateHistoryReady = climateHistory.begin(CFG_INDOOR_UPDATE_INTERVAL / 1000UL);
+}
+
+// Adds a scheduled reading to the history; the SD log is appended once a block is pending.
+void recordClimate(const DisplayInputs &inputs)
+{
+    if (!climateHistoryReady || !inputs.indoorValid || inputs.renderedAt < MIN_VALID_EPOCH)
+    {
+        return;
+    }
+    climateHistory.record(inputs.renderedAt, inputs.indoorTemp, inputs.indoorHumidity);
+    if (ensureSdReady())
+    {
+        SD.mkdir(SNAPSHOT_DIR);
+        climateHistory.flush(SD, CLIMATE_LOG_PATH);
+    }
+}
 
-    setTextSizeCompat(3);
-    const int indoorTextY = 90;
-    if (indoorValid)
+// Schedules the retry for a failed update. Once there is weather on screen the
+// failure only adds a badge to it (a partial refresh); before that, the status
+// message is repainted only when its text changes.
+void handleFetchFailure(FetchFailure kind, const String &message)
+{
+    const time_t delaySeconds = fetchScheduler.recordFailure(kind, currentEpoch(), esp_random());
+    Serial.printf("[Update] %s; next attempt in %ld s.\n", message.c_str(), (long)delaySeconds);
+    if (latestWeather.updatedAt != 0)
     {
-        const String indoorLine = "Indoor: " + String(indoorTemp, 1) + " F  " + String(indoorHumidity, 1) + "% RH";
-        const int indoorWidth = canvas.textWidth(indoorLine);
-        const int indoorDrawX = CANVAS_WIDTH - 30 - indoorWidth;
-        drawStringWithDegrees(indoorLine, indoorDrawX, indoorTextY);
+        renderUi(captureDisplayInputs());
     }
-    else
+    else if (panelShowsUi || shownStatusMessage != message)
     {
-        const String indoorMessage = "Indoor sensor not available";
-        const int indoorWidth = canvas.textWidth(indoorMessage);
-        const int indoorDrawX = CANVAS_WIDTH - 30 - indoorWidth;
-        canvas.drawString(indoorMessage, indoorDrawX, indoorTextY);
+        renderStatusMessage(message);
     }
+}
 
-    setTextSizeCompat(3);
-    canvas.drawString("3-Day Forecast", 30, 330);
-
-    drawForecastCards();
-    
-    pushCanvasSmart();
+const char *updateCycleName(UpdateCycle kind)
+{
+    return kind == UpdateCycle::Weather ? "weather" : "indoor";
 }
 
-bool fetchWeather()
+// Brackets a scheduled update with battery readings and phase timings.
+void beginUpdateCycle(UpdateCycle kind)
 {
-    Serial.println("[Weather] Requesting latest conditions from OpenWeather...");
-    lastErrorMessage.clear();
-
-    WiFiClientSecure client;
-    client.setInsecure();
-
-    // HTTP client for current + forecast requests
-    HTTPClient http;
-    http.setTimeout(12000);
-    
-    const String currentUrl = String("https://api.openweathermap.org/data/2.5/weather?lat=") +
-                              String(CFG_OWM_LATITUDE, 6) + "&lon=" +
-                              String(CFG_OWM_LONGITUDE, 6) + "&units=" +
-                              CFG_OWM_UNITS + "&lang=" + CFG_OWM_LANGUAGE + "&appid=" + CFG_OWM_API_KEY;
+    const uint32_t batteryMv = readBatteryMillivolts();
+    batteryModel.beginCycle(batteryMv, currentEpoch());
+    perfLog.beginCycle(updateCycleName(kind), batteryMv);
+}
 
-    if (!http.begin(client, currentUrl))
+// Closes the cycle: feeds its voltage drop to the battery model and appends
+// its timings to the SD log.
+void endUpdateCycle(UpdateCycle kind, bool ok)
+{
+    const uint32_t batteryMv = readBatteryMillivolts();
+    const bool wasLow = batteryModel.lowBattery();
+    batteryModel.endCycle(kind, batteryMv, currentEpoch());
+    Serial.printf("[Battery] %lu mV, %.1f%%; per cycle weather %.3f%%, indoor %.3f%%, sleep %.3f%%/h; intervals x%.2f\n",
+                  (unsigned long)batteryMv, batteryModel.percent(), batteryModel.cycleCost(UpdateCycle::Weather),
+                  batteryModel.cycleCost(UpdateCycle::Indoor), batteryModel.sleepCostPerHour(), intervalStretch());
+    if (batteryModel.lowBattery() != wasLow)
     {
-        lastErrorMessage = "Weather update failed: HTTP client init";
-        Serial.println("[Weather] HTTP client failed to initialise (current).");
-        return false;
+        Serial.println(batteryModel.lowBattery() ? "[Battery] Low battery: weather paused, partial refreshes only."
+                                                 : "[Battery] Battery recovered; weather updates resume.");
     }
-
-    int currentCode = http.GET();
-    Serial.printf("[Weather] Current HTTP status code: %d\n", currentCode);
-    if (currentCode <= 0)
+    if (ensureSdReady())
     {
-        Serial.printf("[Weather] Current HTTP error: %s (%d)\n", http.errorToString(currentCode).c_str(), currentCode);
-        http.end();
-        http.setTimeout(15000);
-        if (!http.begin(client, currentUrl))
-        {
-            lastErrorMessage = "Weather update failed: HTTP client init (retry)";
-            return false;
-        }
-        currentCode = http.GET();
-        Serial.printf("[Weather] Current HTTP retry status: %d\n", currentCode);
+        SD.mkdir(PERF_LOG_DIR);
+        perfLog.endCycle(SD, PERF_LOG_PATH, PERF_LOG_MAX_BYTES, currentEpoch(), ok, batteryMv);
     }
-    String currentPayload;
-    if (currentCode == HTTP_CODE_OK)
+}
+
+// Picks the locations one radio wake serves: every location due now, plus
+// those that would fall due within half the shortest interval and would
+// otherwise need a wake of their own. Their cadences drift into step.
+void selectDueLocations(FetchJob &job, time_t now)
+{
+    time_t shortest = weatherIntervalSeconds(0);
+    for (size_t i = 1; i < CFG_LOCATION_COUNT; ++i)
     {
-        currentPayload = http.getString();
+        shortest = std::min(shortest, weatherIntervalSeconds(i));
     }
-    else
+    const time_t horizon = now + shortest / 2;
+    size_t wanted = 0;
+    size_t mostOverdue = 0;
+    time_t earliestDue = 0;
+    for (size_t i = 0; i < MAX_LOCATIONS; ++i)
     {
-        currentPayload = http.getString();
-        if (currentPayload.length() > 0)
+        if (i >= CFG_LOCATION_COUNT)
         {
-            Serial.printf("[Weather] Current response body: %s\n", currentPayload.c_str());
+            job.targets[i] = FetchTarget{NAN, NAN, false, false};
+            continue;
+        }
+        const time_t dueAt = lastWeatherEpoch[i] + weatherIntervalSeconds(i);
+        job.targets[i] = FetchTarget{CFG_LOCATIONS[i].latitude, CFG_LOCATIONS[i].longitude, dueAt <= horizon, false};
+        wanted += job.targets[i].wanted ? 1 : 0;
+        if (i == 0 || dueAt < earliestDue)
+        {
+            mostOverdue = i;
+            earliestDue = dueAt;
         }
-        lastErrorMessage = String("Weather update failed: HTTP ") + currentCode;
-        http.end();
-        return false;
     }
-    http.end();
-
-    DynamicJsonDocument currentDoc(8 * 1024);
-    DeserializationError currentErr = deserializeJson(currentDoc, currentPayload);
-    if (currentErr)
+    if (wanted == 0)
     {
-        Serial.printf("[Weather] Current JSON parse error: %s\n", currentErr.c_str());
-        lastErrorMessage = String("Weather update failed: JSON ") + currentErr.c_str();
-        return false;
+        // A retry after a failure can come before the location that failed is
+        // due; it is still the one to fetch.
+        job.targets[mostOverdue].wanted = true;
     }
+}
 
-    const int timezoneOffsetSeconds = currentDoc["timezone"].as<int>();
-    latestWeather.outdoorTemperature = currentDoc["main"]["temp"].as<float>();
-    latestWeather.outdoorDescription = currentDoc["weather"][0]["description"].as<String>();
-    latestWeather.currentIconId = currentDoc["weather"][0]["id"].as<int>();
-    latestWeather.currentIconCode = currentDoc["weather"][0]["icon"].as<String>();
-    latestWeather.updatedAt = currentDoc["dt"].as<long>() + timezoneOffsetSeconds;
-
-    http.setTimeout(12000);
-    const String forecastUrl = String("https://api.openweathermap.org/data/2.5/forecast?lat=") +
-                               String(CFG_OWM_LATITUDE, 6) + "&lon=" +
-                               String(CFG_OWM_LONGITUDE, 6) + "&units=" +
-                               CFG_OWM_UNITS + "&lang=" + CFG_OWM_LANGUAGE + "&appid=" + CFG_OWM_API_KEY;
+// Starts a weather update: the network half runs on netWorker and the loop
+// calls finishWeatherUpdate() once it is done.
+void startWeatherUpdate()
+{
+    Serial.println("[Update] Starting weather refresh cycle...");
+    beginUpdateCycle(UpdateCycle::Weather);
+    FetchJob &job = fetchJob;
+    selectDueLocations(job, currentEpoch());
+    for (size_t i = 0; i < MAX_LOCATIONS; ++i)
+    {
+        job.snapshots[i] = i == activeLocation ? latestWeather : WeatherSnapshot();
+    }
+    job.location = activeLocation;
+    markMissingIcons(job);
+    job.failure = FetchFailure::None;
+    job.errorMessage = String();
+    job.httpStatus = 0;
+    job.serverEpoch = 0;
+    job.ssid[0] = '\0';
+    job.radioMs = 0;
+    netWorker.start();
+}
 
-    if (!http.begin(client, forecastUrl))
+// UI half of a weather update, once the network task has handed fetchJob back.
+void finishWeatherUpdate()
+{
+    FetchJob &job = fetchJob;
+    perfLog.merge(job.perf);
+    fetchScheduler.chargeRadio(currentEpoch(), job.radioMs);
+    bool anyFetched = false;
+    for (const FetchTarget &target : job.targets)
     {
-        lastErrorMessage = "Weather update failed: HTTP client init";
-        Serial.println("[Weather] HTTP client failed to initialise (forecast).");
-        return false;
+        anyFetched = anyFetched || target.fetched;
+    }
+    if (!anyFetched)
+    {
+        freeIconDownloads(job);
+        handleFetchFailure(job.failure, job.errorMessage);
+        endUpdateCycle(UpdateCycle::Weather, false);
+        return;
     }
 
-    int forecastCode = http.GET();
-    Serial.printf("[Weather] Forecast HTTP status code: %d\n", forecastCode);
-    if (forecastCode <= 0)
+    syncClock(job.serverEpoch);
+    const time_t fetchedAt = currentEpoch();
+    for (size_t i = 0; i < MAX_LOCATIONS; ++i)
     {
-        Serial.printf("[Weather] Forecast HTTP error: %s (%d)\n", http.errorToString(forecastCode).c_str(), forecastCode);
-        http.end();
-        http.setTimeout(15000);
-        if (!http.begin(client, forecastUrl))
+        WeatherSnapshot &snapshot = job.snapshots[i];
+        if (!job.targets[i].fetched)
         {
-            lastErrorMessage = "Weather update failed: HTTP client init (forecast retry)";
-            return false;
+            continue;
+        }
+        snapshot.fetchedAt = fetchedAt;
+        snapshot.latitude = job.targets[i].latitude;
+        snapshot.longitude = job.targets[i].longitude;
+        if (i == activeLocation)
+        {
+            latestWeather = snapshot;
         }
-        forecastCode = http.GET();
-        Serial.printf("[Weather] Forecast HTTP retry status: %d\n", forecastCode);
     }
-    String forecastPayload;
-    if (forecastCode == HTTP_CODE_OK)
     {
-        forecastPayload = http.getString();
+        ScopedPerfTimer timer(perfLog, PerfPhase::Icons);
+        prefetchOwmIcons(job);
     }
-    else
+    freeIconDownloads(job);
+    for (size_t i = 0; i < MAX_LOCATIONS; ++i)
     {
-        forecastPayload = http.getString();
-        if (forecastPayload.length() > 0)
+        if (job.targets[i].fetched)
         {
-            Serial.printf("[Weather] Forecast response body: %s\n", forecastPayload.c_str());
+            persistSnapshot(i, job.snapshots[i]);
         }
-        lastErrorMessage = String("Weather update failed: HTTP ") + forecastCode;
-        http.end();
-        return false;
     }
-    http.end();
-
-    DynamicJsonDocument forecastDoc(32 * 1024);
-    DeserializationError forecastErr = deserializeJson(forecastDoc, forecastPayload);
-    if (forecastErr)
+    if (job.failure != FetchFailure::None)
     {
-        Serial.printf("[Weather] Forecast JSON parse error: %s\n", forecastErr.c_str());
-        lastErrorMessage = String("Weather update failed: JSON ") + forecastErr.c_str();
-        return false;
+        // Some locations came through; the rest retry on the failure's backoff.
+        for (size_t i = 0; i < MAX_LOCATIONS; ++i)
+        {
+            lastWeatherEpoch[i] = job.targets[i].fetched ? fetchedAt : lastWeatherEpoch[i];
+        }
+        handleFetchFailure(job.failure, job.errorMessage);
+        endUpdateCycle(UpdateCycle::Weather, false);
+        return;
     }
+    fetchScheduler.recordSuccess();
 
-    JsonArray list = forecastDoc["list"].as<JsonArray>();
-    if (list.isNull() || list.size() == 0)
+    Serial.println("[Update] Rendering display.");
+    DisplayInputs inputs = captureDisplayInputs();
+    // The radio is already off again; show the network the data came over.
+    copyText(inputs.wifiSsid, job.ssid);
+    recordClimate(inputs);
+    renderUi(inputs);
+    const time_t now = currentEpoch();
+    for (size_t i = 0; i < MAX_LOCATIONS; ++i)
     {
-        lastErrorMessage = "Weather update failed: empty forecast";
-        return false;
+        lastWeatherEpoch[i] = job.targets[i].fetched ? now : lastWeatherEpoch[i];
     }
+    // Keep indoor timer aligned so we don't immediately trigger an indoor-only refresh.
+    lastIndoorEpoch = now;
+    Serial.println("[Update] Update cycle complete.");
+    endUpdateCycle(UpdateCycle::Weather, true);
+}
 
-    const int forecastTimezoneOffset = forecastDoc["city"]["timezone"].as<int>();
+// Read only the indoor sensor and refresh the display without using WiFi.
+void updateIndoorAndDisplay()
+{
+    Serial.println("[Indoor] Starting indoor-only refresh cycle...");
+    beginUpdateCycle(UpdateCycle::Indoor);
 
-    auto computeYmd = [](const struct tm &tmInfo) {
-        return (tmInfo.tm_year + 1900) * 10000 + (tmInfo.tm_mon + 1) * 100 + tmInfo.tm_mday;
-    };
+    Serial.println("[Indoor] Rendering display with latest weather snapshot.");
+    const DisplayInputs inputs = captureDisplayInputs();
+    recordClimate(inputs);
+    renderUi(inputs);
+    lastIndoorEpoch = currentEpoch();
+    Serial.println("[Indoor] Indoor-only update complete.");
+    endUpdateCycle(UpdateCycle::Indoor, true);
+}
 
-    time_t firstLocalTs = static_cast<time_t>(list[0]["dt"].as<long>() + forecastTimezoneOffset);
-    struct tm firstLocalTm;
-    gmtime_r(&firstLocalTs, &firstLocalTm);
-    const int firstYmd = computeYmd(firstLocalTm);
+// -------- Sleep scheduling --------
+// Earliest start of the next weather cycle: when the first location falls due.
+time_t nextWeatherEpoch()
+{
+    time_t next = fetchScheduler.nextAttempt(lastWeatherEpoch[0], weatherIntervalSeconds(0));
+    for (size_t i = 1; i < CFG_LOCATION_COUNT; ++i)
+    {
+        next = std::min(next, fetchScheduler.nextAttempt(lastWeatherEpoch[i], weatherIntervalSeconds(i)));
+    }
+    return next;
+}
 
-    DayAggregate aggregates[3];
-    int dayCount = 0;
+// No weather fetches on a low battery; the indoor updates keep the screen alive.
+bool weatherDue(time_t now)
+{
+    return !batteryModel.lowBattery() && now >= nextWeatherEpoch();
+}
 
-    for (JsonObject entry : list)
-    {
-        const long dtUtc = entry["dt"].as<long>();
-        time_t localTs = static_cast<time_t>(dtUtc + forecastTimezoneOffset);
-        struct tm localTm;
-        gmtime_r(&localTs, &localTm);
-        const int ymd = computeYmd(localTm);
+bool indoorDue(time_t now)
+{
+    return now - lastIndoorEpoch >= indoorIntervalSeconds();
+}
 
-        if (ymd == firstYmd)
-        {
-            continue;
-        }
+time_t nextScheduledEpoch()
+{
+    const time_t indoorAt = lastIndoorEpoch + indoorIntervalSeconds();
+    return batteryModel.lowBattery() ? indoorAt : std::min(nextWeatherEpoch(), indoorAt);
+}
 
-        int slot = -1;
-        for (int i = 0; i < dayCount; ++i)
-        {
-            if (aggregates[i].yyyymmdd == ymd)
-            {
-                slot = i;
-                break;
-            }
-        }
+// Cycle UI mode: main -> days 1..N -> timeline -> indoor history -> main.
+// Any step from the diagnostics page goes back to the dashboard.
+uint8_t nextUiMode(uint8_t mode)
+{
+    return mode == UI_MODE_DIAGNOSTICS ? 0 : (mode + 1) % uiModeCount();
+}
 
-        if (slot == -1)
-        {
-            if (dayCount >= 3)
-            {
-                break;
-            }
-            slot = dayCount++;
-            aggregates[slot].hasData = true;
-            aggregates[slot].localTimestamp = localTs;
-            aggregates[slot].yyyymmdd = ymd;
-            aggregates[slot].description.clear();
-            aggregates[slot].iconId = 0;
-            aggregates[slot].minTemperature = std::numeric_limits<float>::infinity();
-            aggregates[slot].maxTemperature = -std::numeric_limits<float>::infinity();
-        }
+uint8_t previousUiMode(uint8_t mode)
+{
+    return mode == UI_MODE_DIAGNOSTICS ? 0 : (mode + uiModeCount() - 1) % uiModeCount();
+}
 
-        const float temp = entry["main"]["temp"].as<float>();
-        const int iconId = entry["weather"][0]["id"].as<int>();
-        const char *iconCodeC = entry["weather"][0]["icon"].as<const char *>();
-        const char *desc = entry["weather"][0]["description"].as<const char *>();
+// Forecast day (0-based) whose dashboard card contains the point, or -1.
+int dashboardCardAt(uint16_t x, uint16_t y)
+{
+    if (y < FORECAST_CARD_Y || y >= FORECAST_CARD_Y + FORECAST_CARD_HEIGHT || x < FORECAST_CARD_X)
+    {
+        return -1;
+    }
+    const int pitch = forecastCardWidth() + FORECAST_CARD_SPACING;
+    const int day = (x - FORECAST_CARD_X) / pitch;
+    const bool onCard = (x - FORECAST_CARD_X) % pitch < forecastCardWidth();
+    return day < CFG_FORECAST_DAYS && onCard ? day : -1;
+}
 
-        if (!std::isnan(temp))
-        {
-            if (temp < aggregates[slot].minTemperature)
-            {
-                aggregates[slot].minTemperature = temp;
-            }
-            if (temp > aggregates[slot].maxTemperature)
-            {
-                aggregates[slot].maxTemperature = temp;
-            }
-        }
+// Whether a tap lands on the dashboard title, which selects the next location.
+bool locationTitleAt(uint8_t mode, uint16_t x, uint16_t y)
+{
+    return CFG_LOCATION_COUNT > 1 && mode == 0 && y < DASHBOARD_TITLE_BOTTOM && x < BATTERY_INDICATOR_X;
+}
 
-        if (aggregates[slot].description.length() == 0 && desc != nullptr)
-        {
-            aggregates[slot].description = desc;
-        }
-        if (aggregates[slot].iconId == 0 && iconId != 0)
-        {
-            aggregates[slot].iconId = iconId;
-        }
-        if (aggregates[slot].iconCode.length() == 0 && iconCodeC != nullptr)
-        {
-            aggregates[slot].iconCode = String(iconCodeC);
-        }
+// Makes `location` the one every view shows. Its snapshot comes from SD;
+// without one the views wait for its first fetch.
+void selectLocation(uint8_t location)
+{
+    activeLocation = location;
+    if (!loadLocationSnapshot(location, latestWeather))
+    {
+        latestWeather = WeatherSnapshot();
     }
+    // The dashboard title names the location.
+    chromeLayers.invalidate();
+    viewFrames.invalidate();
+}
 
-    for (int i = 0; i < 3; ++i)
+// View a gesture leads to from `mode`. Swipes page through the cycle, a tap on
+// a dashboard forecast card opens that day, any other tap steps forward and a
+// long press toggles the diagnostics page.
+uint8_t uiModeAfterGesture(const TouchEvent &event, uint8_t mode)
+{
+    switch (event.gesture)
     {
-        DailyForecast &forecast = latestWeather.days[i];
-        forecast.timestamp = 0;
-        forecast.minTemperature = NAN;
-        forecast.maxTemperature = NAN;
-        forecast.summary.clear();
+    case Gesture::LongPress: return mode == UI_MODE_DIAGNOSTICS ? 0 : UI_MODE_DIAGNOSTICS;
+    case Gesture::SwipeLeft: return nextUiMode(mode);
+    case Gesture::SwipeRight: return previousUiMode(mode);
+    case Gesture::Tap:
+        break;
+    }
+    const int day = mode == 0 ? dashboardCardAt(event.x, event.y) : -1;
+    return day >= 0 ? static_cast<uint8_t>(day + 1) : nextUiMode(mode);
+}
 
-        if (!aggregates[i].hasData)
-        {
-            continue;
-        }
+bool showUiMode(uint8_t mode)
+{
+    uiMode = mode;
+    // Force a full refresh on the next render to avoid any ghosting between screen modes
+    pendingFullRefresh = true;
+    return refreshDisplayForUiChange();
+}
 
-        if (aggregates[i].minTemperature != std::numeric_limits<float>::infinity())
+// Applies every queued gesture, then renders once. Gestures that piled up
+// during a fetch or an EPD refresh collapse into a single view change.
+void handleTouchEvents()
+{
+    static constexpr const char *GESTURE_NAMES[] = {"Tap", "Long press", "Swipe left", "Swipe right"};
+    uint8_t mode = uiMode;
+    uint8_t location = activeLocation;
+    size_t count = 0;
+    uint32_t firstAtMs = 0;
+    TouchEvent event;
+    while (touchInput.poll(event))
+    {
+        if (event.gesture == Gesture::Tap && locationTitleAt(mode, event.x, event.y))
         {
-            forecast.minTemperature = aggregates[i].minTemperature;
+            location = (location + 1) % CFG_LOCATION_COUNT;
         }
-        if (aggregates[i].maxTemperature != -std::numeric_limits<float>::infinity())
+        else
         {
-            forecast.maxTemperature = aggregates[i].maxTemperature;
+            mode = uiModeAfterGesture(event, mode);
         }
-        forecast.summary = aggregates[i].description;
-        forecast.timestamp = aggregates[i].localTimestamp;
-        forecast.iconId = aggregates[i].iconId;
-        forecast.iconCode = aggregates[i].iconCode;
+        firstAtMs = count == 0 ? event.atMs : firstAtMs;
+        ++count;
+        Serial.printf("[Touch] %s @(%u,%u). Mode -> %u, location %u\n", GESTURE_NAMES[static_cast<size_t>(event.gesture)],
+                      (unsigned)event.x, (unsigned)event.y, (unsigned)mode, (unsigned)location);
     }
-
-    // Cache OWM icons for current and upcoming days while Wi‑Fi is up
-    ensureIconCached(latestWeather.currentIconCode);
-    for (int i = 0; i < 3; ++i)
+    if (count == 0)
+    {
+        return;
+    }
+    lastTouchTime = millis();
+    if (count > 1)
     {
-        ensureIconCached(latestWeather.days[i].iconCode);
+        Serial.printf("[Touch] %u gestures coalesced into one refresh.\n", (unsigned)count);
+    }
+    const bool locationChanged = location != activeLocation;
+    if (locationChanged)
+    {
+        selectLocation(location);
+    }
+    if (mode != uiMode || locationChanged)
+    {
+        const bool prerendered = showUiMode(mode);
+        // Until the refresh is issued; the waveform itself runs on in the panel.
+        Serial.printf("[Touch] Gesture to refresh: %lu ms (%s).\n", (unsigned long)(millis() - firstAtMs),
+                      prerendered ? "pre-rendered" : "rendered on demand");
     }
-
-    Serial.println("[Weather] Weather data parsed successfully.");
-    return true;
 }
 
-void updateWeatherAndDisplay()
+void saveRetainedState()
 {
-    Serial.println("[Update] Starting weather refresh cycle...");
+    retained.magic = RETAINED_STATE_MAGIC;
+    retained.weather = latestWeather;
+    retained.activeLocation = activeLocation;
+    retained.uiMode = uiMode;
+    std::copy(std::begin(lastWeatherEpoch), std::end(lastWeatherEpoch), retained.lastWeatherEpoch);
+    retained.lastIndoorEpoch = lastIndoorEpoch;
+    retained.panelShowsUi = panelShowsUi;
+    retained.shownUiMode = shownUiMode;
+    retained.shownInputs = shownInputs;
+    retained.dutyWindowStart = dutyWindowStart;
+    retained.dutyAwakeMs = dutyAwakeMs;
+    retained.oneCallRejected = oneCallRejected;
+    retained.fetchScheduler = fetchScheduler;
+    retained.batteryModel = batteryModel;
+}
 
-    const bool wifiConnected = connectToWifi();
-    if (!wifiConnected)
+bool restoreRetainedState()
+{
+    if (retained.magic != RETAINED_STATE_MAGIC)
     {
-        Serial.println("[Update] WiFi connection failed.");
-        renderStatusMessage("WiFi connection failed");
-        powerDownWifi();
-        return;
+        return false;
     }
+    latestWeather = retained.weather;
+    activeLocation = retained.activeLocation;
+    uiMode = retained.uiMode;
+    std::copy(std::begin(retained.lastWeatherEpoch), std::end(retained.lastWeatherEpoch), lastWeatherEpoch);
+    lastIndoorEpoch = retained.lastIndoorEpoch;
+    panelShowsUi = retained.panelShowsUi;
+    shownUiMode = retained.shownUiMode;
+    shownInputs = retained.shownInputs;
+    dutyWindowStart = retained.dutyWindowStart;
+    dutyAwakeMs = retained.dutyAwakeMs;
+    oneCallRejected = retained.oneCallRejected;
+    fetchScheduler = retained.fetchScheduler;
+    batteryModel = retained.batteryModel;
+    return true;
+}
 
-    Serial.println("[Update] WiFi connected; fetching weather.");
-    if (!fetchWeather())
+// The PSRAM frame copy does not survive deep sleep. Recompose the frame the
+// panel still shows so the next update can stay a partial refresh.
+void recomposeShownFrame()
+{
+    if (!canvasReady || !panelShowsUi)
     {
-        Serial.println("[Update] Weather download or parse failed.");
-        const String message = lastErrorMessage.length() > 0 ? lastErrorMessage : String("Weather update failed");
-        renderStatusMessage(message);
-        powerDownWifi();
         return;
     }
-
-    float indoorTemp = NAN;
-    float indoorHumidity = NAN;
-    const bool indoorValid = readIndoorClimate(indoorTemp, indoorHumidity);
-
-    Serial.println("[Update] Rendering display.");
-    renderUi(indoorTemp, indoorHumidity, indoorValid);
-    lastWeatherUpdate = millis();
-    // Keep indoor timer aligned so we don't immediately trigger an indoor-only refresh.
-    lastIndoorUpdate = lastWeatherUpdate;
-    Serial.println("[Update] Update cycle complete.");
-    powerDownWifi();
+    composeUi(shownUiMode, shownInputs);
+    rememberPushedFrame();
 }
 
-// Read only the indoor sensor and refresh the display without using WiFi.
-void updateIndoorAndDisplay()
+// Adds the time awake since the last wake to the hourly budget and logs the
+// duty cycle once per hour; awake share is what separates the sleep modes.
+void accountAwakeTime()
 {
-    Serial.println("[Indoor] Starting indoor-only refresh cycle...");
+    const uint32_t nowMs = millis();
+    dutyAwakeMs += nowMs - awakeSinceMs;
+    awakeSinceMs = nowMs;
 
-    float indoorTemp = NAN;
-    float indoorHumidity = NAN;
-    const bool indoorValid = readIndoorClimate(indoorTemp, indoorHumidity);
+    const time_t now = currentEpoch();
+    if (dutyWindowStart == 0 || now < dutyWindowStart)
+    {
+        dutyWindowStart = now;
+        return;
+    }
+    const time_t window = now - dutyWindowStart;
+    if (window >= 3600)
+    {
+        Serial.printf("[Power] Last %ld s: awake %lu ms (%.2f%% duty)\n", (long)window, (unsigned long)dutyAwakeMs,
+                      dutyAwakeMs / (window * 10.0));
+        dutyWindowStart = now;
+        dutyAwakeMs = 0;
+    }
+}
 
-    Serial.println("[Indoor] Rendering display with latest weather snapshot.");
-    renderUi(indoorTemp, indoorHumidity, indoorValid);
-    lastIndoorUpdate = millis();
-    Serial.println("[Indoor] Indoor-only update complete.");
+// Sleeps until the next indoor/weather deadline or a touch, whichever comes first.
+// Deep sleep does not return: the device reboots into setup() on wake.
+void sleepUntilNextEvent()
+{
+    const time_t now = currentEpoch();
+    const time_t deadline = nextScheduledEpoch();
+    if (deadline <= now)
+    {
+        return;
+    }
+    const time_t sleepSeconds = deadline - now;
+    accountAwakeTime();
+    esp_sleep_enable_timer_wakeup(static_cast<uint64_t>(sleepSeconds) * 1000000ULL);
+
+    if (CFG_SLEEP_MODE == SleepMode::Deep)
+    {
+        Serial.printf("[Power] Deep sleep for %ld s (touch wakes).\n", (long)sleepSeconds);
+        // Unlogged climate samples are already mirrored in RTC memory.
+        saveRetainedState();
+        esp_sleep_enable_ext0_wakeup(TOUCH_INT_PIN, 0);
+        // Keep the battery power latch engaged while the digital pads are unpowered.
+        gpio_hold_en(MAIN_POWER_PIN);
+        gpio_deep_sleep_hold_en();
+        M5.disableEPDPower();
+        Serial.flush();
+        esp_deep_sleep_start();
+    }
+
+    Serial.printf("[Power] Light sleep for up to %ld s.\n", (long)sleepSeconds);
+    gpio_wakeup_enable(TOUCH_INT_PIN, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+    Serial.flush();
+    esp_light_sleep_start();
+    gpio_wakeup_disable(TOUCH_INT_PIN);
+    awakeSinceMs = millis();
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO)
+    {
+        Serial.println("[Power] Woken by touch.");
+        // Hold off the next sleep so the tap (and any follow-up) is handled.
+        lastTouchTime = millis();
+    }
+    touchInput.resume();
 }
 } // namespace
 
@@ -1253,11 +3473,22 @@ void setup()
     Serial.println("[Setup] Booting Home Weather Dashboard");
 
     M5.begin();
+    // Re-latched by M5.begin(); release the hold taken before deep sleep.
+    gpio_hold_dis(MAIN_POWER_PIN);
     M5.EPD.SetRotation(DISPLAY_ROTATION);
     M5.TP.SetRotation(DISPLAY_ROTATION);
+    touchInput.begin(TOUCH_INT_PIN);
+    // TLS handshakes and JSON filters need more stack than the loop task has.
+    netWorker.begin(runFetchJob, "net", NET_TASK_STACK_BYTES, NET_TASK_CORE);
     M5.RTC.begin();
 
-    M5.EPD.Clear(true);
+    const esp_sleep_wakeup_cause_t wakeCause = esp_sleep_get_wakeup_cause();
+    const bool resumed = (wakeCause == ESP_SLEEP_WAKEUP_TIMER || wakeCause == ESP_SLEEP_WAKEUP_EXT0) &&
+                         restoreRetainedState();
+    if (!resumed)
+    {
+        loadClockFromRtc();
+    }
 
     initIndoorSensor();
 
@@ -1268,9 +3499,8 @@ void setup()
     }
     else
     {
-        canvas.setTextColor(COLOR_BLACK);
-        canvas.setTextDatum(TL_DATUM);
-        renderStatusMessage("Booting...");
+        textRenderer.setTextColor(COLOR_BLACK);
+        textRenderer.setTextDatum(TL_DATUM);
     }
 
     // Attempt to load a smoother TTF/OTF font from SD card.
@@ -1278,51 +3508,122 @@ void setup()
 
     // Load runtime configuration from SD (overrides defaults if present)
     loadConfigFromSD();
+    if (activeLocation >= CFG_LOCATION_COUNT)
+    {
+        // The locations list shrank while asleep.
+        selectLocation(0);
+    }
+    batteryModel.configure(CFG_TARGET_RUNTIME_DAYS, CFG_LOW_BATTERY_PERCENT);
+    initClimateHistory();
 
-    updateWeatherAndDisplay();
-}
-
-void loop()
-{
-    const uint32_t now = millis();
+    // On a cold boot, show the cached snapshot straight away; its first push
+    // is a full GC16 refresh, so the usual EPD clear is skipped.
+    const bool haveSnapshot = !resumed && restoreSnapshot();
+    if (!resumed && !haveSnapshot)
+    {
+        M5.EPD.Clear(true);
+        renderStatusMessage("Booting...");
+    }
 
-    if ((now - lastWeatherUpdate) > CFG_WEATHER_UPDATE_INTERVAL)
+    if (resumed)
     {
-        updateWeatherAndDisplay();
+        Serial.printf("[Setup] Resumed from deep sleep (%s).\n", wakeCause == ESP_SLEEP_WAKEUP_EXT0 ? "touch" : "timer");
+        recomposeShownFrame();
+        if (wakeCause == ESP_SLEEP_WAKEUP_EXT0)
+        {
+            // The tap that woke us is long over by now; act on it directly.
+            lastTouchTime = millis();
+            showUiMode(nextUiMode(uiMode));
+        }
+        return;
     }
-    else if ((now - lastIndoorUpdate) > CFG_INDOOR_UPDATE_INTERVAL)
+
+    // Same baseline as the old millis()-based timers: due intervals count from boot.
+    const time_t now = currentEpoch();
+    lastIndoorEpoch = now;
+    dutyWindowStart = now;
+    // A location with a fresh cache carries on the schedule from when it was
+    // fetched; any other is due straight away.
+    const bool clockValid = now >= MIN_VALID_EPOCH;
+    for (size_t i = 0; i < MAX_LOCATIONS; ++i)
     {
-        updateIndoorAndDisplay();
+        WeatherSnapshot cached;
+        const bool found = i == activeLocation ? haveSnapshot : i < CFG_LOCATION_COUNT && loadLocationSnapshot(i, cached);
+        const time_t fetchedAt = i == activeLocation ? latestWeather.fetchedAt : cached.fetchedAt;
+        const time_t age = now - fetchedAt;
+        const bool fresh = found && clockValid && age >= 0 && age < static_cast<time_t>(locationUpdateInterval(i) / 1000UL);
+        lastWeatherEpoch[i] = fresh ? fetchedAt : 0;
     }
 
-    // Touch handling: use GT911 API (available->update->getFingerNum/readFinger(0))
-    M5.update();
-    bool touching = false;
-    tp_finger_t finger = {0, 0, 0, 0};
-    if (M5.TP.available())
+    if (haveSnapshot)
+    {
+        renderUi(captureDisplayInputs());
+        if (lastWeatherEpoch[activeLocation] != 0)
+        {
+            Serial.printf("[Setup] Snapshot is %ld s old; skipping the boot-time fetch.\n",
+                          (long)(now - latestWeather.fetchedAt));
+            return;
+        }
+    }
+    readBatteryLevel();
+    if (batteryModel.lowBattery())
     {
-        M5.TP.update();
-        const uint8_t n = M5.TP.getFingerNum();
-        touching = (n > 0);
-        if (n > 0)
+        Serial.println("[Setup] Battery low; skipping the boot-time fetch.");
+        if (!haveSnapshot)
         {
-            finger = M5.TP.readFinger(0);
+            renderUi(captureDisplayInputs());
         }
+        return;
     }
+    startWeatherUpdate();
+}
+
+void loop()
+{
+    const time_t nowEpoch = currentEpoch();
 
-    if (touching && !wasTouching && (now - lastTouchTime) > 400UL)
+    // Indoor updates wait while a fetch is out; its cycle owns the perf log.
+    if (!netWorker.busy())
     {
-        lastTouchTime = now;
-        // Cycle UI mode: 0 -> 1 -> 2 -> 3 -> 0
-        uiMode = (uiMode + 1) % 4;
-        Serial.printf("[Touch] Tap @(%d,%d). Mode -> %u\n", (int)finger.x, (int)finger.y, uiMode);
-        // Force a full refresh on the next render to avoid any ghosting between screen modes
-        pendingFullRefresh = true;
-        refreshDisplayForUiChange();
+        if (weatherDue(nowEpoch))
+        {
+            startWeatherUpdate();
+        }
+        else if (indoorDue(nowEpoch))
+        {
+            updateIndoorAndDisplay();
+        }
+    }
+    // Without a network task the fetch has already finished by now.
+    if (netWorker.takeResult())
+    {
+        finishWeatherUpdate();
     }
 
-    wasTouching = touching;
-    delay(50);
+    handleTouchEvents();
+
+    const bool fetching = netWorker.busy();
+    const uint32_t idleMs = millis() - std::max(lastTouchTime, touchInput.lastActivityMs());
+    if (CFG_SLEEP_MODE != SleepMode::None && !fetching && !touchInput.fingerDown() && idleMs > TOUCH_IDLE_BEFORE_SLEEP_MS)
+    {
+        sleepUntilNextEvent();
+        return;
+    }
+    // Idle while awake: use the time to get the other views ready for a tap.
+    if (!touchInput.fingerDown() && prerenderNextView())
+    {
+        return;
+    }
+    // Nothing to poll: block until a gesture arrives, re-checking the schedule
+    // every second, or the network task every FETCH_POLL_MS while it works.
+    uint32_t waitMs = CFG_SLEEP_MODE == SleepMode::None || idleMs > TOUCH_IDLE_BEFORE_SLEEP_MS
+                          ? 1000
+                          : std::min<uint32_t>(TOUCH_IDLE_BEFORE_SLEEP_MS - idleMs + 1, 1000);
+    if (fetching)
+    {
+        waitMs = std::min(waitMs, FETCH_POLL_MS);
+    }
+    touchInput.waitForEvent(waitMs);
 }
 int mapLegacySizeToPx(int legacy)
 {
@@ -1337,16 +3638,37 @@ int mapLegacySizeToPx(int legacy)
     }
 }
 
+uint8_t resolveTextSize(int size)
+{
+    return static_cast<uint8_t>(fontReady ? mapLegacySizeToPx(size) : size);
+}
+
 void setTextSizeCompat(int size)
 {
-    if (fontReady)
-    {
-        canvas.setTextSize(mapLegacySizeToPx(size));
-    }
-    else
+    textRenderer.setTextSize(resolveTextSize(size));
+}
+
+// Loads the TrueType font into the canvas' FreeType renderer.
+bool loadCanvasFont()
+{
+    Serial.printf("[Font] Looking for font: %s\n", FONT_PATH_REGULAR);
+    if (!SD.exists(FONT_PATH_REGULAR))
     {
-        canvas.setTextSize(size);
+        Serial.println("[Font] Font file not found on SD; using default font.");
+        return false;
     }
+
+    // M5EPD supports loading TrueType/OpenType fonts from FS.
+    // This renders much smoother than the scaled bitmap font.
+    canvas.loadFont(FONT_PATH_REGULAR, SD);
+    // Pre-create renderers for the sizes we use.
+    // The cache size (256) balances memory and speed for repeated glyphs.
+    canvas.createRender(mapLegacySizeToPx(2), 256);
+    canvas.createRender(mapLegacySizeToPx(3), 256);
+    canvas.createRender(mapLegacySizeToPx(4), 256);
+    canvas.createRender(mapLegacySizeToPx(8), 256);
+    Serial.println("[Font] Smooth font loaded successfully.");
+    return true;
 }
 
 void tryLoadSmoothFont()
@@ -1364,22 +3686,19 @@ void tryLoadSmoothFont()
     }
     sdReady = true;
 
-    Serial.printf("[Font] Looking for font: %s\n", FONT_PATH_REGULAR);
-    if (!SD.exists(FONT_PATH_REGULAR))
+    // A baked atlas needs no rasterising at all; FreeType is then only loaded
+    // if some string needs a character the atlas does not have.
+    if (glyphAtlas.begin(SD, FONT_ATLAS_PATH))
+    {
+        textRenderer.useAtlas(&glyphAtlas);
+        textRenderer.setCanvasFontLoader(loadCanvasFont);
+    }
+    else if (!loadCanvasFont())
     {
-        Serial.println("[Font] Font file not found on SD; using default font.");
         return;
     }
-
-    // M5EPD supports loading TrueType/OpenType fonts from FS.
-    // This renders much smoother than the scaled bitmap font.
-    canvas.loadFont(FONT_PATH_REGULAR, SD);
-    // Pre-create renderers for the sizes we use.
-    // The cache size (256) balances memory and speed for repeated glyphs.
-    canvas.createRender(mapLegacySizeToPx(2), 256);
-    canvas.createRender(mapLegacySizeToPx(3), 256);
-    canvas.createRender(mapLegacySizeToPx(4), 256);
-    canvas.createRender(mapLegacySizeToPx(8), 256);
     fontReady = true;
-    Serial.println("[Font] Smooth font loaded successfully.");
+    textLayout.reset();
+    chromeLayers.invalidate();
+    viewFrames.invalidate();
 }
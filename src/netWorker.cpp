@@ -0,0 +1,51 @@
+#include "netWorker.h"
+
+bool NetWorker::begin(void (*job)(), const char *name, uint32_t stackBytes, BaseType_t core)
+{
+    this->job = job;
+    if (xTaskCreatePinnedToCore(taskMain, name, stackBytes, this, 1, &task, core) != pdPASS)
+    {
+        task = nullptr;
+        Serial.printf("[Net] Could not start the %s task; jobs run inline.\n", name);
+        return false;
+    }
+    return true;
+}
+
+bool NetWorker::start()
+{
+    if (job == nullptr || busy())
+    {
+        return false;
+    }
+    state.store(State::Running, std::memory_order_release);
+    if (task == nullptr)
+    {
+        job();
+        state.store(State::Finished, std::memory_order_release);
+        return true;
+    }
+    xTaskNotifyGive(task);
+    return true;
+}
+
+bool NetWorker::takeResult()
+{
+    if (state.load(std::memory_order_acquire) != State::Finished)
+    {
+        return false;
+    }
+    state.store(State::Idle, std::memory_order_release);
+    return true;
+}
+
+void NetWorker::taskMain(void *arg)
+{
+    NetWorker &worker = *static_cast<NetWorker *>(arg);
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        worker.job();
+        worker.state.store(State::Finished, std::memory_order_release);
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Runs one job at a time on a FreeRTOS task of its own, so a slow network
+// never stalls the loop. The job's inputs and results live wherever the
+// caller keeps them; `state` hands that storage back and forth, which makes
+// it a single-slot single-producer/single-consumer mailbox:
+//
+//   Idle     -> start()        caller filled the inputs; the task owns them now
+//   Running  -> job returns    task published the results (release store)
+//   Finished -> takeResult()   caller owns the storage again (acquire load)
+//
+// Neither side ever waits for the other. Without a task (the native build has
+// no scheduler, or it could not be created) start() runs the job inline.
+class NetWorker
+{
+public:
+    enum class State : uint8_t
+    {
+        Idle,
+        Running,
+        Finished,
+    };
+
+    bool begin(void (*job)(), const char *name, uint32_t stackBytes, BaseType_t core);
+    // False if a job is still running or its result has not been taken.
+    bool start();
+    // True once per finished job.
+    bool takeResult();
+    bool busy() const { return state.load(std::memory_order_acquire) != State::Idle; }
+
+private:
+    static void taskMain(void *arg);
+
+    void (*job)(){nullptr};
+    TaskHandle_t task{nullptr};
+    std::atomic<State> state{State::Idle};
+};
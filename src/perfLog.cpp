@@ -0,0 +1,224 @@
+#include "perfLog.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+constexpr const char *PHASE_NAMES[PerfLog::PHASE_COUNT] = {
+    "wifi", "dns", "connect", "http", "parse", "aggregate", "icons", "render", "push",
+};
+// epoch, cycle, ok, the phases, total, battery before and after.
+constexpr size_t CSV_COLUMNS = 3 + PerfLog::PHASE_COUNT + 3;
+constexpr size_t MAX_LINE = 256;
+
+struct Row
+{
+    uint32_t phaseUs[PerfLog::PHASE_COUNT];
+    uint32_t totalUs;
+    int32_t batteryDropMv;
+};
+
+uint32_t msFieldToUs(const char *field)
+{
+    return static_cast<uint32_t>(std::max(0.0, strtod(field, nullptr) * 1000.0 + 0.5));
+}
+
+// Nearest-rank percentile; sorts `values` in place.
+template <typename T>
+T percentile(T *values, size_t count, unsigned percent)
+{
+    std::sort(values, values + count);
+    const size_t rank = (count * percent + 99) / 100;
+    return values[rank > 0 ? rank - 1 : 0];
+}
+
+bool readLine(File &f, char *line, size_t size)
+{
+    size_t length = 0;
+    int c;
+    while ((c = f.read()) >= 0 && c != '\n')
+    {
+        if (length + 1 < size && c != '\r')
+        {
+            line[length++] = static_cast<char>(c);
+        }
+    }
+    line[length] = '\0';
+    return c >= 0 || length > 0;
+}
+} // namespace
+
+const char *PerfLog::phaseName(PerfPhase phase)
+{
+    return PHASE_NAMES[static_cast<size_t>(phase)];
+}
+
+void PerfLog::beginCycle(const char *kind, uint32_t batteryMv)
+{
+    this->kind = kind;
+    startedAt = esp_timer_get_time();
+    batteryBeforeMv = batteryMv;
+    std::fill(phaseUs, phaseUs + PHASE_COUNT, 0);
+}
+
+void PerfLog::add(PerfPhase phase, int64_t micros)
+{
+    if (kind == nullptr || phase == PerfPhase::Count || micros < 0)
+    {
+        return;
+    }
+    phaseUs[static_cast<size_t>(phase)] += static_cast<uint32_t>(micros);
+}
+
+void PerfLog::merge(const PerfLog &other)
+{
+    for (size_t i = 0; i < PHASE_COUNT; ++i)
+    {
+        add(static_cast<PerfPhase>(i), other.phaseUs[i]);
+    }
+}
+
+bool PerfLog::endCycle(fs::FS &fs, const char *path, size_t maxBytes, time_t epoch, bool ok, uint32_t batteryMv)
+{
+    if (kind == nullptr)
+    {
+        return false;
+    }
+    const uint32_t totalUs = static_cast<uint32_t>(esp_timer_get_time() - startedAt);
+    char row[MAX_LINE];
+    int length = snprintf(row, sizeof(row), "%ld,%s,%d", (long)epoch, kind, ok ? 1 : 0);
+    for (size_t i = 0; i < PHASE_COUNT; ++i)
+    {
+        length += snprintf(row + length, sizeof(row) - length, ",%.1f", phaseUs[i] / 1000.0);
+    }
+    snprintf(row + length, sizeof(row) - length, ",%.1f,%lu,%lu\n", totalUs / 1000.0,
+             (unsigned long)batteryBeforeMv, (unsigned long)batteryMv);
+    const auto ms = [this](PerfPhase phase) { return (unsigned long)(phaseUs[static_cast<size_t>(phase)] / 1000); };
+    Serial.printf("[Perf] %s cycle %lu ms: wifi %lu, net %lu, parse %lu, render %lu, push %lu; battery %lu -> %lu mV\n",
+                  kind, (unsigned long)(totalUs / 1000), ms(PerfPhase::Wifi),
+                  ms(PerfPhase::Dns) + ms(PerfPhase::Connect) + ms(PerfPhase::Http), ms(PerfPhase::Parse),
+                  ms(PerfPhase::Render), ms(PerfPhase::Push), (unsigned long)batteryBeforeMv, (unsigned long)batteryMv);
+    kind = nullptr;
+
+    bool exists = fs.exists(path);
+    if (exists)
+    {
+        File existing = fs.open(path, FILE_READ);
+        const size_t bytes = existing ? existing.size() : 0;
+        if (existing)
+        {
+            existing.close();
+        }
+        if (bytes > maxBytes)
+        {
+            const String rotated = String(path) + ".1";
+            fs.remove(rotated);
+            exists = !fs.rename(path, rotated.c_str());
+        }
+    }
+    File f = fs.open(path, FILE_APPEND);
+    if (!f)
+    {
+        Serial.printf("[Perf] Failed to open %s for appending\n", path);
+        return false;
+    }
+    if (!exists)
+    {
+        f.print("epoch,cycle,ok");
+        for (const char *name : PHASE_NAMES)
+        {
+            f.printf(",%s_ms", name);
+        }
+        f.print(",total_ms,battery_before_mv,battery_after_mv\n");
+    }
+    const size_t rowLength = strlen(row);
+    const bool written = f.write(reinterpret_cast<const uint8_t *>(row), rowLength) == rowLength;
+    f.close();
+    return written;
+}
+
+bool summarizePerfLog(fs::FS &fs, const char *path, const char *kind, PerfSummary &summary)
+{
+    summary = PerfSummary();
+    if (!fs.exists(path))
+    {
+        return false;
+    }
+    File f = fs.open(path, FILE_READ);
+    if (!f)
+    {
+        return false;
+    }
+    Row *rows = static_cast<Row *>(ps_malloc(PerfSummary::WINDOW * sizeof(Row)));
+    if (rows == nullptr)
+    {
+        f.close();
+        return false;
+    }
+
+    // Keep the last WINDOW matching rows in a ring.
+    size_t seen = 0;
+    char line[MAX_LINE];
+    const char *fields[CSV_COLUMNS];
+    while (readLine(f, line, sizeof(line)))
+    {
+        size_t count = 0;
+        for (char *p = line; p != nullptr && count < CSV_COLUMNS; ++count)
+        {
+            fields[count] = p;
+            p = strchr(p, ',');
+            if (p != nullptr)
+            {
+                *p++ = '\0';
+            }
+        }
+        if (count != CSV_COLUMNS || strcmp(fields[1], kind) != 0 || strcmp(fields[2], "1") != 0)
+        {
+            continue; // header, another kind or a failed cycle
+        }
+        Row &row = rows[seen++ % PerfSummary::WINDOW];
+        for (size_t i = 0; i < PerfLog::PHASE_COUNT; ++i)
+        {
+            row.phaseUs[i] = msFieldToUs(fields[3 + i]);
+        }
+        row.totalUs = msFieldToUs(fields[3 + PerfLog::PHASE_COUNT]);
+        row.batteryDropMv = atoi(fields[4 + PerfLog::PHASE_COUNT]) - atoi(fields[5 + PerfLog::PHASE_COUNT]);
+    }
+    f.close();
+
+    summary.cycles = std::min(seen, PerfSummary::WINDOW);
+    if (summary.cycles > 0)
+    {
+        uint32_t column[PerfSummary::WINDOW];
+        for (size_t phase = 0; phase <= PerfLog::PHASE_COUNT; ++phase)
+        {
+            for (size_t i = 0; i < summary.cycles; ++i)
+            {
+                column[i] = phase < PerfLog::PHASE_COUNT ? rows[i].phaseUs[phase] : rows[i].totalUs;
+            }
+            const uint32_t p50 = percentile(column, summary.cycles, 50);
+            const uint32_t p95 = percentile(column, summary.cycles, 95);
+            if (phase < PerfLog::PHASE_COUNT)
+            {
+                summary.p50Us[phase] = p50;
+                summary.p95Us[phase] = p95;
+            }
+            else
+            {
+                summary.totalP50Us = p50;
+                summary.totalP95Us = p95;
+            }
+        }
+        int32_t drops[PerfSummary::WINDOW];
+        for (size_t i = 0; i < summary.cycles; ++i)
+        {
+            drops[i] = rows[i].batteryDropMv;
+        }
+        summary.batteryDropP50Mv = percentile(drops, summary.cycles, 50);
+        summary.batteryDropP95Mv = percentile(drops, summary.cycles, 95);
+    }
+    free(rows);
+    return summary.cycles > 0;
+}
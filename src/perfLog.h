@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+#include <esp_timer.h>
+
+// Parts of an update cycle that are timed separately. Network phases add up
+// over every request the cycle makes.
+enum class PerfPhase : uint8_t
+{
+    Wifi,      // association and DHCP
+    Dns,       // host lookups not answered from the RTC cache
+    Connect,   // TCP connect and TLS handshake
+    Http,      // request to first byte, plus draining the unparsed tail
+    Parse,     // deserializeJson; the body is received while it parses
+    Aggregate, // filtered JSON into the weather snapshot
+    Icons,     // icon manifest and downloads
+    Render,    // composing the canvas
+    Push,      // EPD transfer and waveform
+    Count,
+};
+
+// Per-cycle phase times, kept in microseconds from esp_timer and appended to
+// the SD card as one CSV row per cycle together with the battery voltage
+// before and after it. Times reported outside a cycle (a render after a tap)
+// are dropped, so every row describes exactly one scheduled update.
+class PerfLog
+{
+public:
+    static constexpr size_t PHASE_COUNT = static_cast<size_t>(PerfPhase::Count);
+
+    // `kind` names the cycle in the CSV ("weather", "indoor"); it must be a literal.
+    void beginCycle(const char *kind, uint32_t batteryMv);
+    void add(PerfPhase phase, int64_t micros);
+    // Adds the phase times `other` collected, e.g. on the network task.
+    void merge(const PerfLog &other);
+    // Closes the cycle, logs it and appends it to `path`, writing the header
+    // row first if the file is new. A file past `maxBytes` is rotated to
+    // "<path>.1" so the log cannot fill the card.
+    bool endCycle(fs::FS &fs, const char *path, size_t maxBytes, time_t epoch, bool ok, uint32_t batteryMv);
+    bool active() const { return kind != nullptr; }
+
+    static const char *phaseName(PerfPhase phase);
+
+private:
+    const char *kind{nullptr};
+    int64_t startedAt{0};
+    uint32_t batteryBeforeMv{0};
+    uint32_t phaseUs[PHASE_COUNT]{};
+};
+
+// Adds the lifetime of the object to one phase of the current cycle.
+class ScopedPerfTimer
+{
+public:
+    ScopedPerfTimer(PerfLog &log, PerfPhase phase) : log(log), phase(phase), start(esp_timer_get_time()) {}
+    ~ScopedPerfTimer() { log.add(phase, esp_timer_get_time() - start); }
+    ScopedPerfTimer(const ScopedPerfTimer &) = delete;
+    ScopedPerfTimer &operator=(const ScopedPerfTimer &) = delete;
+
+private:
+    PerfLog &log;
+    const PerfPhase phase;
+    const int64_t start;
+};
+
+// Rolling percentiles over the most recent successful cycles of one kind.
+struct PerfSummary
+{
+    static constexpr size_t WINDOW = 48;
+
+    size_t cycles{0};
+    uint32_t p50Us[PerfLog::PHASE_COUNT]{};
+    uint32_t p95Us[PerfLog::PHASE_COUNT]{};
+    uint32_t totalP50Us{0};
+    uint32_t totalP95Us{0};
+    int32_t batteryDropP50Mv{0};
+    int32_t batteryDropP95Mv{0};
+};
+
+// Reads the CSV written by PerfLog (the whole file; the page using it is rare)
+// and fills `summary` from the last PerfSummary::WINDOW rows of `kind`.
+bool summarizePerfLog(fs::FS &fs, const char *path, const char *kind, PerfSummary &summary);
@@ -0,0 +1,111 @@
+#include "snapshotStore.h"
+
+#include <Arduino.h>
+
+namespace
+{
+constexpr uint32_t SNAPSHOT_MAGIC = 0x504E5357; // "WSNP"
+
+struct SnapshotFileHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t payloadSize;
+    uint32_t crc;
+};
+} // namespace
+
+uint32_t crc32Update(uint32_t crc, const uint8_t *data, size_t length)
+{
+    crc = ~crc;
+    for (size_t i = 0; i < length; ++i)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+bool commitSideFile(fs::FS &fs, const String &tempPath, const char *path)
+{
+    fs.remove(path);
+    if (!fs.rename(tempPath, path))
+    {
+        Serial.printf("[SD] Failed to move %s into place\n", tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void recoverSideFile(fs::FS &fs, const char *path)
+{
+    const String tempPath = String(path) + ".tmp";
+    if (!fs.exists(path) && fs.exists(tempPath) && fs.rename(tempPath, path))
+    {
+        Serial.printf("[SD] Restored %s from its side file.\n", path);
+    }
+}
+
+bool saveSnapshot(fs::FS &fs, const char *path, const WeatherSnapshot &snapshot)
+{
+    SnapshotFileHeader header{};
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_FORMAT_VERSION;
+    header.payloadSize = sizeof(WeatherSnapshot);
+    header.crc = crc32Update(0, reinterpret_cast<const uint8_t *>(&snapshot), sizeof(WeatherSnapshot));
+
+    // A brownout mid-write leaves the old snapshot intact; see commitSideFile().
+    const String tempPath = String(path) + ".tmp";
+    File f = fs.open(tempPath, FILE_WRITE);
+    if (!f)
+    {
+        Serial.printf("[Snapshot] Failed to open %s for writing\n", tempPath.c_str());
+        return false;
+    }
+    size_t written = f.write(reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+    written += f.write(reinterpret_cast<const uint8_t *>(&snapshot), sizeof(WeatherSnapshot));
+    f.close();
+    if (written != sizeof(header) + sizeof(WeatherSnapshot))
+    {
+        Serial.printf("[Snapshot] Short write (%u bytes)\n", (unsigned)written);
+        fs.remove(tempPath);
+        return false;
+    }
+    return commitSideFile(fs, tempPath, path);
+}
+
+bool loadSnapshot(fs::FS &fs, const char *path, WeatherSnapshot &snapshot)
+{
+    recoverSideFile(fs, path);
+    if (!fs.exists(path))
+    {
+        return false;
+    }
+    File f = fs.open(path, FILE_READ);
+    if (!f)
+    {
+        return false;
+    }
+    SnapshotFileHeader header{};
+    WeatherSnapshot candidate;
+    const bool complete = f.read(reinterpret_cast<uint8_t *>(&header), sizeof(header)) == sizeof(header) &&
+                          header.magic == SNAPSHOT_MAGIC && header.version == SNAPSHOT_FORMAT_VERSION &&
+                          header.payloadSize == sizeof(WeatherSnapshot) &&
+                          f.read(reinterpret_cast<uint8_t *>(&candidate), sizeof(candidate)) == sizeof(candidate);
+    f.close();
+    if (!complete)
+    {
+        Serial.printf("[Snapshot] %s has an unknown format; ignoring it.\n", path);
+        return false;
+    }
+    if (crc32Update(0, reinterpret_cast<const uint8_t *>(&candidate), sizeof(candidate)) != header.crc)
+    {
+        Serial.printf("[Snapshot] %s failed its checksum; ignoring it.\n", path);
+        return false;
+    }
+    snapshot = candidate;
+    return true;
+}
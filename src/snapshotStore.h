@@ -0,0 +1,27 @@
+#pragma once
+
+#include <FS.h>
+#include "weatherSnapshot.h"
+
+// On-SD cache of the last good WeatherSnapshot, so a reboot can render
+// immediately instead of waiting for Wi-Fi and the API.
+//
+// File layout (little-endian, as written by the ESP32):
+//   uint32 magic 'WSNP' | uint16 version | uint16 payload size | uint32 CRC-32 | payload
+// The payload is the raw WeatherSnapshot. Bump SNAPSHOT_FORMAT_VERSION whenever
+// that struct changes; files with another version or size are ignored.
+constexpr uint16_t SNAPSHOT_FORMAT_VERSION = 4;
+
+bool saveSnapshot(fs::FS &fs, const char *path, const WeatherSnapshot &snapshot);
+bool loadSnapshot(fs::FS &fs, const char *path, WeatherSnapshot &snapshot);
+
+// Side-file swap used by every SD writer: the new contents are written whole
+// to `<path>.tmp`, then the old file is removed and the side file renamed over
+// it. SD (FAT) cannot rename onto an existing file, so the swap is two steps;
+// a brownout between them leaves only the side file, which the loader moves
+// into place with recoverSideFile() before opening `path`.
+bool commitSideFile(fs::FS &fs, const String &tempPath, const char *path);
+void recoverSideFile(fs::FS &fs, const char *path);
+
+// Standard reflected CRC-32 (as used by zip/PNG), seeded with 0 for a new buffer.
+uint32_t crc32Update(uint32_t crc, const uint8_t *data, size_t length);
@@ -0,0 +1,247 @@
+#include "textLayout.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "utf8.h"
+
+namespace
+{
+constexpr char ELLIPSIS[] = "...";
+
+uint32_t fnv1a(const char *text, size_t length)
+{
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash = (hash ^ static_cast<uint8_t>(text[i])) * 16777619UL;
+    }
+    return hash;
+}
+} // namespace
+
+void TextLayoutEngine::reset()
+{
+    tableCount = 0;
+    for (MemoEntry &entry : memo)
+    {
+        entry.fontSize = 0;
+    }
+    memoNext = 0;
+}
+
+TextLayoutEngine::GlyphTable *TextLayoutEngine::tableFor(uint8_t fontSize)
+{
+    for (size_t i = 0; i < tableCount; ++i)
+    {
+        if (tables[i].fontSize == fontSize)
+        {
+            return &tables[i];
+        }
+    }
+    if (tableCount >= MAX_SIZES)
+    {
+        return nullptr;
+    }
+    GlyphTable &table = tables[tableCount++];
+    table.fontSize = fontSize;
+    for (int16_t &advance : table.advance)
+    {
+        advance = -1;
+    }
+    return &table;
+}
+
+int TextLayoutEngine::glyphAdvance(GlyphTable *table, const char *glyph, size_t bytes, uint32_t codepoint)
+{
+    const bool cacheable = table != nullptr && codepoint >= CACHED_FIRST && codepoint <= CACHED_LAST;
+    if (cacheable && table->advance[codepoint - CACHED_FIRST] >= 0)
+    {
+        return table->advance[codepoint - CACHED_FIRST];
+    }
+    char single[5] = {};
+    memcpy(single, glyph, bytes);
+    const int advance = renderer.textWidth(single);
+    if (cacheable)
+    {
+        table->advance[codepoint - CACHED_FIRST] = static_cast<int16_t>(advance);
+    }
+    return advance;
+}
+
+int TextLayoutEngine::measure(const char *text, size_t length)
+{
+    // The whole run goes to the renderer, so kerning between its glyphs counts
+    // the same as when the line is drawn.
+    char run[MEMO_TEXT_LENGTH];
+    if (length < sizeof(run))
+    {
+        memcpy(run, text, length);
+        run[length] = '\0';
+        return renderer.textWidth(run);
+    }
+    String longRun;
+    longRun.concat(text, length);
+    return renderer.textWidth(longRun);
+}
+
+// Longest whole-glyph prefix of `text` that fits in `maxWidth`.
+size_t TextLayoutEngine::fitPrefix(const char *text, size_t length, uint8_t fontSize, int maxWidth)
+{
+    GlyphTable *table = tableFor(fontSize);
+    int width = 0;
+    size_t i = 0;
+    while (i < length)
+    {
+        uint32_t codepoint = 0;
+        const size_t bytes = decodeUtf8(text + i, length - i, codepoint);
+        width += glyphAdvance(table, text + i, bytes, codepoint);
+        if (width > maxWidth)
+        {
+            break;
+        }
+        i += bytes;
+    }
+    // Summed advances leave out kerning; back off whole glyphs until the real width fits.
+    while (i > 0 && measure(text, i) > maxWidth)
+    {
+        do
+        {
+            --i;
+        } while (i > 0 && (static_cast<uint8_t>(text[i]) & 0xC0) == 0x80);
+    }
+    return i;
+}
+
+void TextLayoutEngine::computeLayout(const String &text, uint8_t fontSize, int maxWidth, int maxLines,
+                                     TextLayout &out)
+{
+    out = TextLayout();
+    const char *s = text.c_str();
+    const size_t length = text.length();
+    const int spaceWidth = measure(" ", 1);
+    maxLines = std::max(1, std::min(maxLines, static_cast<int>(TextLayout::MAX_LINES)));
+
+    TextLine current{0, 0};
+    int currentWidth = 0;
+    bool lineOpen = false;
+    size_t index = 0;
+    while (index < length)
+    {
+        while (index < length && s[index] == ' ')
+        {
+            ++index;
+        }
+        if (index >= length)
+        {
+            break;
+        }
+        size_t wordEnd = index;
+        while (wordEnd < length && s[wordEnd] != ' ')
+        {
+            ++wordEnd;
+        }
+        const int wordWidth = measure(s + index, wordEnd - index);
+
+        if (!lineOpen)
+        {
+            // A word wider than the box still gets a line of its own.
+            current = TextLine{static_cast<uint16_t>(index), static_cast<uint16_t>(wordEnd - index)};
+            currentWidth = wordWidth;
+            lineOpen = true;
+        }
+        else if (currentWidth + spaceWidth + wordWidth <= maxWidth)
+        {
+            current.length = static_cast<uint16_t>(wordEnd - current.start);
+            currentWidth += spaceWidth + wordWidth;
+        }
+        else
+        {
+            if (out.lineCount + 1 >= maxLines)
+            {
+                out.truncated = true;
+                break;
+            }
+            out.lines[out.lineCount++] = current;
+            current = TextLine{static_cast<uint16_t>(index), static_cast<uint16_t>(wordEnd - index)};
+            currentWidth = wordWidth;
+        }
+        index = wordEnd;
+    }
+    if (!lineOpen)
+    {
+        return;
+    }
+
+    if (out.truncated)
+    {
+        // Drop trailing words until the ellipsis fits; cut inside the word if only one is left.
+        const int room = maxWidth - measure(ELLIPSIS, sizeof(ELLIPSIS) - 1);
+        while (measure(s + current.start, current.length) > room)
+        {
+            size_t lastSpace = current.length;
+            while (lastSpace > 0 && s[current.start + lastSpace - 1] != ' ')
+            {
+                --lastSpace;
+            }
+            if (lastSpace == 0)
+            {
+                current.length = static_cast<uint16_t>(fitPrefix(s + current.start, current.length, fontSize, room));
+                break;
+            }
+            current.length = static_cast<uint16_t>(lastSpace);
+            while (current.length > 0 && s[current.start + current.length - 1] == ' ')
+            {
+                --current.length;
+            }
+        }
+    }
+    out.lines[out.lineCount++] = current;
+}
+
+TextLayout TextLayoutEngine::layout(const String &text, uint8_t fontSize, int maxWidth, int maxLines)
+{
+    const size_t length = text.length();
+    const bool memoizable = length < MEMO_TEXT_LENGTH;
+    const uint32_t hash = fnv1a(text.c_str(), length);
+    if (memoizable)
+    {
+        for (const MemoEntry &entry : memo)
+        {
+            if (entry.fontSize == fontSize && entry.hash == hash && entry.maxWidth == maxWidth &&
+                entry.maxLines == maxLines && strcmp(entry.text, text.c_str()) == 0)
+            {
+                return entry.layout;
+            }
+        }
+    }
+
+    TextLayout result;
+    computeLayout(text, fontSize, maxWidth, maxLines, result);
+    if (memoizable)
+    {
+        MemoEntry &entry = memo[memoNext];
+        memoNext = (memoNext + 1) % MEMO_ENTRIES;
+        entry.hash = hash;
+        entry.fontSize = fontSize;
+        entry.maxWidth = static_cast<int16_t>(maxWidth);
+        entry.maxLines = static_cast<uint8_t>(maxLines);
+        memcpy(entry.text, text.c_str(), length + 1);
+        entry.layout = result;
+    }
+    return result;
+}
+
+void TextLayoutEngine::draw(const String &text, const TextLayout &layout, int x, int y, int lineHeight)
+{
+    for (uint8_t i = 0; i < layout.lineCount; ++i)
+    {
+        const TextLine &line = layout.lines[i];
+        String lineText = text.substring(line.start, line.start + line.length);
+        if (layout.truncated && i + 1 == layout.lineCount)
+        {
+            lineText += ELLIPSIS;
+        }
+        renderer.drawString(lineText, x, y + i * lineHeight);
+    }
+}
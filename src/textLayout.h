@@ -0,0 +1,77 @@
+#pragma once
+
+#include "textRenderer.h"
+
+// One wrapped line: a byte range of the source text.
+struct TextLine
+{
+    uint16_t start;
+    uint16_t length;
+};
+
+struct TextLayout
+{
+    static constexpr size_t MAX_LINES = 8;
+
+    TextLine lines[MAX_LINES];
+    uint8_t lineCount{0};
+    // The text did not fit in the allowed lines; the last line is cut and gets an ellipsis.
+    bool truncated{false};
+};
+
+// Greedy word wrap for canvas text. Each word is measured once with the
+// renderer, kerning included, instead of a textWidth() of the whole candidate
+// line per word. Finished layouts are memoized per (text, size, width, line
+// limit), so redrawing the same summaries on the next render does no
+// measuring at all.
+class TextLayoutEngine
+{
+public:
+    explicit TextLayoutEngine(TextRenderer &renderer) : renderer(renderer) {}
+
+    // `fontSize` must be the size currently set on the renderer.
+    TextLayout layout(const String &text, uint8_t fontSize, int maxWidth, int maxLines);
+    // Draws each line with the renderer's current datum, `lineHeight` apart.
+    void draw(const String &text, const TextLayout &layout, int x, int y, int lineHeight);
+    // Width of `length` bytes of UTF-8 at the renderer's current size, as drawn.
+    int measure(const char *text, size_t length);
+    // Forgets all measurements; call after the font changes.
+    void reset();
+
+private:
+    static constexpr uint32_t CACHED_FIRST = 0x20;
+    static constexpr uint32_t CACHED_LAST = 0xFF; // ASCII and Latin-1
+    static constexpr size_t CACHED_GLYPHS = CACHED_LAST - CACHED_FIRST + 1;
+    static constexpr size_t MAX_SIZES = 6;
+    static constexpr size_t MEMO_ENTRIES = 8;
+    static constexpr size_t MEMO_TEXT_LENGTH = 96;
+
+    // Single-glyph advances, used only to find where to cut a word that does
+    // not fit on a line by itself.
+    struct GlyphTable
+    {
+        uint8_t fontSize{0};
+        int16_t advance[CACHED_GLYPHS];
+    };
+
+    struct MemoEntry
+    {
+        uint32_t hash{0};
+        uint8_t fontSize{0};
+        int16_t maxWidth{0};
+        uint8_t maxLines{0};
+        char text[MEMO_TEXT_LENGTH];
+        TextLayout layout;
+    };
+
+    GlyphTable *tableFor(uint8_t fontSize);
+    int glyphAdvance(GlyphTable *table, const char *glyph, size_t bytes, uint32_t codepoint);
+    size_t fitPrefix(const char *text, size_t length, uint8_t fontSize, int maxWidth);
+    void computeLayout(const String &text, uint8_t fontSize, int maxWidth, int maxLines, TextLayout &out);
+
+    TextRenderer &renderer;
+    GlyphTable tables[MAX_SIZES];
+    size_t tableCount{0};
+    MemoEntry memo[MEMO_ENTRIES];
+    size_t memoNext{0};
+};
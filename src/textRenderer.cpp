@@ -0,0 +1,77 @@
+#include "textRenderer.h"
+
+void TextRenderer::setTextSize(uint8_t size)
+{
+    this->size = size;
+    canvas.setTextSize(size);
+}
+
+void TextRenderer::setTextDatum(uint8_t datum)
+{
+    this->datum = datum;
+    canvas.setTextDatum(datum);
+}
+
+void TextRenderer::setTextColor(uint8_t color)
+{
+    this->color = color;
+    canvas.setTextColor(color);
+}
+
+bool TextRenderer::useAtlasFor(const char *text)
+{
+    if (atlas == nullptr || !atlas->hasSize(size))
+    {
+        return false;
+    }
+    if (atlas->covers(size, text))
+    {
+        return true;
+    }
+    if (!canvasFontTried)
+    {
+        canvasFontTried = true;
+        canvasFontUsable = canvasFontLoader != nullptr && canvasFontLoader();
+        canvas.setTextSize(size);
+    }
+    return !canvasFontUsable;
+}
+
+int16_t TextRenderer::textWidth(const char *text)
+{
+    return useAtlasFor(text) ? atlas->textWidth(size, text) : canvas.textWidth(text);
+}
+
+int16_t TextRenderer::fontHeight()
+{
+    return atlas != nullptr && atlas->hasSize(size) ? atlas->lineHeight(size) : canvas.fontHeight();
+}
+
+int16_t TextRenderer::drawString(const char *text, int32_t x, int32_t y)
+{
+    if (!useAtlasFor(text))
+    {
+        return canvas.drawString(text, x, y);
+    }
+    // Same datum arithmetic as the canvas: 0..8 are rows of three, 9..11 sit on the baseline.
+    const int16_t width = atlas->textWidth(size, text);
+    const int column = datum % 3;
+    const int row = datum / 3;
+    x -= column == 1 ? width / 2 : column == 2 ? width : 0;
+    int32_t baseline = y + atlas->ascent(size);
+    if (row == 1)
+    {
+        baseline -= atlas->lineHeight(size) / 2;
+    }
+    else if (row == 2)
+    {
+        baseline -= atlas->lineHeight(size);
+    }
+    else if (row == 3)
+    {
+        baseline = y;
+    }
+    atlas->draw(static_cast<uint8_t *>(canvas.frameBuffer()), canvas.width(), canvas.height(), size, text, x, baseline,
+                color);
+    return width;
+}
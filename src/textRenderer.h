@@ -0,0 +1,43 @@
+#pragma once
+
+#include <M5EPD.h>
+
+#include "glyphAtlas.h"
+
+// All text goes through here rather than straight to the canvas. When a baked
+// GlyphAtlas covers the current size and every character of a string, the
+// string is measured and blended from the atlas; anything else falls back to
+// the canvas font. `canvasFontLoader` is called before the first fallback, so
+// FreeType is only loaded on a device that actually meets such a string.
+class TextRenderer
+{
+public:
+    explicit TextRenderer(M5EPD_Canvas &canvas) : canvas(canvas) {}
+
+    void useAtlas(GlyphAtlas *atlas) { this->atlas = atlas; }
+    // Loads the canvas font on demand; returns false if it cannot render the
+    // atlas' pixel sizes, in which case the atlas draws '?' for what it lacks.
+    void setCanvasFontLoader(bool (*loader)()) { canvasFontLoader = loader; }
+
+    void setTextSize(uint8_t size);
+    void setTextDatum(uint8_t datum);
+    void setTextColor(uint8_t color);
+
+    int16_t drawString(const char *text, int32_t x, int32_t y);
+    int16_t drawString(const String &text, int32_t x, int32_t y) { return drawString(text.c_str(), x, y); }
+    int16_t textWidth(const char *text);
+    int16_t textWidth(const String &text) { return textWidth(text.c_str()); }
+    int16_t fontHeight();
+
+private:
+    bool useAtlasFor(const char *text);
+
+    M5EPD_Canvas &canvas;
+    GlyphAtlas *atlas{nullptr};
+    bool (*canvasFontLoader)(){nullptr};
+    bool canvasFontTried{false};
+    bool canvasFontUsable{false};
+    uint8_t size{1};
+    uint8_t datum{TL_DATUM};
+    uint8_t color{15};
+};
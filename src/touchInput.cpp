@@ -0,0 +1,145 @@
+#include "touchInput.h"
+
+#include <M5EPD.h>
+
+namespace
+{
+// Handle the interrupt handler wakes; there is one panel.
+TaskHandle_t readerTask = nullptr;
+
+void IRAM_ATTR onTouchInterrupt()
+{
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(readerTask, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+} // namespace
+
+bool GestureRecognizer::feed(bool touching, uint16_t x, uint16_t y, uint32_t nowMs, TouchEvent &event)
+{
+    if (touching && !down)
+    {
+        down = true;
+        moved = false;
+        longPressFired = false;
+        startX = lastX = x;
+        startY = lastY = y;
+        startMs = nowMs;
+        return false;
+    }
+    if (touching)
+    {
+        lastX = x;
+        lastY = y;
+        if (abs(x - startX) > TAP_SLOP_PX || abs(y - startY) > TAP_SLOP_PX)
+        {
+            moved = true;
+        }
+        if (!moved && !longPressFired && nowMs - startMs >= LONG_PRESS_MS)
+        {
+            longPressFired = true;
+            event = TouchEvent{Gesture::LongPress, startX, startY, nowMs};
+            return true;
+        }
+        return false;
+    }
+    if (!down)
+    {
+        return false;
+    }
+
+    down = false;
+    const uint32_t previousRelease = releasedMs;
+    releasedMs = nowMs;
+    if (longPressFired)
+    {
+        return false;
+    }
+    const int dx = lastX - startX;
+    const int dy = lastY - startY;
+    if (abs(dx) >= SWIPE_MIN_PX && abs(dx) > 2 * abs(dy) && nowMs - startMs <= SWIPE_MAX_MS)
+    {
+        event = TouchEvent{dx < 0 ? Gesture::SwipeLeft : Gesture::SwipeRight, startX, startY, nowMs};
+        return true;
+    }
+    if (!moved && startMs - previousRelease >= DEBOUNCE_MS)
+    {
+        event = TouchEvent{Gesture::Tap, startX, startY, nowMs};
+        return true;
+    }
+    return false;
+}
+
+bool TouchInput::begin(uint8_t intPin)
+{
+    pin = intPin;
+    events = xQueueCreate(QUEUE_LENGTH, sizeof(TouchEvent));
+    if (events == nullptr)
+    {
+        return false;
+    }
+    // Low priority: I2C reads of the panel must never delay the network stack.
+    if (xTaskCreatePinnedToCore(taskMain, "touch", 3072, this, 1, &task, 0) != pdPASS)
+    {
+        Serial.println("[Touch] Could not start the reader task; touch input is off.");
+        task = nullptr;
+        return false;
+    }
+    readerTask = task;
+    attachInterrupt(digitalPinToInterrupt(pin), onTouchInterrupt, FALLING);
+    return true;
+}
+
+void TouchInput::resume()
+{
+    if (task == nullptr)
+    {
+        return;
+    }
+    attachInterrupt(digitalPinToInterrupt(pin), onTouchInterrupt, FALLING);
+    xTaskNotifyGive(task);
+}
+
+bool TouchInput::poll(TouchEvent &event)
+{
+    return events != nullptr && xQueueReceive(events, &event, 0) == pdTRUE;
+}
+
+bool TouchInput::waitForEvent(uint32_t timeoutMs)
+{
+    if (events == nullptr)
+    {
+        delay(timeoutMs);
+        return false;
+    }
+    TouchEvent event;
+    return xQueuePeek(events, &event, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
+
+void TouchInput::taskMain(void *arg)
+{
+    static_cast<TouchInput *>(arg)->run();
+}
+
+void TouchInput::run()
+{
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, down ? pdMS_TO_TICKS(POLL_MS) : portMAX_DELAY);
+
+        M5.TP.update();
+        const bool touching = M5.TP.getFingerNum() > 0;
+        const tp_finger_t finger = touching ? M5.TP.readFinger(0) : tp_finger_t{0, 0, 0, 0};
+        const uint32_t now = millis();
+        if (touching)
+        {
+            activityMs = now;
+        }
+        TouchEvent event;
+        if (recognizer.feed(touching, finger.x, finger.y, now, event) && xQueueSend(events, &event, 0) != pdTRUE)
+        {
+            Serial.println("[Touch] Event queue full; gesture dropped.");
+        }
+        down = recognizer.fingerDown();
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+enum class Gesture : uint8_t
+{
+    Tap,
+    LongPress,  // held still; fires while the finger is still down
+    SwipeLeft,  // finger moved right to left
+    SwipeRight, // finger moved left to right
+};
+
+// Where a gesture started, in canvas coordinates, and millis() when it was recognised.
+struct TouchEvent
+{
+    Gesture gesture;
+    uint16_t x;
+    uint16_t y;
+    uint32_t atMs;
+};
+
+// Turns a stream of panel readings (finger down at x/y, or no finger) into
+// gestures. A touch that moved less than TAP_SLOP_PX is a tap on release, or a
+// long press once held for LONG_PRESS_MS. A quick, mostly horizontal stroke
+// of at least SWIPE_MIN_PX is a swipe. Anything else is ignored.
+class GestureRecognizer
+{
+public:
+    static constexpr uint32_t LONG_PRESS_MS = 1500;
+    static constexpr uint32_t SWIPE_MAX_MS = 800;
+    static constexpr int SWIPE_MIN_PX = 120;
+    static constexpr int TAP_SLOP_PX = 30;
+    // The GT911 can report a short release inside one touch; a tap starting
+    // this soon after the last release is dropped.
+    static constexpr uint32_t DEBOUNCE_MS = 150;
+
+    // Returns true and fills `event` when this reading completes a gesture.
+    bool feed(bool touching, uint16_t x, uint16_t y, uint32_t nowMs, TouchEvent &event);
+    bool fingerDown() const { return down; }
+
+private:
+    bool down{false};
+    bool moved{false};
+    bool longPressFired{false};
+    uint16_t startX{0};
+    uint16_t startY{0};
+    uint16_t lastX{0};
+    uint16_t lastY{0};
+    uint32_t startMs{0};
+    uint32_t releasedMs{0};
+};
+
+// GT911 input driven by its INT line. The interrupt handler only wakes a
+// reader task on core 0, which reads the panel over I2C, runs the gesture
+// recognizer and posts finished gestures to a queue. The loop takes them from
+// there whenever it gets to it, so a touch during a fetch or an EPD refresh is
+// neither lost nor able to hold up the render path.
+//
+// While a finger is down the task also re-reads the panel every POLL_MS, so a
+// long press fires without further interrupts and a missed release is seen.
+// If the task cannot be started (the native build has no scheduler), there
+// are no gestures.
+class TouchInput
+{
+public:
+    static constexpr size_t QUEUE_LENGTH = 8;
+    static constexpr uint32_t POLL_MS = 20;
+
+    // Replaces the flag-only handler M5EPD's GT911::begin attaches to `intPin`.
+    bool begin(uint8_t intPin);
+    // Re-arms the interrupt and reads the panel once. Call after light sleep:
+    // gpio_wakeup_disable() clears the pin's interrupt type, and the touch
+    // that woke the chip has to be read.
+    void resume();
+
+    // Next gesture, without waiting.
+    bool poll(TouchEvent &event);
+    // Waits up to `timeoutMs` for a gesture to be queued; does not take it.
+    bool waitForEvent(uint32_t timeoutMs);
+
+    bool fingerDown() const { return down; }
+    // millis() of the last panel reading with a finger on it.
+    uint32_t lastActivityMs() const { return activityMs; }
+
+private:
+    static void taskMain(void *arg);
+    void run();
+
+    uint8_t pin{0};
+    QueueHandle_t events{nullptr};
+    TaskHandle_t task{nullptr};
+    GestureRecognizer recognizer;
+    volatile bool down{false};
+    volatile uint32_t activityMs{0};
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Decodes the UTF-8 sequence at `text`; returns its byte length (at least 1).
+inline size_t decodeUtf8(const char *text, size_t available, uint32_t &codepoint)
+{
+    const uint8_t lead = static_cast<uint8_t>(text[0]);
+    size_t bytes = 1;
+    if (lead >= 0xF0)
+    {
+        bytes = 4;
+        codepoint = lead & 0x07;
+    }
+    else if (lead >= 0xE0)
+    {
+        bytes = 3;
+        codepoint = lead & 0x0F;
+    }
+    else if (lead >= 0xC0)
+    {
+        bytes = 2;
+        codepoint = lead & 0x1F;
+    }
+    else
+    {
+        codepoint = lead;
+        return 1;
+    }
+    if (bytes > available)
+    {
+        codepoint = lead;
+        return 1;
+    }
+    for (size_t i = 1; i < bytes; ++i)
+    {
+        codepoint = (codepoint << 6) | (static_cast<uint8_t>(text[i]) & 0x3F);
+    }
+    return bytes;
+}
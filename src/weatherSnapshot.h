@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#include "forecastTimeline.h"
+
+// Fixed-size text fields keep the snapshot a plain value type, so it can be
+// copied into RTC memory across deep sleep and written to SD byte for byte.
+constexpr size_t DESCRIPTION_LENGTH = 64;
+constexpr size_t ICON_CODE_LENGTH = 4; // e.g. "10d"
+// Upper bound for the configurable number of forecast days; /forecast covers five.
+constexpr size_t MAX_FORECAST_DAYS = 5;
+
+struct DailyForecast
+{
+    time_t timestamp{};
+    float minTemperature{NAN};
+    float maxTemperature{NAN};
+    char summary[DESCRIPTION_LENGTH]{};
+    char iconCode[ICON_CODE_LENGTH]{};
+    char nightIconCode[ICON_CODE_LENGTH]{}; // dominant night condition; empty if unknown
+    int iconId{0};
+};
+
+struct WeatherSnapshot
+{
+    float outdoorTemperature{NAN};
+    char outdoorDescription[DESCRIPTION_LENGTH]{};
+    DailyForecast days[MAX_FORECAST_DAYS]; // only the configured number are filled
+    time_t updatedAt{}; // observation time, shifted to the location's local time
+    char currentIconCode[ICON_CODE_LENGTH]{};
+    int currentIconId{0};
+    time_t fetchedAt{}; // UTC epoch of the successful fetch; 0 if never fetched
+    // Coordinates it was fetched for, so a cache never shows another location.
+    float latitude{NAN};
+    float longitude{NAN};
+    ForecastTimeline timeline;
+};
@@ -0,0 +1,420 @@
+#include "wifiConnect.h"
+
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+
+#include "hal.h"
+
+namespace
+{
+constexpr uint32_t WIFI_CACHE_MAGIC = 0x57464943; // "WFIC"
+constexpr uint32_t DIRECTED_TIMEOUT_MS = 3000;
+constexpr uint32_t NETWORK_TIMEOUT_MS = 10000;
+// Routers commonly hand out 24 h leases; reuse a remembered one for half that.
+constexpr time_t LEASE_REUSE_SECONDS = 12 * 60 * 60;
+constexpr int8_t RSSI_UNKNOWN = -128;
+constexpr size_t SSID_LENGTH = 33;
+
+constexpr EventBits_t ASSOCIATED_BIT = 1U << 0;
+constexpr EventBits_t ADDRESS_BIT = 1U << 1;
+constexpr EventBits_t DROPPED_BIT = 1U << 2;
+constexpr EventBits_t LINK_BITS = ASSOCIATED_BIT | ADDRESS_BIT | DROPPED_BIT;
+
+struct SeenNetwork
+{
+    char ssid[SSID_LENGTH];
+    int8_t rssi;
+};
+
+struct WifiCache
+{
+    uint32_t magic;
+    // Last successful join.
+    char ssid[SSID_LENGTH];
+    uint8_t bssid[6];
+    int32_t channel;
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+    time_t leaseAt; // 0 when the address was static, not a DHCP lease
+    SeenNetwork seen[MAX_WIFI_NETWORKS];
+};
+
+static_assert(std::is_trivially_copyable<WifiCache>::value, "WifiCache is kept as raw bytes in RTC memory");
+
+// Remembered link for the next wake; a zero magic means a cold boot.
+RTC_DATA_ATTR WifiCache wifiCache;
+
+// Written by the Wi-Fi event task, read by the task that is joining.
+EventGroupHandle_t linkEvents = nullptr;
+std::atomic<uint32_t> associatedAtMs{0};
+std::atomic<uint8_t> disconnectReason{0};
+
+void onWifiEvent(arduino_event_id_t event, arduino_event_info_t info)
+{
+    switch (event)
+    {
+    case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+        associatedAtMs.store(millis());
+        xEventGroupSetBits(linkEvents, ASSOCIATED_BIT);
+        break;
+    case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+        xEventGroupSetBits(linkEvents, ADDRESS_BIT);
+        break;
+    case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+        // Our own disconnect() after an attempt; it must not end the next one.
+        if (info.wifi_sta_disconnected.reason == WIFI_REASON_ASSOC_LEAVE)
+        {
+            break;
+        }
+        disconnectReason.store(info.wifi_sta_disconnected.reason);
+        xEventGroupSetBits(linkEvents, DROPPED_BIT);
+        break;
+    default:
+        break;
+    }
+}
+
+void ensureLinkEvents()
+{
+    if (linkEvents == nullptr)
+    {
+        linkEvents = xEventGroupCreate();
+        WiFi.onEvent(onWifiEvent);
+    }
+}
+
+WifiFailure classifyDisconnect(uint8_t reason)
+{
+    switch (reason)
+    {
+    case WIFI_REASON_AUTH_FAIL:
+        return WifiFailure::AuthFailed;
+    case WIFI_REASON_NO_AP_FOUND:
+        return WifiFailure::NotFound;
+    default:
+        return WifiFailure::Dropped;
+    }
+}
+
+// WPA2 reports a wrong passphrase as a handshake that never completes, but so
+// does a weak signal. One such failure is retryable; see connectScanned().
+bool handshakeTimedOut(uint8_t reason)
+{
+    return reason == WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT || reason == WIFI_REASON_HANDSHAKE_TIMEOUT;
+}
+
+void ensureCache()
+{
+    if (wifiCache.magic != WIFI_CACHE_MAGIC)
+    {
+        memset(&wifiCache, 0, sizeof(wifiCache));
+        wifiCache.magic = WIFI_CACHE_MAGIC;
+        for (SeenNetwork &seen : wifiCache.seen)
+        {
+            seen.rssi = RSSI_UNKNOWN;
+        }
+    }
+}
+
+int8_t lastSeenRssi(const String &ssid)
+{
+    for (const SeenNetwork &seen : wifiCache.seen)
+    {
+        if (ssid == seen.ssid)
+        {
+            return seen.rssi;
+        }
+    }
+    return RSSI_UNKNOWN;
+}
+
+void rememberRssi(const String &ssid, int8_t rssi)
+{
+    SeenNetwork *slot = nullptr;
+    for (SeenNetwork &seen : wifiCache.seen)
+    {
+        if (ssid == seen.ssid)
+        {
+            slot = &seen;
+            break;
+        }
+        if (slot == nullptr && seen.ssid[0] == '\0')
+        {
+            slot = &seen;
+        }
+    }
+    if (slot == nullptr)
+    {
+        // Replace the weakest entry.
+        slot = &wifiCache.seen[0];
+        for (SeenNetwork &seen : wifiCache.seen)
+        {
+            if (seen.rssi < slot->rssi)
+            {
+                slot = &seen;
+            }
+        }
+    }
+    snprintf(slot->ssid, sizeof(slot->ssid), "%s", ssid.c_str());
+    slot->rssi = rssi;
+}
+
+void applyAddressing(const StaticIpConfig &staticIp, bool reuseLease)
+{
+    if (staticIp.enabled)
+    {
+        WiFi.config(staticIp.ip, staticIp.gateway, staticIp.subnet, staticIp.dns);
+    }
+    else if (reuseLease)
+    {
+        WiFi.config(IPAddress(wifiCache.ip), IPAddress(wifiCache.gateway), IPAddress(wifiCache.subnet),
+                    IPAddress(wifiCache.dns));
+    }
+    else
+    {
+        // All-zero settings switch the station back to DHCP.
+        WiFi.config(IPAddress(0U), IPAddress(0U), IPAddress(0U));
+    }
+}
+
+// One join attempt. The caller's task sleeps on the event group until the
+// driver hands out an address or gives up, so nothing wakes the CPU while
+// the radio associates.
+WifiFailure join(const WifiNetwork &network, int32_t channel, const uint8_t *bssid, uint32_t timeoutMs,
+                 WifiConnectReport &report)
+{
+    xEventGroupClearBits(linkEvents, LINK_BITS);
+    disconnectReason.store(0);
+    ++report.attempts;
+    const uint32_t start = millis();
+    WiFi.begin(network.ssid.c_str(), network.password.c_str(), channel, bssid, true);
+    const EventBits_t bits =
+        xEventGroupWaitBits(linkEvents, ADDRESS_BIT | DROPPED_BIT, pdFALSE, pdFALSE, pdMS_TO_TICKS(timeoutMs));
+    const uint32_t end = millis();
+
+    const bool associated = (bits & ASSOCIATED_BIT) != 0;
+    const uint32_t associatedAt = associated ? associatedAtMs.load() : end;
+    report.associateMs = associatedAt - start;
+    report.addressMs = end - associatedAt;
+    if ((bits & ADDRESS_BIT) != 0)
+    {
+        return WifiFailure::None;
+    }
+
+    WifiFailure failure = associated ? WifiFailure::NoAddress : WifiFailure::Timeout;
+    if ((bits & DROPPED_BIT) != 0)
+    {
+        report.reason = disconnectReason.load();
+        failure = classifyDisconnect(report.reason);
+    }
+    report.failure = std::max(report.failure, failure);
+    Serial.printf("[WiFi] %s: %s after %lu ms (reason %u)\n", network.ssid.c_str(), wifiFailureText(failure),
+                  (unsigned long)(end - start), (unsigned)report.reason);
+    WiFi.disconnect();
+    return failure;
+}
+
+void rememberConnection(const StaticIpConfig &staticIp)
+{
+    snprintf(wifiCache.ssid, sizeof(wifiCache.ssid), "%s", WiFi.SSID().c_str());
+    memcpy(wifiCache.bssid, WiFi.BSSID(), sizeof(wifiCache.bssid));
+    wifiCache.channel = WiFi.channel();
+    if (!staticIp.enabled && wifiCache.leaseAt == 0)
+    {
+        // A fresh DHCP lease (a reused one keeps its original time).
+        wifiCache.ip = WiFi.localIP();
+        wifiCache.gateway = WiFi.gatewayIP();
+        wifiCache.subnet = WiFi.subnetMask();
+        wifiCache.dns = WiFi.dnsIP(0);
+        wifiCache.leaseAt = halEpochNow();
+    }
+    rememberRssi(WiFi.SSID(), WiFi.RSSI());
+}
+
+// Straight to the remembered access point and channel: no scan, and no DHCP
+// while the remembered lease is fresh.
+bool connectDirected(const WifiNetwork *networks, size_t count, const StaticIpConfig &staticIp,
+                     bool *handshakeFailed, WifiConnectReport &report)
+{
+    if (wifiCache.ssid[0] == '\0' || wifiCache.channel <= 0)
+    {
+        return false;
+    }
+    size_t index = count;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (networks[i].ssid == wifiCache.ssid)
+        {
+            index = i;
+        }
+    }
+    if (index == count)
+    {
+        return false;
+    }
+
+    const time_t leaseAge = halEpochNow() - wifiCache.leaseAt;
+    const bool reuseLease = !staticIp.enabled && wifiCache.leaseAt != 0 && leaseAge >= 0 &&
+                            leaseAge < LEASE_REUSE_SECONDS;
+    if (!reuseLease)
+    {
+        wifiCache.leaseAt = 0;
+    }
+    report.reusedLease = reuseLease;
+    applyAddressing(staticIp, reuseLease);
+    const WifiFailure failure = join(networks[index], wifiCache.channel, wifiCache.bssid, DIRECTED_TIMEOUT_MS, report);
+    if (failure == WifiFailure::None)
+    {
+        return true;
+    }
+    handshakeFailed[index] = failure == WifiFailure::Dropped && handshakeTimedOut(disconnectReason.load());
+    report.reusedLease = false;
+    Serial.printf("[WiFi] Directed connect to %s (ch %d) failed.\n", wifiCache.ssid, wifiCache.channel);
+    wifiCache.channel = 0;
+    wifiCache.leaseAt = 0;
+    return false;
+}
+
+bool connectScanned(const WifiNetwork *networks, size_t count, const StaticIpConfig &staticIp,
+                    const bool *handshakeFailed, uint32_t deadlineMs, WifiConnectReport &report)
+{
+    struct Candidate
+    {
+        const WifiNetwork *network;
+        int8_t rssi;
+        bool visible;
+        int32_t channel;
+        uint8_t bssid[6];
+    };
+    Candidate candidates[MAX_WIFI_NETWORKS];
+    size_t candidateCount = 0;
+    for (size_t i = 0; i < std::min(count, MAX_WIFI_NETWORKS); ++i)
+    {
+        candidates[candidateCount++] = Candidate{&networks[i], lastSeenRssi(networks[i].ssid), false, 0, {}};
+    }
+
+    const uint32_t scanStart = millis();
+    const int16_t found = WiFi.scanNetworks();
+    report.scanMs = millis() - scanStart;
+    for (int16_t n = 0; n < found; ++n)
+    {
+        const String ssid = WiFi.SSID(n);
+        for (size_t i = 0; i < candidateCount; ++i)
+        {
+            Candidate &candidate = candidates[i];
+            const int8_t rssi = static_cast<int8_t>(WiFi.RSSI(n));
+            if (ssid == candidate.network->ssid && (!candidate.visible || rssi > candidate.rssi))
+            {
+                candidate.visible = true;
+                candidate.rssi = rssi;
+                candidate.channel = WiFi.channel(n);
+                memcpy(candidate.bssid, WiFi.BSSID(n), sizeof(candidate.bssid));
+            }
+        }
+    }
+    WiFi.scanDelete();
+    for (size_t i = 0; i < candidateCount; ++i)
+    {
+        if (candidates[i].visible)
+        {
+            rememberRssi(candidates[i].network->ssid, candidates[i].rssi);
+        }
+    }
+    // Visible networks first, strongest first; unseen ones by last-seen RSSI.
+    std::stable_sort(candidates, candidates + candidateCount, [](const Candidate &a, const Candidate &b) {
+        if (a.visible != b.visible)
+        {
+            return a.visible;
+        }
+        return a.rssi > b.rssi;
+    });
+
+    applyAddressing(staticIp, false);
+    wifiCache.leaseAt = 0;
+    for (size_t i = 0; i < candidateCount; ++i)
+    {
+        const Candidate &candidate = candidates[i];
+        const int32_t remaining = static_cast<int32_t>(deadlineMs - millis());
+        if (remaining <= 0)
+        {
+            break;
+        }
+        Serial.printf("[WiFi] Trying %s (%s, RSSI %d)\n", candidate.network->ssid.c_str(),
+                      candidate.visible ? "seen" : "not seen", candidate.rssi);
+        const WifiFailure failure =
+            join(*candidate.network, candidate.visible ? candidate.channel : 0,
+                 candidate.visible ? candidate.bssid : nullptr,
+                 std::min<uint32_t>(NETWORK_TIMEOUT_MS, static_cast<uint32_t>(remaining)), report);
+        if (failure == WifiFailure::None)
+        {
+            return true;
+        }
+        // The directed join timed out in the handshake too: a weak signal would
+        // have had a second chance by now, so take it as a wrong password.
+        if (failure == WifiFailure::Dropped && handshakeTimedOut(disconnectReason.load()) &&
+            handshakeFailed[candidate.network - networks])
+        {
+            Serial.printf("[WiFi] %s: handshake failed twice; treating it as a wrong password.\n",
+                          candidate.network->ssid.c_str());
+            report.failure = WifiFailure::AuthFailed;
+        }
+    }
+    return false;
+}
+} // namespace
+
+const char *wifiFailureText(WifiFailure failure)
+{
+    switch (failure)
+    {
+    case WifiFailure::None:
+        return "connected";
+    case WifiFailure::NotFound:
+        return "network not found";
+    case WifiFailure::Dropped:
+        return "connection refused";
+    case WifiFailure::Timeout:
+        return "timed out";
+    case WifiFailure::NoAddress:
+        return "no IP address";
+    case WifiFailure::AuthFailed:
+        return "wrong password";
+    }
+    return "unknown";
+}
+
+bool connectWifi(const WifiNetwork *networks, size_t count, const StaticIpConfig &staticIp, uint32_t timeoutMs,
+                 WifiConnectReport &report)
+{
+    ensureCache();
+    ensureLinkEvents();
+    report = WifiConnectReport();
+    const uint32_t start = millis();
+    WiFi.mode(WIFI_STA);
+    // Modem sleep stays on while joining. Reconnects are left to the attempts
+    // here, so a refused join is not quietly retried behind their back.
+    WiFi.setAutoReconnect(false);
+
+    bool handshakeFailed[MAX_WIFI_NETWORKS]{};
+    report.directed = connectDirected(networks, count, staticIp, handshakeFailed, report);
+    const bool joined =
+        report.directed || connectScanned(networks, count, staticIp, handshakeFailed, start + timeoutMs, report);
+    report.totalMs = millis() - start;
+    if (!joined)
+    {
+        return false;
+    }
+    report.failure = WifiFailure::None;
+    rememberConnection(staticIp);
+    Serial.printf("[WiFi] Joined %s on ch %d in %lu ms: scan %lu, associate %lu, address %lu (%s, %s)\n",
+                  wifiCache.ssid, wifiCache.channel, (unsigned long)report.totalMs, (unsigned long)report.scanMs,
+                  (unsigned long)report.associateMs, (unsigned long)report.addressMs,
+                  report.directed ? "directed" : "after scan",
+                  staticIp.enabled ? "static IP" : report.reusedLease ? "cached lease" : "DHCP");
+    return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <WiFi.h>
+
+struct WifiNetwork
+{
+    String ssid;
+    String password;
+};
+
+// Optional fixed address from weather.json; skips DHCP entirely when enabled.
+struct StaticIpConfig
+{
+    bool enabled{false};
+    IPAddress ip;
+    IPAddress gateway;
+    IPAddress subnet;
+    IPAddress dns;
+};
+
+constexpr size_t MAX_WIFI_NETWORKS = 4;
+
+// Why a join failed, ordered by how much it tells: connectWifi() reports the
+// highest one seen over all its attempts.
+enum class WifiFailure : uint8_t
+{
+    None,
+    NotFound,   // the access point did not answer
+    Dropped,    // the driver gave up for another reason
+    Timeout,    // no association in time
+    NoAddress,  // associated, but no DHCP lease in time
+    AuthFailed, // the password was refused
+};
+
+const char *wifiFailureText(WifiFailure failure);
+
+// What the last connectWifi() call did. The per-phase times are those of the
+// last attempt, which is the successful one if there was one.
+struct WifiConnectReport
+{
+    WifiFailure failure{WifiFailure::None};
+    bool directed{false};     // joined the remembered access point without a scan
+    bool reusedLease{false};  // ... and reused its DHCP lease
+    uint8_t attempts{0};
+    uint8_t reason{0};        // driver's disconnect reason for the last refused attempt
+    uint32_t scanMs{0};
+    uint32_t associateMs{0};  // WiFi.begin() to association
+    uint32_t addressMs{0};    // association to an IP address
+    uint32_t totalMs{0};
+};
+
+// Joins one of `networks` within `timeoutMs`.
+//
+// The BSSID, channel and DHCP lease of the last successful join are kept in
+// RTC memory. The first attempt goes straight to that access point on that
+// channel, reusing the lease as a static address while it is fresh, so
+// association takes a few hundred ms with no scan and no DHCP exchange. If
+// that fails, a full scan ranks the configured networks by RSSI (networks the
+// scan missed, e.g. hidden ones, are tried last by their last-seen RSSI) and
+// each is joined in turn with DHCP or the static settings.
+//
+// Each attempt blocks on the driver's station events rather than polling
+// status(), and ends as soon as the driver reports the outcome: a refused
+// password or a missing access point fails in about a second instead of
+// running out the timeout. A handshake timeout counts as a wrong password only
+// if the directed join and the join after the scan both end in one.
+bool connectWifi(const WifiNetwork *networks, size_t count, const StaticIpConfig &staticIp, uint32_t timeoutMs,
+                 WifiConnectReport &report);
@@ -0,0 +1,279 @@
+// Host tool: bakes the SD font into the glyph atlas the firmware reads at
+// boot (see src/glyphAtlasFormat.h), so the device never runs FreeType for
+// the characters and sizes it actually draws.
+//
+//   g++ -std=c++17 -O2 -I../../src glyphbake.cpp $(pkg-config --cflags --libs freetype2) -o glyphbake
+//   ./glyphbake Roboto-Regular.ttf glyphs.bin
+//
+// Copy glyphs.bin to /font/glyphs.bin on the SD card.
+//
+// Options:
+//   --sizes 26,36,48,84   pixel sizes; must match mapLegacySizeToPx() in the firmware
+//   --extra "…"           characters to bake besides ASCII and Latin-1 (UTF-8)
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "glyphAtlasFormat.h"
+#include "utf8.h"
+
+namespace
+{
+// The pixel sizes setTextSizeCompat() resolves to once a smooth font is active.
+const std::vector<uint16_t> DEFAULT_SIZES = {26, 36, 48, 84};
+// Beyond ASCII and Latin-1 (OpenWeather descriptions in western languages),
+// the firmware's own strings use only the em dash.
+const char DEFAULT_EXTRA[] = "\xE2\x80\x94";
+
+// Same polynomial and conditioning as crc32Update() on the device.
+uint32_t crc32(const uint8_t *data, size_t length)
+{
+    uint32_t crc = ~0U;
+    for (size_t i = 0; i < length; ++i)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+struct BakedSize
+{
+    GlyphAtlasSize info{};
+    std::vector<GlyphAtlasGlyph> glyphs;
+    std::vector<GlyphAtlasKern> kerns;
+    std::vector<uint8_t> bitmaps;
+};
+
+int roundedPixels(FT_Pos value)
+{
+    return static_cast<int>((value + 32) >> 6);
+}
+
+bool bakeSize(FT_Face face, uint16_t pixelSize, const std::vector<uint32_t> &codepoints, BakedSize &out)
+{
+    if (FT_Set_Pixel_Sizes(face, 0, pixelSize) != 0)
+    {
+        fprintf(stderr, "cannot set size %u\n", pixelSize);
+        return false;
+    }
+    out.info.pixelSize = pixelSize;
+    out.info.ascent = static_cast<int16_t>((face->size->metrics.ascender + 63) >> 6);
+    out.info.descent = static_cast<int16_t>((-face->size->metrics.descender + 63) >> 6);
+
+    std::vector<FT_UInt> indices;
+    for (uint32_t codepoint : codepoints)
+    {
+        const FT_UInt index = FT_Get_Char_Index(face, codepoint);
+        if (index == 0 || FT_Load_Glyph(face, index, FT_LOAD_RENDER) != 0)
+        {
+            continue; // not in the font; the device draws '?' or falls back to FreeType
+        }
+        const FT_GlyphSlot slot = face->glyph;
+        const FT_Bitmap &bitmap = slot->bitmap;
+        GlyphAtlasGlyph glyph{};
+        glyph.codepoint = codepoint;
+        glyph.width = static_cast<uint16_t>(bitmap.width);
+        glyph.height = static_cast<uint16_t>(bitmap.rows);
+        glyph.left = static_cast<int16_t>(slot->bitmap_left);
+        glyph.top = static_cast<int16_t>(slot->bitmap_top);
+        glyph.advance = static_cast<int16_t>(roundedPixels(slot->advance.x));
+        glyph.bitmapOffset = static_cast<uint32_t>(out.bitmaps.size());
+
+        // 8-bit coverage down to the panel's 16 levels, two pixels per byte.
+        const size_t rowBytes = (bitmap.width + 1) / 2;
+        for (unsigned row = 0; row < bitmap.rows; ++row)
+        {
+            const uint8_t *source = bitmap.buffer + row * bitmap.pitch;
+            std::vector<uint8_t> packed(rowBytes, 0);
+            for (unsigned column = 0; column < bitmap.width; ++column)
+            {
+                const uint8_t level = static_cast<uint8_t>((source[column] * 15 + 127) / 255);
+                packed[column / 2] |= (column & 1) ? level : level << 4;
+            }
+            out.bitmaps.insert(out.bitmaps.end(), packed.begin(), packed.end());
+        }
+        out.glyphs.push_back(glyph);
+        indices.push_back(index);
+    }
+
+    if (FT_HAS_KERNING(face))
+    {
+        for (size_t l = 0; l < out.glyphs.size(); ++l)
+        {
+            for (size_t r = 0; r < out.glyphs.size(); ++r)
+            {
+                FT_Vector delta{};
+                if (FT_Get_Kerning(face, indices[l], indices[r], FT_KERNING_DEFAULT, &delta) != 0)
+                {
+                    continue;
+                }
+                const int adjust = roundedPixels(delta.x);
+                if (adjust != 0 && out.glyphs[l].codepoint <= 0xFFFF && out.glyphs[r].codepoint <= 0xFFFF)
+                {
+                    GlyphAtlasKern kern{};
+                    kern.left = static_cast<uint16_t>(out.glyphs[l].codepoint);
+                    kern.right = static_cast<uint16_t>(out.glyphs[r].codepoint);
+                    kern.adjust = static_cast<int16_t>(adjust);
+                    out.kerns.push_back(kern);
+                }
+            }
+        }
+    }
+    out.info.glyphCount = static_cast<uint16_t>(out.glyphs.size());
+    out.info.kernCount = static_cast<uint16_t>(out.kerns.size());
+    out.info.bitmapBytes = static_cast<uint32_t>(out.bitmaps.size());
+    out.info.bitmapCrc = crc32(out.bitmaps.data(), out.bitmaps.size());
+    return true;
+}
+
+template <typename T>
+void append(std::vector<uint8_t> &bytes, const T *items, size_t count)
+{
+    const uint8_t *raw = reinterpret_cast<const uint8_t *>(items);
+    bytes.insert(bytes.end(), raw, raw + count * sizeof(T));
+}
+
+std::vector<uint16_t> parseSizes(const char *list)
+{
+    std::vector<uint16_t> sizes;
+    for (const char *p = list; *p != '\0';)
+    {
+        char *end = nullptr;
+        const long value = strtol(p, &end, 10);
+        if (end == p || value <= 0 || value > 255)
+        {
+            return {};
+        }
+        sizes.push_back(static_cast<uint16_t>(value));
+        p = *end == ',' ? end + 1 : end;
+    }
+    return sizes;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::vector<uint16_t> sizes = DEFAULT_SIZES;
+    std::string extra = DEFAULT_EXTRA;
+    std::vector<const char *> positional;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc)
+        {
+            sizes = parseSizes(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--extra") == 0 && i + 1 < argc)
+        {
+            extra = argv[++i];
+        }
+        else
+        {
+            positional.push_back(argv[i]);
+        }
+    }
+    if (positional.size() != 2 || sizes.empty() || sizes.size() > 6)
+    {
+        fprintf(stderr, "usage: glyphbake [--sizes 26,36,48,84] [--extra chars] font.ttf glyphs.bin\n");
+        return 2;
+    }
+
+    std::vector<uint32_t> codepoints;
+    for (uint32_t cp = 0x20; cp <= 0x7E; ++cp)
+    {
+        codepoints.push_back(cp);
+    }
+    for (uint32_t cp = 0xA0; cp <= 0xFF; ++cp)
+    {
+        codepoints.push_back(cp);
+    }
+    for (size_t i = 0; i < extra.size();)
+    {
+        uint32_t cp = 0;
+        i += decodeUtf8(extra.data() + i, extra.size() - i, cp);
+        codepoints.push_back(cp);
+    }
+    std::sort(codepoints.begin(), codepoints.end());
+    codepoints.erase(std::unique(codepoints.begin(), codepoints.end()), codepoints.end());
+
+    FT_Library library;
+    FT_Face face;
+    if (FT_Init_FreeType(&library) != 0 || FT_New_Face(library, positional[0], 0, &face) != 0)
+    {
+        fprintf(stderr, "cannot open %s\n", positional[0]);
+        return 1;
+    }
+
+    std::vector<BakedSize> baked(sizes.size());
+    for (size_t i = 0; i < sizes.size(); ++i)
+    {
+        if (!bakeSize(face, sizes[i], codepoints, baked[i]))
+        {
+            return 1;
+        }
+    }
+
+    // Lay out the tables first, then every size's bitmap blob.
+    uint32_t offset = sizeof(GlyphAtlasHeader) + sizes.size() * sizeof(GlyphAtlasSize);
+    for (BakedSize &size : baked)
+    {
+        size.info.tablesOffset = offset;
+        offset += size.glyphs.size() * sizeof(GlyphAtlasGlyph) + size.kerns.size() * sizeof(GlyphAtlasKern);
+    }
+    for (BakedSize &size : baked)
+    {
+        size.info.bitmapOffset = offset;
+        offset += size.info.bitmapBytes;
+    }
+
+    std::vector<uint8_t> tables;
+    for (const BakedSize &size : baked)
+    {
+        append(tables, &size.info, 1);
+    }
+    for (const BakedSize &size : baked)
+    {
+        append(tables, size.glyphs.data(), size.glyphs.size());
+        append(tables, size.kerns.data(), size.kerns.size());
+    }
+    GlyphAtlasHeader header{};
+    header.magic = GLYPH_ATLAS_MAGIC;
+    header.version = GLYPH_ATLAS_VERSION;
+    header.sizeCount = static_cast<uint16_t>(sizes.size());
+    header.tablesBytes = static_cast<uint32_t>(tables.size());
+    header.tablesCrc = crc32(tables.data(), tables.size());
+
+    FILE *out = fopen(positional[1], "wb");
+    if (out == nullptr)
+    {
+        fprintf(stderr, "cannot write %s\n", positional[1]);
+        return 1;
+    }
+    fwrite(&header, sizeof(header), 1, out);
+    fwrite(tables.data(), 1, tables.size(), out);
+    for (const BakedSize &size : baked)
+    {
+        fwrite(size.bitmaps.data(), 1, size.bitmaps.size(), out);
+    }
+    fclose(out);
+
+    for (const BakedSize &size : baked)
+    {
+        printf("size %3u: %3u glyphs, %4u kerning pairs, %6u bytes of bitmaps\n", size.info.pixelSize,
+               size.info.glyphCount, size.info.kernCount, size.info.bitmapBytes);
+    }
+    printf("wrote %u bytes to %s\n", offset, positional[1]);
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+    return 0;
+}
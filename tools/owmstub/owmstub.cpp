@@ -0,0 +1,415 @@
+// Host tool: a local stand-in for the OpenWeatherMap API. It answers the
+// requests the firmware makes (/data/2.5/weather, /data/2.5/forecast, One Call
+// 2.5/3.0 and /img/wn icons) from a corpus directory, and can make them slow,
+// cut them short or fail them, so fetch and recovery paths can be exercised
+// without a key, a quota or a real outage.
+//
+//   g++ -std=c++17 -O2 -pthread owmstub.cpp -o owmstub
+//   ./owmstub corpus/typical
+//
+// Then set "baseUrl" and "iconBaseUrl" under "openweathermap" in weather.json
+// to http://<this machine>:8080.
+//
+// A request is served from the file named after the last segment of its path,
+// tried as-is and with ".json" appended, so ".../forecast?lat=..." reads
+// forecast.json and ".../img/wn/10d@2x.png" reads 10d@2x.png. This is the same
+// mapping the native build uses for M5PW_HTTP_ROOT, so a corpus directory
+// works for both. Files missing from the scenario are looked up in --icons
+// (default: the "icons" directory next to it), then answer 404.
+//
+// Options:
+//   --port 8080          port to listen on (all interfaces)
+//   --icons DIR          second directory to look in, for the shared icon set
+//   --latency MS         wait before the status line of every response
+//   --jitter MS          add a random 0..MS to the latency
+//   --rate BYTES         send the body at most this many bytes per second
+//   --status CODE        answer with CODE and an OpenWeatherMap-style error body
+//   --truncate PERCENT   send only the first PERCENT of the body, then close;
+//                        Content-Length still announces the whole body
+//   --match TEXT         apply --status/--truncate only to paths containing TEXT,
+//                        e.g. "onecall" to push the firmware onto /forecast
+//   --every N            apply them only to every Nth matching request
+//   --rebase EPOCH       the corpus is anchored at EPOCH: move every "dt",
+//                        "sunrise" and "sunset" forward by whole 3-hour steps
+//                        so the data looks current
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+struct Options
+{
+    int port{8080};
+    std::string corpus;
+    std::string icons;
+    int latencyMs{0};
+    int jitterMs{0};
+    long rateBytesPerSecond{0};
+    int status{0};
+    int truncatePercent{100};
+    std::string match;
+    int every{1};
+    long rebaseEpoch{0};
+};
+
+Options options;
+std::atomic<unsigned> matchingRequests{0};
+
+// Whole 3-hour steps keep /forecast entries on their usual slot boundaries.
+constexpr long REBASE_STEP_SECONDS = 3L * 60L * 60L;
+
+const char *reasonPhrase(int status)
+{
+    switch (status)
+    {
+    case 200: return "OK";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 429: return "Too Many Requests";
+    case 500: return "Internal Server Error";
+    case 502: return "Bad Gateway";
+    case 503: return "Service Unavailable";
+    case 504: return "Gateway Timeout";
+    default: return "Error";
+    }
+}
+
+// The shape OpenWeatherMap uses for its own errors, e.g. for a bad key.
+std::string errorBody(int status)
+{
+    if (status == 401)
+    {
+        return "{\"cod\":401,\"message\":\"Invalid API key. Please see https://openweathermap.org/faq#error401 for more info.\"}";
+    }
+    if (status == 429)
+    {
+        return "{\"cod\":429,\"message\":\"Your account is temporary blocked due to exceeding of requests limitation of your subscription type.\"}";
+    }
+    return std::string("{\"cod\":\"") + std::to_string(status) + "\",\"message\":\"" + reasonPhrase(status) + "\"}";
+}
+
+bool readFile(const std::string &path, std::string &contents)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+// "/data/2.5/forecast?lat=1" -> "forecast"; never lets a segment climb out of the corpus.
+std::string lastSegment(const std::string &target)
+{
+    const std::string path = target.substr(0, target.find('?'));
+    const std::string segment = path.substr(path.rfind('/') + 1);
+    return segment == "." || segment == ".." ? std::string() : segment;
+}
+
+bool loadResponse(const std::string &segment, std::string &body)
+{
+    if (segment.empty())
+    {
+        return false;
+    }
+    for (const std::string &dir : {options.corpus, options.icons})
+    {
+        if (readFile(dir + "/" + segment, body) || readFile(dir + "/" + segment + ".json", body))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Adds `shift` to the integer after each "dt", "sunrise" and "sunset" key. A
+// plain scan is enough: the corpus is OpenWeatherMap output, not arbitrary JSON.
+std::string rebaseTimestamps(const std::string &json, long shift)
+{
+    std::string out;
+    out.reserve(json.size());
+    size_t i = 0;
+    while (i < json.size())
+    {
+        bool matched = false;
+        for (const char *key : {"\"dt\":", "\"sunrise\":", "\"sunset\":"})
+        {
+            const size_t keyLength = strlen(key);
+            if (json.compare(i, keyLength, key) != 0)
+            {
+                continue;
+            }
+            size_t end = i + keyLength;
+            while (end < json.size() && json[end] == ' ')
+            {
+                ++end;
+            }
+            size_t digits = end;
+            while (digits < json.size() && isdigit(static_cast<unsigned char>(json[digits])))
+            {
+                ++digits;
+            }
+            if (digits == end)
+            {
+                break;
+            }
+            out.append(json, i, end - i);
+            out += std::to_string(std::stol(json.substr(end, digits - end)) + shift);
+            i = digits;
+            matched = true;
+            break;
+        }
+        if (!matched)
+        {
+            out += json[i++];
+        }
+    }
+    return out;
+}
+
+bool sendAll(int fd, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        const ssize_t sent = send(fd, data, length, MSG_NOSIGNAL);
+        if (sent <= 0)
+        {
+            return false;
+        }
+        data += sent;
+        length -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool sendBody(int fd, const std::string &body, size_t length)
+{
+    if (options.rateBytesPerSecond <= 0)
+    {
+        return sendAll(fd, body.data(), length);
+    }
+    // 20 slices a second: smooth enough for transfer timings, cheap to run.
+    const size_t slice = std::max<size_t>(1, static_cast<size_t>(options.rateBytesPerSecond / 20));
+    for (size_t offset = 0; offset < length; offset += slice)
+    {
+        if (!sendAll(fd, body.data() + offset, std::min(slice, length - offset)))
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return true;
+}
+
+std::string httpDate()
+{
+    char date[40];
+    const time_t now = time(nullptr);
+    struct tm utc;
+    gmtime_r(&now, &utc);
+    strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S GMT", &utc);
+    return date;
+}
+
+// Reads one request head. Returns false when the client closed the connection.
+bool readRequest(int fd, std::string &pending, std::string &method, std::string &target, bool &keepAlive)
+{
+    size_t headEnd;
+    while ((headEnd = pending.find("\r\n\r\n")) == std::string::npos)
+    {
+        char buffer[1024];
+        const ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0 || pending.size() > 16384)
+        {
+            return false;
+        }
+        pending.append(buffer, static_cast<size_t>(received));
+    }
+    std::string head = pending.substr(0, headEnd);
+    pending.erase(0, headEnd + 4);
+
+    std::istringstream lines(head);
+    std::string version;
+    lines >> method >> target >> version;
+    keepAlive = version == "HTTP/1.1";
+    for (char &c : head)
+    {
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+    if (head.find("\nconnection: close") != std::string::npos)
+    {
+        keepAlive = false;
+    }
+    else if (head.find("\nconnection: keep-alive") != std::string::npos)
+    {
+        keepAlive = true;
+    }
+    return true;
+}
+
+// Returns false once the connection should be closed.
+bool serveOne(int fd, const std::string &method, const std::string &target, bool keepAlive)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const std::string segment = lastSegment(target);
+
+    int status = 200;
+    std::string body;
+    if (method != "GET")
+    {
+        status = 405;
+        body = errorBody(status);
+    }
+    else if (!loadResponse(segment, body))
+    {
+        status = 404;
+        body = errorBody(status);
+    }
+    const bool json = segment.size() < 4 || segment.compare(segment.size() - 4, 4, ".png") != 0;
+    if (status == 200 && json && options.rebaseEpoch > 0)
+    {
+        const long shift = (static_cast<long>(time(nullptr)) - options.rebaseEpoch) / REBASE_STEP_SECONDS * REBASE_STEP_SECONDS;
+        body = rebaseTimestamps(body, shift);
+    }
+
+    bool faulted = false;
+    if ((options.status != 0 || options.truncatePercent < 100) &&
+        (options.match.empty() || target.find(options.match) != std::string::npos))
+    {
+        faulted = matchingRequests.fetch_add(1) % static_cast<unsigned>(options.every) == 0;
+    }
+    if (faulted && options.status != 0)
+    {
+        status = options.status;
+        body = errorBody(status);
+    }
+    const bool truncated = faulted && status == 200 && options.truncatePercent < 100;
+    const size_t sendLength = truncated ? body.size() * static_cast<size_t>(options.truncatePercent) / 100 : body.size();
+
+    int latencyMs = options.latencyMs;
+    if (options.jitterMs > 0)
+    {
+        thread_local std::mt19937 random(std::random_device{}());
+        latencyMs += static_cast<int>(random() % static_cast<unsigned>(options.jitterMs + 1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(latencyMs));
+
+    keepAlive = keepAlive && !truncated;
+    std::string head = "HTTP/1.1 " + std::to_string(status) + " " + reasonPhrase(status) + "\r\n";
+    head += "Server: owmstub\r\n";
+    head += "Date: " + httpDate() + "\r\n";
+    head += std::string("Content-Type: ") + (json ? "application/json; charset=utf-8" : "image/png") + "\r\n";
+    head += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    head += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    const bool sent = sendAll(fd, head.data(), head.size()) && sendBody(fd, body, sendLength);
+
+    const long elapsedMs = static_cast<long>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+    printf("%s %s -> %d, %zu/%zu bytes, %ld ms%s\n", method.c_str(), target.c_str(), status, sendLength,
+           body.size(), elapsedMs, truncated ? " (truncated)" : "");
+    fflush(stdout);
+    return sent && keepAlive;
+}
+
+void serveConnection(int fd)
+{
+    std::string pending;
+    std::string method;
+    std::string target;
+    bool keepAlive = false;
+    while (readRequest(fd, pending, method, target, keepAlive) && serveOne(fd, method, target, keepAlive))
+    {
+    }
+    close(fd);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const char *positional = nullptr;
+    bool usage = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--port") == 0 && hasValue) options.port = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--icons") == 0 && hasValue) options.icons = argv[++i];
+        else if (strcmp(argv[i], "--latency") == 0 && hasValue) options.latencyMs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--jitter") == 0 && hasValue) options.jitterMs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rate") == 0 && hasValue) options.rateBytesPerSecond = atol(argv[++i]);
+        else if (strcmp(argv[i], "--status") == 0 && hasValue) options.status = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--truncate") == 0 && hasValue) options.truncatePercent = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--match") == 0 && hasValue) options.match = argv[++i];
+        else if (strcmp(argv[i], "--every") == 0 && hasValue) options.every = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rebase") == 0 && hasValue) options.rebaseEpoch = atol(argv[++i]);
+        else if (positional == nullptr && argv[i][0] != '-') positional = argv[i];
+        else usage = true;
+    }
+    if (usage || positional == nullptr || options.every < 1 || options.truncatePercent < 0 || options.truncatePercent > 100 ||
+        options.latencyMs < 0 || options.jitterMs < 0)
+    {
+        fprintf(stderr, "usage: owmstub [--port 8080] [--icons dir] [--latency ms] [--jitter ms] [--rate bytes/s]\n"
+                        "               [--status code] [--truncate percent] [--match text] [--every n]\n"
+                        "               [--rebase epoch] corpus/scenario\n");
+        return 2;
+    }
+    options.corpus = positional;
+    while (options.corpus.size() > 1 && options.corpus.back() == '/')
+    {
+        options.corpus.pop_back();
+    }
+    if (options.icons.empty())
+    {
+        const size_t slash = options.corpus.rfind('/');
+        options.icons = (slash == std::string::npos ? std::string(".") : options.corpus.substr(0, slash)) + "/icons";
+    }
+
+    const int listener = socket(AF_INET, SOCK_STREAM, 0);
+    const int yes = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<uint16_t>(options.port));
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(listener, 8) != 0)
+    {
+        fprintf(stderr, "cannot listen on port %d: %s\n", options.port, strerror(errno));
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    printf("Serving %s (icons from %s) on port %d\n", options.corpus.c_str(), options.icons.c_str(), options.port);
+    fflush(stdout);
+
+    for (;;)
+    {
+        const int fd = accept(listener, nullptr, nullptr);
+        if (fd >= 0)
+        {
+            std::thread(serveConnection, fd).detach();
+        }
+    }
+}